@@ -9863,9 +9863,9 @@ const char* getNamedResource (const char* resourceNameUTF8, int& numBytes)
         case 0xb3e40b64:  numBytes = 317; return Noise_png;
         case 0x9d3ca20d:  numBytes = 70; return Arpeggiators_json;
         case 0xaf771725:  numBytes = 2753; return ColourSchemes_json;
-        case 0x932a5b4b:  numBytes = 12761; return HotkeySchemes_json;
+        case 0x932a5b4b:  numBytes = 12969; return HotkeySchemes_json;
         case 0x67f906de:  numBytes = 3563; return Scales_json;
-        case 0xe3299f05:  numBytes = 271571; return Translations_json;
+        case 0xe3299f05:  numBytes = 271823; return Translations_json;
         default: break;
     }
 
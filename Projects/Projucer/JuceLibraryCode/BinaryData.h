@@ -279,13 +279,13 @@ namespace BinaryData
     const int            ColourSchemes_jsonSize = 2753;
 
     extern const char*   HotkeySchemes_json;
-    const int            HotkeySchemes_jsonSize = 12761;
+    const int            HotkeySchemes_jsonSize = 12969;
 
     extern const char*   Scales_json;
     const int            Scales_jsonSize = 3563;
 
     extern const char*   Translations_json;
-    const int            Translations_jsonSize = 271571;
+    const int            Translations_jsonSize = 271823;
 
     // Number of elements in the namedResourceList and originalFileNames arrays.
     const int namedResourceListSize = 93;
@@ -45,6 +45,8 @@
 #include "Workspace.h"
 #include "RootTreeItem.h"
 #include "SerializablePluginDescription.h"
+#include "BatchRenderer.h"
+#include "StartupGraph.h"
 
 //===----------------------------------------------------------------------===//
 // Static
@@ -243,19 +245,13 @@ void App::initialise(const String &commandLine)
 {
     this->runMode = this->detectRunMode(commandLine);
 
-    if (this->runMode == App::NORMAL)
+    if (this->runMode == App::NORMAL || this->runMode == App::BATCH_RENDER)
     {
         Desktop::getInstance().setOrientationsEnabled(Desktop::rotatedClockwise + Desktop::rotatedAntiClockwise);
         
         Logger::setCurrentLogger(&this->logger);
         Logger::writeToLog("Helio v" + App::getAppReadableVersion());
 
-        this->config = new class Config();
-
-        this->theme = new HelioTheme();
-        this->theme->initResources();
-        LookAndFeel::setDefaultLookAndFeel(this->theme);
-    
         // TODO: get rid of singletons someday
         using namespace Serialization;
         this->resourceManagers.set(Resources::translations, &TranslationsManager::getInstance());
@@ -265,21 +261,69 @@ void App::initialise(const String &commandLine)
         this->resourceManagers.set(Resources::scales, &ScalesManager::getInstance());
         this->resourceManagers.set(Resources::scripts, &ScriptsManager::getInstance());
 
+        // Everything depends on config, and the main window depends on everything;
+        // resources parsing and fonts lookup in between are done in parallel,
+        // while the message thread is busy creating services
+        StartupGraph startup;
+        StringArray windowDependencies("LookAndFeel", "Services");
+
+        startup.addTask("Config", StartupGraph::MessageThread, {}, [this]()
+        {
+            this->config = new class Config();
+            this->theme = new HelioTheme();
+        });
+
+        startup.addTask("Theme", StartupGraph::AnyThread, { "Config" }, [this]()
+        {
+            this->theme->initResources();
+        });
+
+        startup.addTask("LookAndFeel", StartupGraph::MessageThread, { "Theme" }, [this]()
+        {
+            LookAndFeel::setDefaultLookAndFeel(this->theme);
+        });
+
         ResourceManagers::Iterator i(this->resourceManagers);
         while (i.next())
         {
-            i.getValue()->initialise();
+            auto *manager = i.getValue();
+            const String taskName = i.getKey().toString();
+            windowDependencies.add(taskName);
+            startup.addTask(taskName, StartupGraph::AnyThread, { "Config" }, [manager]()
+            {
+                manager->initialise();
+            });
         }
 
         // Prepare backend APIs communication services
-        this->sessionService = new SessionService();
-        this->updatesService = new UpdatesService();
+        startup.addTask("Services", StartupGraph::MessageThread, { "Config" }, [this]()
+        {
+            if (this->runMode == App::NORMAL)
+            {
+                this->sessionService = new SessionService();
+                this->updatesService = new UpdatesService();
+            }
+        });
+
+        startup.addTask("Window", StartupGraph::MessageThread, windowDependencies, [this]()
+        {
+            if (this->runMode == App::NORMAL)
+            {
+                this->workspace = new class Workspace();
+                this->window = new MainWindow();
+                TranslationsManager::getInstance().addChangeListener(this);
+            }
+        });
 
-        this->workspace = new class Workspace();
-        this->window = new MainWindow();
+        startup.run();
+
+        // Renders the projects with no main window and quits
+        if (this->runMode == App::BATCH_RENDER)
+        {
+            this->startBatchRender(commandLine);
+            return;
+        }
 
-        TranslationsManager::getInstance().addChangeListener(this);
-        
         // Desktop versions will be initialised by InitScreen component.
 #if HELIO_MOBILE
         this->theme->updateBackgroundRenders();
@@ -296,12 +340,13 @@ void App::initialise(const String &commandLine)
 
 void App::shutdown()
 {
-    if (this->runMode == App::NORMAL)
+    if (this->runMode == App::NORMAL || this->runMode == App::BATCH_RENDER)
     {
         TranslationsManager::getInstance().removeChangeListener(this);
 
         Logger::writeToLog("App::shutdown");
 
+        this->batchRenderer = nullptr;
         this->window = nullptr;
         this->workspace = nullptr;
 
@@ -339,6 +384,10 @@ const String App::getApplicationName()
     {
         return "Helio Plugin Check";
     }
+    else if (this->runMode == App::BATCH_RENDER)
+    {
+        return "Helio Batch Render";
+    }
 
     return "Helio";
 }
@@ -390,6 +439,9 @@ void App::suspended()
     {
         this->workspace->stopPlaybackForAllProjects();
         this->workspace->getAudioCore().mute();
+        // mobile platforms tend to kill the suspended apps that use much memory,
+        // so everything but the active project is released here
+        this->workspace->unloadInactiveProjects(1);
         this->workspace->autosave();
     }
     
@@ -447,6 +499,11 @@ String App::getMacAddressList()
 
 App::RunMode App::detectRunMode(const String &commandLine)
 {
+    if (BatchRenderer::isRenderCommandLine(StringArray::fromTokens(commandLine, true)))
+    {
+        return App::BATCH_RENDER;
+    }
+
     if (commandLine.isNotEmpty() &&
         DocumentHelpers::getTempSlot(commandLine).existsAsFile())
     {
@@ -506,6 +563,30 @@ void App::checkPlugin(const String &markerFile)
     }
 }
 
+void App::startBatchRender(const String &commandLine)
+{
+#if JUCE_MAC
+    Process::setDockIconVisible(false);
+#endif
+
+    this->workspace = new class Workspace();
+    this->workspace->initHeadless();
+
+    this->batchRenderer = new BatchRenderer();
+    const bool hasStarted = this->batchRenderer->start(StringArray::fromTokens(commandLine, true),
+        [this](bool succeeded)
+        {
+            this->setApplicationReturnValue(succeeded ? 0 : 1);
+            this->triggerAsyncUpdate();
+        });
+
+    if (! hasStarted)
+    {
+        this->setApplicationReturnValue(1);
+        this->quit();
+    }
+}
+
 void App::handleAsyncUpdate()
 {
     this->quit();
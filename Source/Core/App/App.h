@@ -41,6 +41,7 @@ class ApiCore;
 class AudioCore;
 class SessionService;
 class UpdatesService;
+class BatchRenderer;
 
 class App final : public JUCEApplication,
                   private AsyncUpdater,
@@ -110,6 +111,7 @@ private:
     ScopedPointer<class MainWindow> window;
     ScopedPointer<class SessionService> sessionService;
     ScopedPointer<class UpdatesService> updatesService;
+    ScopedPointer<class BatchRenderer> batchRenderer;
 
     using ResourceManagers = HashMap<Identifier, ResourceManager *, IdentifierHash>;
     ResourceManagers resourceManagers;
@@ -119,6 +121,7 @@ private:
     String getMacAddressList();
 
     void checkPlugin(const String &markerFile);
+    void startBatchRender(const String &commandLine);
     void changeListenerCallback(ChangeBroadcaster *source) override;
 
 private:
@@ -126,7 +129,8 @@ private:
     enum RunMode
     {
         NORMAL,
-        PLUGIN_CHECK
+        PLUGIN_CHECK,
+        BATCH_RENDER
     };
 
     App::RunMode detectRunMode(const String &commandLine);
@@ -0,0 +1,302 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Common.h"
+#include "BatchRenderer.h"
+#include "ProjectTreeItem.h"
+#include "RenderStatistics.h"
+#include "Transport.h"
+#include "Instrument.h"
+
+#define BATCH_RENDER_FLAG "--render"
+#define BATCH_RENDER_POLL_RATE_HZ 10
+
+static String getArgumentValue(const StringArray &arguments,
+    const String &key, const String &fallback)
+{
+    for (const auto &argument : arguments)
+    {
+        if (argument.startsWith(key + "="))
+        {
+            return argument.fromFirstOccurrenceOf("=", false, false).unquoted();
+        }
+    }
+
+    return fallback;
+}
+
+// The batch mode is a command line tool, so it reports to stdout
+static void printLine(const String &message)
+{
+    std::cout << message << std::endl;
+}
+
+BatchRenderer::BatchRenderer() :
+    numRunningJobs(0),
+    maxRunningJobs(1) {}
+
+BatchRenderer::~BatchRenderer()
+{
+    this->stopTimer();
+
+    for (auto *job : this->jobs)
+    {
+        if (job->project != nullptr)
+        {
+            job->project->getTransport().stopRender();
+        }
+    }
+
+    this->jobs.clear();
+}
+
+bool BatchRenderer::isRenderCommandLine(const StringArray &arguments)
+{
+    return arguments.contains(BATCH_RENDER_FLAG);
+}
+
+bool BatchRenderer::start(const StringArray &arguments, Function<void(bool)> callback)
+{
+    this->completionCallback = callback;
+
+    this->extension = getArgumentValue(arguments, "--format", "wav").toLowerCase();
+    if (this->extension != "wav" && this->extension != "flac")
+    {
+        printLine("Unsupported format: " + this->extension);
+        return false;
+    }
+
+    this->settings.bitDepth = getArgumentValue(arguments, "--bits", "24").getIntValue();
+
+    // the renderer only has decimators for these factors
+    const int oversamplingFactor = getArgumentValue(arguments, "--oversampling", "1").getIntValue();
+    if (oversamplingFactor != 1 && oversamplingFactor != 2 && oversamplingFactor != 4)
+    {
+        printLine("Unsupported oversampling: " + String(oversamplingFactor) + ", use 1, 2 or 4");
+        return false;
+    }
+
+    this->settings.oversamplingFactor = oversamplingFactor;
+
+    const String outputPath = getArgumentValue(arguments, "--output", {});
+    this->outputFolder = outputPath.isEmpty() ? File() :
+        File::getCurrentWorkingDirectory().getChildFile(outputPath);
+
+    if (this->outputFolder != File())
+    {
+        this->outputFolder.createDirectory();
+    }
+
+    const int numJobs = getArgumentValue(arguments, "--jobs", "0").getIntValue();
+    this->maxRunningJobs = (numJobs > 0) ? numJobs : jmax(1, SystemStats::getNumCpus());
+
+    for (const auto &argument : arguments)
+    {
+        if (argument.startsWith("--"))
+        {
+            continue;
+        }
+
+        const File source(File::getCurrentWorkingDirectory().getChildFile(argument.unquoted()));
+        if (! source.existsAsFile())
+        {
+            printLine("Project not found: " + source.getFullPathName());
+            continue;
+        }
+
+        const File targetFolder =
+            (this->outputFolder != File()) ? this->outputFolder : source.getParentDirectory();
+
+        auto *job = new Job();
+        job->source = source;
+        job->target = targetFolder.getChildFile(source.getFileNameWithoutExtension())
+            .withFileExtension(this->extension);
+
+        this->jobs.add(job);
+    }
+
+    if (this->jobs.isEmpty())
+    {
+        printLine("Nothing to render");
+        return false;
+    }
+
+    printLine("Rendering " + String(this->jobs.size()) + " project(s), up to " +
+        String(this->maxRunningJobs) + " at once");
+
+    this->startTimerHz(BATCH_RENDER_POLL_RATE_HZ);
+    return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Scheduling
+//===----------------------------------------------------------------------===//
+
+void BatchRenderer::timerCallback()
+{
+    for (auto *job : this->jobs)
+    {
+        if (job->started && !job->finished &&
+            !job->project->getTransport().isRendering())
+        {
+            this->finishJob(*job);
+        }
+    }
+
+    for (auto *job : this->jobs)
+    {
+        if (this->numRunningJobs >= this->maxRunningJobs)
+        {
+            break;
+        }
+
+        if (!job->started && this->canStartJob(*job))
+        {
+            this->startJob(*job);
+        }
+    }
+
+    if (this->numRunningJobs > 0)
+    {
+        return;
+    }
+
+    for (const auto *job : this->jobs)
+    {
+        if (!job->finished)
+        {
+            return;
+        }
+    }
+
+    this->stopTimer();
+
+    bool allSucceeded = true;
+    for (const auto *job : this->jobs)
+    {
+        allSucceeded = allSucceeded && job->succeeded;
+    }
+
+    if (this->completionCallback != nullptr)
+    {
+        this->completionCallback(allSucceeded);
+    }
+}
+
+bool BatchRenderer::canStartJob(const Job &job) const
+{
+    // instruments of a project are only known once it is loaded,
+    // so one is loaded at a time while the others are rendered;
+    // jobs are never skipped, otherwise a project with many instruments
+    // could be postponed by the smaller ones over and over again
+    for (const auto *other : this->jobs)
+    {
+        if (other == &job)
+        {
+            return true;
+        }
+
+        if (!other->started)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BatchRenderer::startJob(Job &job)
+{
+    if (job.project == nullptr)
+    {
+        job.project = new ProjectTreeItem(job.source);
+        if (! job.project->getDocument()->load(job.source.getFullPathName()))
+        {
+            printLine("Failed to load " + job.source.getFullPathName());
+            job.started = true;
+            job.finished = true;
+            job.project = nullptr;
+            return;
+        }
+
+        job.instruments = job.project->getTransport().getLinkedInstruments();
+    }
+
+    // the linked instruments are creating their plugins asynchronously
+    for (const auto *instrument : job.instruments)
+    {
+        if (!instrument->isInstantiated())
+        {
+            return;
+        }
+    }
+
+    for (const auto *other : this->jobs)
+    {
+        if (other->started && !other->finished)
+        {
+            for (auto *instrument : job.instruments)
+            {
+                if (other->instruments.contains(instrument))
+                {
+                    // wait for that one to finish
+                    return;
+                }
+            }
+        }
+    }
+
+    job.started = true;
+    job.target.deleteFile();
+
+    Transport &transport = job.project->getTransport();
+    transport.startRender(job.target.getFullPathName(), this->settings);
+
+    if (! transport.isRendering())
+    {
+        printLine("Nothing to render in " + job.source.getFullPathName());
+        job.finished = true;
+        job.project = nullptr;
+        return;
+    }
+
+    this->numRunningJobs++;
+    printLine("Started " + job.source.getFileName());
+}
+
+void BatchRenderer::finishJob(Job &job)
+{
+    const RenderStatistics &statistics = job.project->getTransport().getRenderStatistics();
+    job.succeeded = job.target.existsAsFile() &&
+        statistics.getFramesWritten() == statistics.getTotalFrames();
+
+    printLine((job.succeeded ? "Rendered " : "Failed ") +
+        job.target.getFullPathName() + " (" + statistics.getDescription() + ")");
+
+    // would it play in real time, and which instruments are to blame if not
+    printLine("  Block load: " + statistics.getBlockLoad().toString());
+    for (int i = 0; i < statistics.getNumInstruments(); ++i)
+    {
+        printLine("  " + statistics.getInstrumentName(i) + ": " +
+            String(statistics.getInstrumentSeconds(i), 2) + " s");
+    }
+
+    job.finished = true;
+    job.project = nullptr;
+    this->numRunningJobs--;
+}
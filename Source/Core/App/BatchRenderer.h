@@ -0,0 +1,77 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+class ProjectTreeItem;
+class Instrument;
+
+#include "RenderSettings.h"
+
+// Headless export of one or more projects, with no main window created:
+//
+//   helio --render [--format=wav|flac] [--bits=16|24|32] [--oversampling=N]
+//         [--output=<folder>] [--jobs=N] project1.helio project2.helio ...
+//
+// Projects are rendered concurrently, at most one per core by default;
+// since instruments are shared by all projects, two projects
+// that use any of the same instruments are never rendered at once.
+
+class BatchRenderer final : private Timer
+{
+public:
+
+    BatchRenderer();
+    ~BatchRenderer() override;
+
+    static bool isRenderCommandLine(const StringArray &arguments);
+
+    // Returns false if the arguments had no projects to render
+    bool start(const StringArray &arguments, Function<void(bool)> completionCallback);
+
+private:
+
+    struct Job final
+    {
+        File source;
+        File target;
+        ScopedPointer<ProjectTreeItem> project;
+        Array<Instrument *> instruments;
+        bool started = false;
+        bool finished = false;
+        bool succeeded = false;
+    };
+
+    void timerCallback() override;
+
+    bool canStartJob(const Job &job) const;
+    void startJob(Job &job);
+    void finishJob(Job &job);
+
+    OwnedArray<Job> jobs;
+    int numRunningJobs;
+    int maxRunningJobs;
+
+    RenderSettings settings;
+    String extension;
+    File outputFolder;
+
+    Function<void(bool)> completionCallback;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchRenderer)
+};
@@ -0,0 +1,249 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "Profiler.h"
+
+static_assert((PROFILER_RING_BUFFER_SIZE & (PROFILER_RING_BUFFER_SIZE - 1)) == 0,
+    "Ring buffer size should be a power of two");
+
+#define PROFILER_RING_BUFFER_MASK (PROFILER_RING_BUFFER_SIZE - 1)
+
+Atomic<int> Profiler::enabled(0);
+
+// Only the owner thread writes the events, and only publishes
+// them by incrementing the counter, after the event is complete
+struct ProfilerThreadBuffer final
+{
+    Atomic<int64> numWritten;
+    // the claim of the owner thread, or zero when the buffer is free
+    Atomic<uint32> ownerToken;
+    Atomic<int> isMessageThread;
+    Profiler::Event events[PROFILER_RING_BUFFER_SIZE];
+
+    // accessed by the collecting thread only
+    int64 numCollected = 0;
+    double lastActiveMs = 0.0;
+};
+
+// The pool is preallocated statically, so the memory pages of the rings
+// are only committed, when some thread actually writes its events there
+static ProfilerThreadBuffer kThreadBuffers[PROFILER_MAX_THREADS];
+
+static Atomic<uint32> kLastClaimToken(0);
+static Atomic<uint32> kNumReleasedBuffers(0);
+
+// The thread's claim is kept in plain thread-local values, which are
+// trivially destructible, so that no thread exit handlers are registered
+// (that would allocate on the first event of the audio thread); instead,
+// the collector releases the buffers which had no new events for a while,
+// and a thread, which finds its token gone, just claims a buffer again.
+// The threads that have come while the pool was full retry only after
+// some buffer has been released
+static thread_local int kThreadBufferIndex = -1;
+static thread_local uint32 kThreadBufferToken = 0;
+static thread_local uint32 kThreadNumReleasesSeen = 0;
+
+static ProfilerThreadBuffer *getCurrentThreadBuffer() noexcept
+{
+    if (kThreadBufferIndex >= 0)
+    {
+        auto &buffer = kThreadBuffers[kThreadBufferIndex];
+        if (buffer.ownerToken.get() == kThreadBufferToken)
+        {
+            return &buffer;
+        }
+
+        kThreadBufferIndex = -1;
+    }
+    else if (kThreadBufferToken != 0 &&
+        kThreadNumReleasesSeen == kNumReleasedBuffers.get())
+    {
+        return nullptr; // the pool was full, and nothing has changed since
+    }
+
+    uint32 token = ++kLastClaimToken;
+    token = (token != 0) ? token : ++kLastClaimToken;
+    kThreadBufferToken = token;
+    kThreadNumReleasesSeen = kNumReleasedBuffers.get();
+
+    for (int i = 0; i < PROFILER_MAX_THREADS; ++i)
+    {
+        auto &buffer = kThreadBuffers[i];
+        if (buffer.ownerToken.compareAndSetBool(token, 0))
+        {
+            auto *messageManager = MessageManager::getInstanceWithoutCreating();
+            buffer.isMessageThread =
+                (messageManager != nullptr && messageManager->isThisTheMessageThread()) ? 1 : 0;
+            kThreadBufferIndex = i;
+            return &buffer;
+        }
+    }
+
+    return nullptr;
+}
+
+void Profiler::setEnabled(bool shouldBeEnabled) noexcept
+{
+    enabled = shouldBeEnabled ? 1 : 0;
+}
+
+//===----------------------------------------------------------------------===//
+// Recording
+//===----------------------------------------------------------------------===//
+
+void Profiler::record(const char *name, const char *label,
+    double startMs, double durationMs) noexcept
+{
+    auto *buffer = getCurrentThreadBuffer();
+    if (buffer == nullptr)
+    {
+        return;
+    }
+
+    const int64 position = buffer->numWritten.get();
+    auto &event = buffer->events[position & PROFILER_RING_BUFFER_MASK];
+
+    event.name = name;
+    event.startMs = startMs;
+    event.durationMs = durationMs;
+    event.threadIndex = 0;
+
+    if (label != nullptr)
+    {
+        strncpy(event.label, label, PROFILER_LABEL_SIZE - 1);
+        event.label[PROFILER_LABEL_SIZE - 1] = 0;
+    }
+    else
+    {
+        event.label[0] = 0;
+    }
+
+    buffer->numWritten = position + 1;
+}
+
+//===----------------------------------------------------------------------===//
+// Collecting
+//===----------------------------------------------------------------------===//
+
+void Profiler::collectEvents(Array<Event> &result)
+{
+    const double nowMs = Time::getMillisecondCounterHiRes();
+
+    // released buffers may still have some events to collect,
+    // and the ones never claimed are skipped quickly anyway
+    for (int i = 0; i < PROFILER_MAX_THREADS; ++i)
+    {
+        auto &buffer = kThreadBuffers[i];
+        const int64 end = buffer.numWritten.get();
+
+        if (end != buffer.numCollected)
+        {
+            buffer.lastActiveMs = nowMs;
+        }
+        else if (buffer.ownerToken.get() != 0 &&
+            (nowMs - buffer.lastActiveMs) > PROFILER_IDLE_BUFFER_RELEASE_MS)
+        {
+            // the owner has either exited, or will claim a buffer again
+            buffer.ownerToken = 0;
+            ++kNumReleasedBuffers;
+            continue;
+        }
+
+        const int64 start = jmax(buffer.numCollected, end - PROFILER_RING_BUFFER_SIZE);
+        const int firstIndex = result.size();
+
+        for (int64 position = start; position < end; ++position)
+        {
+            Event event = buffer.events[position & PROFILER_RING_BUFFER_MASK];
+            event.threadIndex = i;
+            result.add(event);
+        }
+
+        // the owner thread might have gone round the ring while copying,
+        // so the oldest copied events could be garbage by now; the slot
+        // at numWritten may be half-written too, hence the + 1
+        const int64 firstValid = buffer.numWritten.get() - PROFILER_RING_BUFFER_SIZE + 1;
+        const int numOverwritten = int(jlimit(int64(0), end - start, firstValid - start));
+        result.removeRange(firstIndex, numOverwritten);
+
+        buffer.numCollected = end;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Export
+//===----------------------------------------------------------------------===//
+
+String Profiler::exportChromeTrace(const Array<Event> &events)
+{
+    static const Identifier name("name");
+    static const Identifier ph("ph");
+    static const Identifier ts("ts");
+    static const Identifier dur("dur");
+    static const Identifier pid("pid");
+    static const Identifier tid("tid");
+    static const Identifier args("args");
+    static const Identifier label("label");
+
+    Array<var> traceEvents;
+    Array<int> threadIndices;
+
+    for (const auto &event : events)
+    {
+        DynamicObject::Ptr traceEvent(new DynamicObject());
+        traceEvent->setProperty(name, String(CharPointer_UTF8(event.name)));
+        traceEvent->setProperty(ph, "X");
+        traceEvent->setProperty(ts, event.startMs * 1000.0);
+        traceEvent->setProperty(dur, event.durationMs * 1000.0);
+        traceEvent->setProperty(pid, 1);
+        traceEvent->setProperty(tid, event.threadIndex);
+
+        if (event.label[0] != 0)
+        {
+            DynamicObject::Ptr traceArgs(new DynamicObject());
+            traceArgs->setProperty(label, String(CharPointer_UTF8(event.label)));
+            traceEvent->setProperty(args, var(traceArgs.get()));
+        }
+
+        traceEvents.add(var(traceEvent.get()));
+        threadIndices.addIfNotAlreadyThere(event.threadIndex);
+    }
+
+    // metadata events, so that the threads are named in the viewer
+    for (const auto threadIndex : threadIndices)
+    {
+        const bool isMessageThread = kThreadBuffers[threadIndex].isMessageThread.get() != 0;
+
+        DynamicObject::Ptr threadName(new DynamicObject());
+        threadName->setProperty(name, isMessageThread ?
+            String("Message thread") : ("Thread " + String(threadIndex)));
+
+        DynamicObject::Ptr metadataEvent(new DynamicObject());
+        metadataEvent->setProperty(name, "thread_name");
+        metadataEvent->setProperty(ph, "M");
+        metadataEvent->setProperty(pid, 1);
+        metadataEvent->setProperty(tid, threadIndex);
+        metadataEvent->setProperty(args, var(threadName.get()));
+        traceEvents.add(var(metadataEvent.get()));
+    }
+
+    DynamicObject::Ptr root(new DynamicObject());
+    root->setProperty("traceEvents", traceEvents);
+    root->setProperty("displayTimeUnit", "ms");
+    return JSON::toString(var(root.get()));
+}
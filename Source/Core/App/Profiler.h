@@ -0,0 +1,117 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define PROFILER_MAX_THREADS 32
+#define PROFILER_RING_BUFFER_SIZE 1024
+#define PROFILER_LABEL_SIZE 24
+
+// A claimed buffer with no new events for this long is given back to the pool
+#define PROFILER_IDLE_BUFFER_RELEASE_MS 10000.0
+
+// Scoped timers for hot paths, like painting, rebuilding sequences,
+// performing undo actions, saving documents or processing audio.
+// Each thread writes into its own lock-free ring buffer, which is
+// claimed from a preallocated pool on its first event, so that the
+// audio thread never allocates or locks; the message thread collects
+// all new events from time to time for the statistics, and releases
+// the buffers that have been idle for a while, e.g. of exited threads.
+// When disabled, a timer costs a single atomic read.
+
+#define PROFILE_SCOPE(name) \
+    const Profiler::ScopedTimer JUCE_JOIN_MACRO(profilerScope, __LINE__)(name)
+
+#define PROFILE_SCOPE_WITH_LABEL(name, label) \
+    const Profiler::ScopedTimer JUCE_JOIN_MACRO(profilerScope, __LINE__)(name, label)
+
+class Profiler final
+{
+public:
+
+    static bool isEnabled() noexcept { return enabled.get() != 0; }
+    static void setEnabled(bool shouldBeEnabled) noexcept;
+
+    // A fixed-size copy of some name, e.g. the instrument's one,
+    // to be passed along with an event from the audio thread;
+    // a rename during playback may tear a label or two, which is fine
+    struct Label final
+    {
+        void set(const String &text) noexcept
+        { text.copyToUTF8(this->data, PROFILER_LABEL_SIZE); }
+
+        const char *get() const noexcept
+        { return this->data; }
+
+        char data[PROFILER_LABEL_SIZE] = { 0 };
+    };
+
+    struct Event final
+    {
+        // the name is always a string literal, never copied
+        const char *name;
+        char label[PROFILER_LABEL_SIZE];
+        double startMs;
+        double durationMs;
+        // filled when collected
+        int threadIndex;
+    };
+
+    class ScopedTimer final
+    {
+    public:
+
+        explicit ScopedTimer(const char *name, const char *label = nullptr) noexcept :
+            name(Profiler::isEnabled() ? name : nullptr),
+            label(label),
+            startMs(this->name != nullptr ? Time::getMillisecondCounterHiRes() : 0.0) {}
+
+        ~ScopedTimer() noexcept
+        {
+            if (this->name != nullptr)
+            {
+                Profiler::record(this->name, this->label, this->startMs,
+                    Time::getMillisecondCounterHiRes() - this->startMs);
+            }
+        }
+
+    private:
+
+        const char *name;
+        const char *label;
+        const double startMs;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+    };
+
+    // Can be called from any thread
+    static void record(const char *name, const char *label,
+        double startMs, double durationMs) noexcept;
+
+    // Moves all the events recorded since the last call into the given array;
+    // events overwritten by a thread before being collected are dropped.
+    // Should only be called from a single (i.e. the message) thread
+    static void collectEvents(Array<Event> &result);
+
+    // Chrome tracing JSON, to be opened with chrome://tracing
+    static String exportChromeTrace(const Array<Event> &events);
+
+private:
+
+    static Atomic<int> enabled;
+
+};
@@ -0,0 +1,190 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Common.h"
+#include "StartupGraph.h"
+
+// Initialized along with the other statics, i.e. before App::initialise
+static const double startupTimeMs = Time::getMillisecondCounterHiRes();
+
+class StartupGraph::Job final : public ThreadPoolJob
+{
+public:
+
+    Job(StartupGraph &graph, Node &node) :
+        ThreadPoolJob("Startup job"),
+        graph(graph),
+        node(node) {}
+
+    JobStatus runJob() override
+    {
+        this->graph.runNode(this->node);
+        return jobHasFinished;
+    }
+
+private:
+
+    StartupGraph &graph;
+    Node &node;
+
+    JUCE_DECLARE_NON_COPYABLE(Job)
+};
+
+StartupGraph::StartupGraph() :
+    threadPool(jmax(1, SystemStats::getNumCpus() - 1)) {}
+
+StartupGraph::~StartupGraph()
+{
+    this->threadPool.removeAllJobs(false, -1);
+}
+
+void StartupGraph::addTask(const String &name, Affinity affinity,
+    const StringArray &dependencies, Task task)
+{
+    auto *node = new Node();
+    node->name = name;
+    node->affinity = affinity;
+    node->dependencies = dependencies;
+    node->task = task;
+    this->nodes.add(node);
+}
+
+void StartupGraph::run()
+{
+    jassert(MessageManager::getInstance()->isThisTheMessageThread());
+    const double startTime = StartupGraph::getMillisecondsSinceStartup();
+
+    while (true)
+    {
+        Node *messageThreadNode = nullptr;
+        bool allDone = true;
+        bool anyRunning = false;
+
+        {
+            const ScopedLock lock(this->nodesLock);
+            for (auto *node : this->nodes)
+            {
+                allDone = allDone && node->isDone;
+                anyRunning = anyRunning || (node->isScheduled && !node->isDone);
+
+                if (node->isScheduled || !this->areDependenciesDone(*node))
+                {
+                    continue;
+                }
+
+                if (node->affinity == AnyThread)
+                {
+                    node->isScheduled = true;
+                    anyRunning = true;
+                    this->threadPool.addJob(new Job(*this, *node), true);
+                }
+                else if (messageThreadNode == nullptr)
+                {
+                    node->isScheduled = true;
+                    messageThreadNode = node;
+                }
+            }
+        }
+
+        if (allDone)
+        {
+            break;
+        }
+
+        if (messageThreadNode != nullptr)
+        {
+            this->runNode(*messageThreadNode);
+        }
+        else if (anyRunning)
+        {
+            this->nodeFinished.wait(-1);
+        }
+        else
+        {
+            // a missing dependency or a cycle
+            jassertfalse;
+            break;
+        }
+    }
+
+    StartupGraph::logStage("Startup graph", startTime);
+}
+
+bool StartupGraph::areDependenciesDone(const Node &node) const
+{
+    for (const auto &dependency : node.dependencies)
+    {
+        bool found = false;
+        for (const auto *other : this->nodes)
+        {
+            if (other->name == dependency)
+            {
+                if (!other->isDone)
+                {
+                    return false;
+                }
+
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void StartupGraph::runNode(Node &node)
+{
+    const double startTime = StartupGraph::getMillisecondsSinceStartup();
+
+    if (node.task != nullptr)
+    {
+        node.task();
+    }
+
+    StartupGraph::logStage(node.name, startTime);
+
+    {
+        const ScopedLock lock(this->nodesLock);
+        node.isDone = true;
+    }
+
+    this->nodeFinished.signal();
+}
+
+//===----------------------------------------------------------------------===//
+// Timing
+//===----------------------------------------------------------------------===//
+
+double StartupGraph::getMillisecondsSinceStartup() noexcept
+{
+    return Time::getMillisecondCounterHiRes() - startupTimeMs;
+}
+
+void StartupGraph::logStage(const String &stageName, double startTimeMs)
+{
+    const double endTimeMs = StartupGraph::getMillisecondsSinceStartup();
+    Logger::writeToLog("Startup: " + stageName + " took " +
+        String(endTimeMs - startTimeMs, 1) + " ms, done at " +
+        String(endTimeMs, 1) + " ms");
+}
@@ -0,0 +1,78 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+// Initialization tasks with dependencies between them:
+// each task runs as soon as all the tasks it depends on are done,
+// either on the thread pool, or on the message thread for anything
+// that deals with components, listeners and timers.
+// Every task is timed and logged relative to the app startup.
+
+class StartupGraph final
+{
+public:
+
+    enum Affinity
+    {
+        MessageThread,
+        AnyThread
+    };
+
+    using Task = Function<void()>;
+
+    StartupGraph();
+    ~StartupGraph();
+
+    void addTask(const String &name, Affinity affinity,
+        const StringArray &dependencies, Task task);
+
+    // Blocks the calling message thread until all the tasks are done,
+    // running message thread tasks by itself while the pool is busy
+    void run();
+
+    // Milliseconds since the app has started, used for startup logs
+    static double getMillisecondsSinceStartup() noexcept;
+    static void logStage(const String &stageName, double startTimeMs);
+
+private:
+
+    struct Node final
+    {
+        String name;
+        Affinity affinity;
+        StringArray dependencies;
+        Task task;
+        bool isScheduled = false;
+        bool isDone = false;
+    };
+
+    class Job;
+    friend class Job;
+
+    bool areDependenciesDone(const Node &node) const;
+    void runNode(Node &node);
+
+    OwnedArray<Node> nodes;
+    ThreadPool threadPool;
+
+    CriticalSection nodesLock;
+    WaitableEvent nodeFinished;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StartupGraph)
+};
@@ -30,6 +30,12 @@
 #include "ProjectTreeItem.h"
 #include "RootTreeItem.h"
 #include "Dashboard.h"
+#include "StartupGraph.h"
+
+// Projects are only loaded when activated; the least recently used ones
+// are unloaded periodically, so that only a few of them stay in memory
+#define WORKSPACE_MAX_LOADED_PROJECTS 3
+#define WORKSPACE_UNLOAD_CHECK_INTERVAL_MS 30000
 
 Workspace::Workspace() : wasInitialized(false)
 {
@@ -58,10 +64,13 @@ void Workspace::init()
 {
     if (! this->wasInitialized)
     {
+        double startTime = StartupGraph::getMillisecondsSinceStartup();
         this->audioCore = new AudioCore();
         this->pluginManager = new PluginScanner();
         this->treeRoot = new RootTreeItem("Workspace");
-        
+        StartupGraph::logStage("Audio core", startTime);
+
+        startTime = StartupGraph::getMillisecondsSinceStartup();
         if (! this->autoload())
         {
             Logger::writeToLog("workspace autoload failed, creating an empty one");
@@ -71,9 +80,40 @@ void Workspace::init()
         {
             this->wasInitialized = true;
         }
+
+        StartupGraph::logStage("Workspace", startTime);
+        this->startTimer(WORKSPACE_UNLOAD_CHECK_INTERVAL_MS);
     }
 }
 
+void Workspace::initHeadless()
+{
+    if (this->audioCore != nullptr)
+    {
+        return;
+    }
+
+    this->audioCore = new AudioCore();
+
+    // the instruments are taken from the saved workspace, if any;
+    // wasInitialized stays false, so that it is never overwritten
+    if (Config::contains(Serialization::Config::activeWorkspace))
+    {
+        Config::load(*this->audioCore, Serialization::Config::activeWorkspace);
+    }
+    else
+    {
+        this->audioCore->autodetectDeviceSetup();
+    }
+
+    if (this->audioCore->getInstruments().isEmpty())
+    {
+        this->audioCore->initDefaultInstrument();
+    }
+
+    this->audioCore->setOffline(true);
+}
+
 bool Workspace::isInitialized() const noexcept
 {
     return this->wasInitialized;
@@ -267,6 +307,11 @@ void Workspace::unloadProjectById(const String &targetProjectId)
 
 Array<ProjectTreeItem *> Workspace::getLoadedProjects() const
 {
+    if (this->treeRoot == nullptr)
+    {
+        return {};
+    }
+
     return this->treeRoot->findChildrenOfType<ProjectTreeItem>();
 }
 
@@ -316,6 +361,57 @@ bool Workspace::autoload()
     return false;
 }
 
+void Workspace::timerCallback()
+{
+    this->unloadInactiveProjects(WORKSPACE_MAX_LOADED_PROJECTS);
+}
+
+struct ProjectsByActivationTimeSorter final
+{
+    static int compareElements(ProjectTreeItem *first, ProjectTreeItem *second)
+    {
+        const double diff = second->getLastActivationTime() - first->getLastActivationTime();
+        return (diff > 0.0) - (diff < 0.0);
+    }
+};
+
+void Workspace::unloadInactiveProjects(int numProjectsToKeep)
+{
+    ProjectTreeItem *activeProject = nullptr;
+    if (TreeItem *activeItem = this->getActiveTreeItem())
+    {
+        activeProject = dynamic_cast<ProjectTreeItem *>(activeItem);
+        if (activeProject == nullptr)
+        {
+            activeProject = activeItem->findParentOfType<ProjectTreeItem>();
+        }
+    }
+
+    Array<ProjectTreeItem *> loadedProjects;
+    for (auto *project : this->getLoadedProjects())
+    {
+        if (project->isLoaded() && project != activeProject)
+        {
+            loadedProjects.add(project);
+        }
+    }
+
+    // the active one always stays, the rest are kept by the last activation time
+    const int numToKeep = jmax(0, numProjectsToKeep - (activeProject != nullptr ? 1 : 0));
+    if (loadedProjects.size() <= numToKeep)
+    {
+        return;
+    }
+
+    ProjectsByActivationTimeSorter sorter;
+    loadedProjects.sort(sorter);
+
+    for (int i = numToKeep; i < loadedProjects.size(); ++i)
+    {
+        loadedProjects.getUnchecked(i)->unload();
+    }
+}
+
 void Workspace::failedDeserializationFallback()
 {
     this->getAudioCore().autodetectDeviceSetup();
@@ -452,12 +548,17 @@ void Workspace::deserialize(const ValueTree &tree)
     }
 
     this->recentFilesList->deserialize(root);
+
+    double startTime = StartupGraph::getMillisecondsSinceStartup();
     this->audioCore->deserialize(root);
     this->pluginManager->deserialize(root);
+    StartupGraph::logStage("Audio devices and orchestra", startTime);
 
+    startTime = StartupGraph::getMillisecondsSinceStartup();
     auto treeRootNodeLegacy = root.getChildWithName(Core::treeItem);
     auto treeRootNode = root.getChildWithName(Core::treeRoot);
     this->treeRoot->deserialize(treeRootNode.isValid() ? treeRootNode : treeRootNodeLegacy);
+    StartupGraph::logStage("Workspace tree and active project", startTime);
     
     bool foundActiveNode = false;
     const auto treeStateNode = root.getChildWithName(Core::treeState);
@@ -27,7 +27,8 @@ class PluginScanner;
 #include "TreeNavigationHistory.h"
 
 class Workspace final : public RecentFilesList::Owner,
-                        private Serializable
+                        private Serializable,
+                        private Timer
 {
 public:
     
@@ -37,6 +38,9 @@ public:
     void init();
     bool isInitialized() const noexcept;
 
+    // Only loads the audio core, with no tree and no autosaving, for the command line
+    void initHeadless();
+
     WeakReference<TreeItem> getActiveTreeItem() const;
     TreeNavigationHistory &getNavigationHistory();
     void navigateBackwardIfPossible();
@@ -62,6 +66,7 @@ public:
     void createEmptyProject();
     void unloadProjectById(const String &id);
     Array<ProjectTreeItem *> getLoadedProjects() const;
+    void unloadInactiveProjects(int numProjectsToKeep);
     void stopPlaybackForAllProjects();
 
     //===------------------------------------------------------------------===//
@@ -85,6 +90,9 @@ private:
 private:
     
     void failedDeserializationFallback();
+
+    // Unloads the least recently used projects from time to time
+    void timerCallback() override;
     
 private:
     
@@ -24,6 +24,7 @@
 #include "Instrument.h"
 #include "SerializationKeys.h"
 #include "AudioMonitor.h"
+#include "MixingEngine.h"
 
 void AudioCore::initAudioFormats(AudioPluginFormatManager &formatManager)
 {
@@ -36,11 +37,16 @@ AudioCore::AudioCore()
 {
     this->audioMonitor = new AudioMonitor();
     this->deviceManager.addAudioCallback(this->audioMonitor);
+
+    this->mixingEngine = new MixingEngine();
+    this->deviceManager.addAudioCallback(this->mixingEngine);
     AudioCore::initAudioFormats(this->formatManager);
 }
 
 AudioCore::~AudioCore()
 {
+    this->deviceManager.removeAudioCallback(this->mixingEngine);
+    this->mixingEngine = nullptr;
     this->deviceManager.removeAudioCallback(this->audioMonitor);
     this->audioMonitor = nullptr;
     this->deviceManager.closeAudioDevice();
@@ -56,6 +62,11 @@ void AudioCore::mute()
 
 void AudioCore::unmute()
 {
+    if (this->offline)
+    {
+        return;
+    }
+
     this->mute(); // на всякий случай, чтоб 2 раза инструменты не добавлялись
 
     for (auto instrument : this->instruments)
@@ -64,6 +75,25 @@ void AudioCore::unmute()
     }
 }
 
+void AudioCore::setOffline(bool shouldBeOffline)
+{
+    this->offline = shouldBeOffline;
+
+    if (this->offline)
+    {
+        this->mute();
+    }
+    else
+    {
+        this->unmute();
+    }
+}
+
+bool AudioCore::isOffline() const noexcept
+{
+    return this->offline;
+}
+
 AudioDeviceManager &AudioCore::getDevice() noexcept
 {
     return this->deviceManager;
@@ -79,6 +109,11 @@ AudioMonitor *AudioCore::getMonitor() const noexcept
     return this->audioMonitor;
 }
 
+MixingEngine *AudioCore::getMixingEngine() const noexcept
+{
+    return this->mixingEngine;
+}
+
 //===----------------------------------------------------------------------===//
 // Instruments
 //===----------------------------------------------------------------------===//
@@ -110,14 +145,14 @@ void AudioCore::removeInstrument(Instrument *instrument)
 
 void AudioCore::addInstrumentToDevice(Instrument *instrument)
 {
-    this->deviceManager.addAudioCallback(&instrument->getProcessorPlayer());
-    this->deviceManager.addMidiInputCallback({}, &instrument->getProcessorPlayer().getMidiMessageCollector());
+    this->mixingEngine->addAudioCallback(&instrument->getProcessorPlayer());
+    this->deviceManager.addMidiInputCallback({}, &instrument->getProcessorPlayer());
 }
 
 void AudioCore::removeInstrumentFromDevice(Instrument *instrument)
 {
-    this->deviceManager.removeAudioCallback(&instrument->getProcessorPlayer());
-    this->deviceManager.removeMidiInputCallback({}, &instrument->getProcessorPlayer().getMidiMessageCollector());
+    this->mixingEngine->removeAudioCallback(&instrument->getProcessorPlayer());
+    this->deviceManager.removeMidiInputCallback({}, &instrument->getProcessorPlayer());
 }
 
 //===----------------------------------------------------------------------===//
@@ -18,6 +18,7 @@
 #pragma once
 
 class AudioMonitor;
+class MixingEngine;
 
 #include "Instrument.h"
 #include "OrchestraPit.h"
@@ -37,6 +38,12 @@ public:
     void mute();
     void unmute();
 
+    // An offline core never connects instruments to the audio device,
+    // so that a finished render doesn't unmute the instruments
+    // that are still being rendered by the others (see BatchRenderer)
+    void setOffline(bool shouldBeOffline);
+    bool isOffline() const noexcept;
+
     //===------------------------------------------------------------------===//
     // Instruments
     //===------------------------------------------------------------------===//
@@ -62,6 +69,7 @@ public:
     AudioDeviceManager &getDevice() noexcept;
     AudioPluginFormatManager &getFormatManager() noexcept;
     AudioMonitor *getMonitor() const noexcept;
+    MixingEngine *getMixingEngine() const noexcept;
 
     //===------------------------------------------------------------------===//
     // Serializable
@@ -124,12 +132,15 @@ private:
 
     OwnedArray<Instrument> instruments;
     ScopedPointer<AudioMonitor> audioMonitor;
+    ScopedPointer<MixingEngine> mixingEngine;
 
     AudioPluginFormatManager formatManager;
     AudioDeviceManager deviceManager;
 
     StringArray customMidiInputs;
 
+    bool offline = false;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCore)
     JUCE_DECLARE_WEAK_REFERENCEABLE(AudioCore)
 };
@@ -22,6 +22,11 @@
 #include "SerializablePluginDescription.h"
 #include "SerializationKeys.h"
 
+// How many silent blocks in a row put an idle instrument to sleep
+#define INSTRUMENT_SLEEP_SILENT_BLOCKS 64
+// Roughly -100 dB
+#define INSTRUMENT_SLEEP_SILENCE_THRESHOLD 0.00001f
+
 const int Instrument::midiChannelNumber = 0x1000;
 
 Instrument::Instrument(AudioPluginFormatManager &formatManager, const String &name) :
@@ -31,6 +36,7 @@ Instrument::Instrument(AudioPluginFormatManager &formatManager, const String &na
 {
     this->processorGraph = new AudioProcessorGraph();
     this->audioCallback.setProcessor(this->processorGraph);
+    this->audioCallback.setProfilerLabel(this->instrumentName);
 }
 
 Instrument::~Instrument()
@@ -51,6 +57,7 @@ String Instrument::getName() const
 void Instrument::setName(const String &name)
 {
     this->instrumentName = name;
+    this->audioCallback.setProfilerLabel(this->instrumentName);
 }
 
 String Instrument::getInstrumentID() const
@@ -61,6 +68,17 @@ String Instrument::getInstrumentID() const
 String Instrument::getInstrumentHash() const
 {
     String instrumentId;
+
+    if (this->pendingState.isValid())
+    {
+        forEachValueTreeChildWithType(this->pendingState, e, Serialization::Audio::node)
+        {
+            instrumentId += e.getProperty(Serialization::Audio::nodeHash).toString();
+        }
+
+        return String(CompileTimeHash(instrumentId.toUTF8()));
+    }
+
     const int numNodes = this->processorGraph->getNumNodes();
     
     for (int i = 0; i < numNodes; ++i)
@@ -84,6 +102,7 @@ bool Instrument::isValid() const noexcept
 
 void Instrument::initializeFrom(const PluginDescription &pluginDescription, InitializationCallback initCallback)
 {
+    this->pendingState = {};
     this->processorGraph->clear();
 
     this->addNodeAsync(pluginDescription, 0.5f, 0.5f, 
@@ -124,6 +143,8 @@ void Instrument::initializeFrom(const PluginDescription &pluginDescription, Init
 
 void Instrument::addNodeToFreeSpace(const PluginDescription &pluginDescription, InitializationCallback initCallback)
 {
+    this->instantiateIfNeeded();
+
     Random r;
     float x = 0.15f + r.nextFloat() * 0.7f;
     float y = 0.15f + r.nextFloat() * 0.7f;
@@ -421,6 +442,7 @@ void Instrument::removeConnection(AudioProcessorGraph::Connection connection)
 void Instrument::reset()
 {
     PluginWindow::closeAllCurrentlyOpenWindows();
+    this->pendingState = {};
     this->processorGraph->clear();
     this->instrumentName.clear();
     this->sendChangeMessage();
@@ -434,6 +456,14 @@ void Instrument::reset()
 ValueTree Instrument::serialize() const
 {
     using namespace Serialization;
+    // never instantiated this session, so the saved state is still up to date
+    if (this->pendingState.isValid())
+    {
+        ValueTree tree(this->pendingState.createCopy());
+        tree.setProperty(Audio::instrumentName, this->instrumentName, nullptr);
+        return tree;
+    }
+
     ValueTree tree(Audio::instrument);
     tree.setProperty(Audio::instrumentId, this->instrumentID.toString(), nullptr);
     tree.setProperty(Audio::instrumentName, this->instrumentName, nullptr);
@@ -469,6 +499,31 @@ void Instrument::deserialize(const ValueTree &tree)
 
     this->instrumentID = root.getProperty(Audio::instrumentId, this->instrumentID.toString());
     this->instrumentName = root.getProperty(Audio::instrumentName, this->instrumentName);
+    this->audioCallback.setProfilerLabel(this->instrumentName);
+
+    // plugins are only instantiated on first use,
+    // which keeps the startup time independent of the orchestra size
+    this->pendingState = root;
+}
+
+bool Instrument::isInstantiated() const noexcept
+{
+    return !this->pendingState.isValid() && this->numNodesLoading == 0;
+}
+
+void Instrument::instantiateIfNeeded()
+{
+    if (!this->pendingState.isValid())
+    {
+        return;
+    }
+
+    using namespace Serialization;
+    const ValueTree root(this->pendingState);
+    this->pendingState = {};
+
+    const double startTime = Time::getMillisecondCounterHiRes();
+    Logger::writeToLog("Instantiating " + this->instrumentName);
 
     // Well this hack of an incredible ugliness
     // is here to handle loading of async-loaded AUv3 plugins
@@ -496,11 +551,20 @@ void Instrument::deserialize(const ValueTree &tree)
         });
     }
 
+    const auto logInstantiated = [this, startTime]()
+    {
+        Logger::writeToLog("Instantiated " + this->instrumentName + " in " +
+            String(Time::getMillisecondCounterHiRes() - startTime, 1) + " ms");
+    };
+
     forEachValueTreeChildWithType(root, e, Serialization::Audio::node)
     {
+        this->numNodesLoading++;
         this->deserializeNodeAsync(e,
-            [this, connectionDescriptions](AudioProcessorGraph::Node::Ptr n)
+            [this, connectionDescriptions, logInstantiated](AudioProcessorGraph::Node::Ptr n)
             {
+                this->numNodesLoading--;
+
                 // Try to create as many connections as possible
                 for (const auto &connectionInfo : connectionDescriptions)
                 {
@@ -512,8 +576,20 @@ void Instrument::deserialize(const ValueTree &tree)
 
                 this->processorGraph->removeIllegalConnections();
                 this->sendChangeMessage();
+
+                if (this->numNodesLoading == 0)
+                {
+                    logInstantiated();
+                }
             });
     }
+
+    // the nodes are created asynchronously,
+    // so the last one to finish reports the time
+    if (this->numNodesLoading == 0)
+    {
+        logInstantiated();
+    }
 }
 
 ValueTree Instrument::serializeNode(AudioProcessorGraph::Node::Ptr node) const
@@ -702,6 +778,7 @@ void Instrument::AudioCallback::setProcessor(AudioProcessor *const newOne)
             oldOne = this->isPrepared ? this->processor : nullptr;
             this->processor = newOne;
             this->isPrepared = true;
+            this->resetSleepState();
         }
 
         if (oldOne != nullptr)
@@ -715,10 +792,43 @@ void Instrument::AudioCallback::audioDeviceIOCallback(const float** const inputC
     const int numInputChannels, float **const outputChannelData,
     const int numOutputChannels, const int numSamples)
 {
+    PROFILE_SCOPE_WITH_LABEL("Instrument::AudioCallback", this->profilerLabel.get());
+    const LoadMeter::ScopedCallback loadMeasurement(this->loadMeter, numSamples);
     jassert(this->sampleRate > 0 && this->blockSize > 0);
 
     this->incomingMidi.clear();
-    this->messageCollector.removeNextBlockOfMessages(this->incomingMidi, numSamples);
+    this->eventQueue.popAll(this->incomingMidi, numSamples);
+
+    if (!this->incomingMidi.isEmpty())
+    {
+        this->updateHeldNotes(this->incomingMidi);
+        this->numSilentBlocks = 0;
+        this->sleeping = 0;
+    }
+    else if (this->sleeping.get() != 0)
+    {
+        bool inputIsSilent = true;
+        for (int i = 0; i < numInputChannels && inputIsSilent; ++i)
+        {
+            const auto range = FloatVectorOperations::findMinAndMax(inputChannelData[i], numSamples);
+            inputIsSilent = jmax(range.getEnd(), -range.getStart()) <= INSTRUMENT_SLEEP_SILENCE_THRESHOLD;
+        }
+
+        if (inputIsSilent)
+        {
+            for (int i = 0; i < numOutputChannels; ++i)
+            {
+                FloatVectorOperations::clear(outputChannelData[i], numSamples);
+            }
+
+            this->levelMeter.processSilence(numSamples);
+            return;
+        }
+
+        this->numSilentBlocks = 0;
+        this->sleeping = 0;
+    }
+
     int totalNumChans = 0;
 
     if (numInputChannels > numOutputChannels)
@@ -768,6 +878,8 @@ void Instrument::AudioCallback::audioDeviceIOCallback(const float** const inputC
             if (!this->processor->isSuspended())
             {
                 this->processor->processBlock(buffer, this->incomingMidi);
+                this->updateSleepState(buffer);
+                this->levelMeter.process(outputChannelData, numOutputChannels, numSamples);
                 return;
             }
         }
@@ -777,6 +889,8 @@ void Instrument::AudioCallback::audioDeviceIOCallback(const float** const inputC
     {
         FloatVectorOperations::clear(outputChannelData[i], numSamples);
     }
+
+    this->levelMeter.processSilence(numSamples);
 }
 
 void Instrument::AudioCallback::audioDeviceAboutToStart(AudioIODevice* const device)
@@ -793,8 +907,12 @@ void Instrument::AudioCallback::audioDeviceAboutToStart(AudioIODevice* const dev
     this->numInputChans = numChansIn;
     this->numOutputChans = numChansOut;
 
-    this->messageCollector.reset(sampleRate);
+    this->eventQueue.prepare(newSampleRate);
+    this->incomingMidi.ensureSize(MIDI_EVENT_QUEUE_SIZE * MIDI_EVENT_QUEUE_MAX_MESSAGE_SIZE);
     this->channels.calloc(jmax(numChansIn, numChansOut) + 2);
+    this->levelMeter.prepare(newSampleRate);
+    this->loadMeter.prepare(newSampleRate);
+    this->resetSleepState();
 
     if (this->processor != nullptr)
     {
@@ -822,9 +940,55 @@ void Instrument::AudioCallback::audioDeviceStopped()
     this->blockSize = 0;
     this->isPrepared = false;
     this->tempBuffer.setSize(1, 1);
+    this->resetSleepState();
 }
 
 void Instrument::AudioCallback::handleIncomingMidiMessage(MidiInput *, const MidiMessage &message)
 {
-    this->messageCollector.addMessageToQueue(message);
+    this->eventQueue.push(message);
+}
+
+void Instrument::AudioCallback::updateHeldNotes(const MidiBuffer &midiMessages)
+{
+    MidiBuffer::Iterator it(midiMessages);
+    MidiMessage message;
+    int samplePosition;
+
+    while (it.getNextEvent(message, samplePosition))
+    {
+        if (message.isNoteOn())
+        {
+            ++this->numHeldNotes;
+        }
+        else if (message.isNoteOff())
+        {
+            this->numHeldNotes = jmax(0, this->numHeldNotes - 1);
+        }
+        else if (message.isAllNotesOff() || message.isAllSoundOff())
+        {
+            this->numHeldNotes = 0;
+        }
+    }
+}
+
+void Instrument::AudioCallback::updateSleepState(const AudioBuffer<float> &output)
+{
+    if (this->numHeldNotes > 0 || !this->incomingMidi.isEmpty() ||
+        output.getMagnitude(0, output.getNumSamples()) > INSTRUMENT_SLEEP_SILENCE_THRESHOLD)
+    {
+        this->numSilentBlocks = 0;
+        return;
+    }
+
+    if (++this->numSilentBlocks >= INSTRUMENT_SLEEP_SILENT_BLOCKS)
+    {
+        this->sleeping = 1;
+    }
+}
+
+void Instrument::AudioCallback::resetSleepState()
+{
+    this->numHeldNotes = 0;
+    this->numSilentBlocks = 0;
+    this->sleeping = 0;
 }
@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include "LevelMeter.h"
+#include "LoadMeter.h"
+#include "MidiEventQueue.h"
+#include "Profiler.h"
+
 class AudioCore;
 class FilterInGraph;
 class Instrument;
@@ -37,6 +42,12 @@ public:
     String getIdAndHash() const;
     bool isValid() const noexcept;
 
+    // Deserialized instruments don't create their plugins until first used,
+    // i.e. linked to a track of a loaded project, or shown in the editor;
+    // plugins are then created asynchronously, this is true when all are done
+    bool isInstantiated() const noexcept;
+    void instantiateIfNeeded();
+
     using InitializationCallback = Function<void(Instrument *)>;
     using AddNodeCallback = Function<void(AudioProcessorGraph::Node::Ptr)>;
 
@@ -50,15 +61,32 @@ public:
         AudioCallback() = default;
 
         void setProcessor(AudioProcessor *processor);
-        MidiMessageCollector &getMidiMessageCollector() noexcept { return messageCollector; }
+        MidiEventQueue &getMidiEventQueue() noexcept { return this->eventQueue; }
 
         void audioDeviceIOCallback(const float **, int, float **, int, int) override;
         void audioDeviceAboutToStart(AudioIODevice *) override;
         void audioDeviceStopped() override;
         void handleIncomingMidiMessage(MidiInput *, const MidiMessage&) override;
 
+        // An idle graph, with no notes held and a silent output for a while,
+        // is not processed at all, until new midi messages arrive
+        bool isSleeping() const noexcept { return this->sleeping.get() != 0; }
+
+        // Output levels, safe to poll from any thread
+        const LevelMeter &getLevelMeter() const noexcept { return this->levelMeter; }
+
+        // Processing time relative to the block duration, including the midi queue
+        LoadMeter &getLoadMeter() noexcept { return this->loadMeter; }
+
+        // The instrument name, copied for the profiler events
+        void setProfilerLabel(const String &name) noexcept { this->profilerLabel.set(name); }
+
     private:
 
+        void updateHeldNotes(const MidiBuffer &midiMessages);
+        void updateSleepState(const AudioBuffer<float> &output);
+        void resetSleepState();
+
         AudioProcessor *processor = nullptr;
         CriticalSection lock;
         double sampleRate = 0;
@@ -71,7 +99,15 @@ public:
         AudioBuffer<float> tempBuffer;
 
         MidiBuffer incomingMidi;
-        MidiMessageCollector messageCollector;
+        MidiEventQueue eventQueue;
+
+        int numHeldNotes = 0;
+        int numSilentBlocks = 0;
+        Atomic<int> sleeping;
+
+        LevelMeter levelMeter;
+        LoadMeter loadMeter;
+        Profiler::Label profilerLabel;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCallback)
     };
@@ -161,6 +197,10 @@ private:
     Instrument::AudioCallback audioCallback;
     ScopedPointer<AudioProcessorGraph> processorGraph;
 
+    // Serialized nodes and connections, kept until instantiated
+    ValueTree pendingState;
+    int numNodesLoading = 0;
+
     ValueTree serializeNode(AudioProcessorGraph::Node::Ptr node) const;
     void deserializeNode(const ValueTree &tree);
     void deserializeNodeAsync(const ValueTree &tree, AddNodeCallback f);
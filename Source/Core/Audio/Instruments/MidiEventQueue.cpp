@@ -0,0 +1,167 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Common.h"
+#include "MidiEventQueue.h"
+
+static_assert((MIDI_EVENT_QUEUE_SIZE & (MIDI_EVENT_QUEUE_SIZE - 1)) == 0,
+    "Midi event queue size should be a power of two");
+
+#define MIDI_EVENT_QUEUE_MASK (MIDI_EVENT_QUEUE_SIZE - 1)
+#define MIDI_EVENT_QUEUE_DEFAULT_SAMPLERATE 44100.0
+
+// Each slot's sequence number tells whose turn it is: when it equals
+// the enqueue position, the slot is free to be written by the producer
+// that manages to claim that position; when it equals position + 1,
+// the slot is filled and ready to be read by the consumer.
+
+MidiEventQueue::MidiEventQueue() :
+    enqueuePosition(0),
+    dequeuePosition(0),
+    sampleRate(MIDI_EVENT_QUEUE_DEFAULT_SAMPLERATE),
+    hasOverflow(0)
+{
+    for (uint32 i = 0; i < MIDI_EVENT_QUEUE_SIZE; ++i)
+    {
+        this->events[i].sequence = i;
+        this->events[i].timeStamp = 0.0;
+        this->events[i].size = 0;
+    }
+
+    this->overflow.ensureStorageAllocated(MIDI_EVENT_QUEUE_OVERFLOW_SIZE);
+}
+
+void MidiEventQueue::push(const MidiMessage &message)
+{
+    if (message.getRawDataSize() <= 0)
+    {
+        return;
+    }
+
+    if (!this->tryPush(message))
+    {
+        this->pushOverflow(message);
+    }
+}
+
+bool MidiEventQueue::tryPush(const MidiMessage &message) noexcept
+{
+    const int size = message.getRawDataSize();
+    if (size > MIDI_EVENT_QUEUE_MAX_MESSAGE_SIZE)
+    {
+        return false;
+    }
+
+    uint32 position = this->enqueuePosition.get();
+    Event *event = nullptr;
+
+    for (;;)
+    {
+        event = &this->events[position & MIDI_EVENT_QUEUE_MASK];
+        const int32 difference = int32(event->sequence.get() - position);
+
+        if (difference == 0)
+        {
+            if (this->enqueuePosition.compareAndSetBool(position + 1, position))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false; // the consumer is too far behind
+        }
+
+        position = this->enqueuePosition.get();
+    }
+
+    event->timeStamp = message.getTimeStamp();
+    event->size = size;
+    memcpy(event->data, message.getRawData(), size_t(size));
+    event->sequence = position + 1;
+    return true;
+}
+
+void MidiEventQueue::pushOverflow(const MidiMessage &message)
+{
+    const SpinLock::ScopedLockType lock(this->overflowLock);
+    this->overflow.add(message);
+    this->hasOverflow = 1;
+}
+
+void MidiEventQueue::popOverflow(MidiBuffer &destination,
+    double blockStartTime, int lastSample) noexcept
+{
+    if (this->hasOverflow.get() == 0)
+    {
+        return;
+    }
+
+    const SpinLock::ScopedTryLockType lock(this->overflowLock);
+    if (!lock.isLocked())
+    {
+        return; // a producer is adding more, will try in the next block
+    }
+
+    for (const auto &message : this->overflow)
+    {
+        const int samplePosition = jlimit(0, lastSample,
+            roundToInt((message.getTimeStamp() - blockStartTime) * this->sampleRate));
+
+        destination.addEvent(message, samplePosition);
+    }
+
+    this->overflow.clearQuick();
+    this->hasOverflow = 0;
+}
+
+void MidiEventQueue::prepare(double newSampleRate) noexcept
+{
+    this->sampleRate = (newSampleRate > 0.0) ? newSampleRate : MIDI_EVENT_QUEUE_DEFAULT_SAMPLERATE;
+}
+
+void MidiEventQueue::popAll(MidiBuffer &destination, int numSamples) noexcept
+{
+    // The events were sent in real time, so the block is assumed
+    // to end right now, and each event is placed where it would be
+    // in the block, if the block had started playing numSamples ago
+    const double timeNow = Time::getMillisecondCounterHiRes() * 0.001;
+    const double blockStartTime = timeNow - numSamples / this->sampleRate;
+    const int lastSample = jmax(0, numSamples - 1);
+
+    this->popOverflow(destination, blockStartTime, lastSample);
+
+    for (;;)
+    {
+        Event &event = this->events[this->dequeuePosition & MIDI_EVENT_QUEUE_MASK];
+        const int32 difference = int32(event.sequence.get() - (this->dequeuePosition + 1));
+
+        if (difference < 0)
+        {
+            return; // nothing more is ready
+        }
+
+        const int samplePosition = jlimit(0, lastSample,
+            roundToInt((event.timeStamp - blockStartTime) * this->sampleRate));
+
+        destination.addEvent(event.data, event.size, samplePosition);
+
+        event.sequence = this->dequeuePosition + MIDI_EVENT_QUEUE_SIZE;
+        ++this->dequeuePosition;
+    }
+}
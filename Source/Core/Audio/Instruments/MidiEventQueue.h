@@ -0,0 +1,74 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#define MIDI_EVENT_QUEUE_SIZE 1024
+#define MIDI_EVENT_QUEUE_MAX_MESSAGE_SIZE 16
+#define MIDI_EVENT_QUEUE_OVERFLOW_SIZE 256
+
+// A preallocated bounded queue of midi events for a single instrument:
+// any number of threads (the player, the UI, midi inputs) may push into it
+// without locking or allocating, and the audio callback is the only consumer,
+// which drains it into the block's midi buffer by sample position.
+// Events are timestamped in seconds of Time::getMillisecondCounterHiRes().
+// Messages that don't fit a slot (sysex), or arrive when the queue is full,
+// go to a locked overflow list instead, so that nothing is ever dropped;
+// the audio thread only try-locks it, and picks them up in a later block
+// if a producer happens to hold the lock.
+
+class MidiEventQueue final
+{
+public:
+
+    MidiEventQueue();
+
+    // Any thread; takes the slow path if the queue is full or the message is too long
+    void push(const MidiMessage &message);
+
+    // Audio thread only
+    void prepare(double sampleRate) noexcept;
+    void popAll(MidiBuffer &destination, int numSamples) noexcept;
+
+private:
+
+    bool tryPush(const MidiMessage &message) noexcept;
+    void pushOverflow(const MidiMessage &message);
+    void popOverflow(MidiBuffer &destination, double blockStartTime, int lastSample) noexcept;
+
+    struct Event final
+    {
+        Atomic<uint32> sequence;
+        double timeStamp;
+        int size;
+        uint8 data[MIDI_EVENT_QUEUE_MAX_MESSAGE_SIZE];
+    };
+
+    Event events[MIDI_EVENT_QUEUE_SIZE];
+
+    Atomic<uint32> enqueuePosition;
+    uint32 dequeuePosition;
+
+    double sampleRate;
+
+    SpinLock overflowLock;
+    Array<MidiMessage> overflow;
+    Atomic<int> hasOverflow;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiEventQueue)
+};
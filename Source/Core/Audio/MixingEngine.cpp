@@ -0,0 +1,410 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "MixingEngine.h"
+
+#if JUCE_WINDOWS
+#   include <windows.h>
+#elif JUCE_MAC || JUCE_IOS
+#   include <dispatch/dispatch.h>
+#else
+#   include <semaphore.h>
+#   include <errno.h>
+#endif
+
+// Any index past this one means there's no block to work on
+#define MIXING_ENGINE_IDLE_INDEX (INT_MAX / 2)
+
+// How many times the audio thread checks for the workers to finish
+// before it starts giving up its time slice between the checks
+#define MIXING_ENGINE_MAX_SPINS 2048
+
+// Same as the audio device thread
+#define MIXING_ENGINE_WORKER_PRIORITY 10
+
+//===----------------------------------------------------------------------===//
+// WakeUpSignal
+//===----------------------------------------------------------------------===//
+
+// Unlike WaitableEvent::signal(), which locks a mutex, posting
+// an OS semaphore is safe to do from the audio thread
+class WakeUpSignal final
+{
+public:
+
+#if JUCE_WINDOWS
+
+    WakeUpSignal() : semaphore(CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr)) {}
+    ~WakeUpSignal() { CloseHandle(this->semaphore); }
+    void post() noexcept { ReleaseSemaphore(this->semaphore, 1, nullptr); }
+    void wait() noexcept { WaitForSingleObject(this->semaphore, INFINITE); }
+
+private:
+
+    HANDLE semaphore;
+
+#elif JUCE_MAC || JUCE_IOS
+
+    WakeUpSignal() : semaphore(dispatch_semaphore_create(0)) {}
+    ~WakeUpSignal() { dispatch_release(this->semaphore); }
+    void post() noexcept { dispatch_semaphore_signal(this->semaphore); }
+    void wait() noexcept { dispatch_semaphore_wait(this->semaphore, DISPATCH_TIME_FOREVER); }
+
+private:
+
+    dispatch_semaphore_t semaphore;
+
+#else
+
+    WakeUpSignal() { sem_init(&this->semaphore, 0, 0); }
+    ~WakeUpSignal() { sem_destroy(&this->semaphore); }
+    void post() noexcept { sem_post(&this->semaphore); }
+    void wait() noexcept { while (sem_wait(&this->semaphore) != 0 && errno == EINTR) {} }
+
+private:
+
+    sem_t semaphore;
+
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE(WakeUpSignal)
+};
+
+//===----------------------------------------------------------------------===//
+// Worker
+//===----------------------------------------------------------------------===//
+
+class MixingEngine::Worker final : public Thread
+{
+public:
+
+    explicit Worker(MixingEngine &engine) :
+        Thread("Mixing Worker"),
+        engine(engine) {}
+
+    ~Worker() override
+    {
+        this->signalThreadShouldExit();
+        this->wakeUp();
+        this->stopThread(1000);
+    }
+
+    inline void wakeUp() noexcept
+    {
+        this->wakeUpSignal.post();
+    }
+
+    void run() override
+    {
+        while (!this->threadShouldExit())
+        {
+            this->wakeUpSignal.wait();
+
+            if (this->threadShouldExit())
+            {
+                return;
+            }
+
+            this->engine.processPendingJobs();
+        }
+    }
+
+private:
+
+    MixingEngine &engine;
+    WakeUpSignal wakeUpSignal;
+
+};
+
+//===----------------------------------------------------------------------===//
+// MixingEngine
+//===----------------------------------------------------------------------===//
+
+MixingEngine::MixingEngine() :
+    currentSchedule(nullptr),
+    scheduleInUse(nullptr),
+    blockSchedule(nullptr),
+    blockInputs(nullptr),
+    blockNumInputs(0),
+    blockNumOutputs(0),
+    blockNumSamples(0),
+    blockNumJobs(0),
+    nextJob(MIXING_ENGINE_IDLE_INDEX),
+    numJobsDone(0),
+    currentDevice(nullptr),
+    numOutputChannels(0),
+    bufferSize(0)
+{
+    const int numWorkers = jmax(0, SystemStats::getNumCpus() - 1);
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto *worker = this->workers.add(new Worker(*this));
+        worker->startThread(MIXING_ENGINE_WORKER_PRIORITY);
+    }
+}
+
+MixingEngine::~MixingEngine()
+{
+    this->workers.clear();
+    delete this->currentSchedule.exchange(nullptr);
+}
+
+int MixingEngine::getNumWorkers() const noexcept
+{
+    return this->workers.size();
+}
+
+LoadMeter &MixingEngine::getLoadMeter() noexcept
+{
+    return this->loadMeter;
+}
+
+void MixingEngine::addAudioCallback(AudioIODeviceCallback *callback)
+{
+    const ScopedLock sl(this->scheduleLock);
+
+    ScopedPointer<Schedule> newSchedule(new Schedule());
+
+    if (const auto *schedule = this->currentSchedule.get())
+    {
+        for (const auto *job : schedule->jobs)
+        {
+            if (job->callback == callback)
+            {
+                return;
+            }
+
+            this->prepareJob(*newSchedule->jobs.add(new Job(job->callback)));
+        }
+    }
+
+    this->prepareJob(*newSchedule->jobs.add(new Job(callback)));
+
+    // the callback has to be ready to play before the audio thread sees it
+    if (this->currentDevice != nullptr)
+    {
+        callback->audioDeviceAboutToStart(this->currentDevice);
+    }
+
+    this->publishSchedule(newSchedule.release());
+}
+
+void MixingEngine::removeAudioCallback(AudioIODeviceCallback *callback)
+{
+    const ScopedLock sl(this->scheduleLock);
+
+    const auto *schedule = this->currentSchedule.get();
+    if (schedule == nullptr)
+    {
+        return;
+    }
+
+    ScopedPointer<Schedule> newSchedule(new Schedule());
+    bool wasFound = false;
+
+    for (const auto *job : schedule->jobs)
+    {
+        if (job->callback == callback)
+        {
+            wasFound = true;
+            continue;
+        }
+
+        this->prepareJob(*newSchedule->jobs.add(new Job(job->callback)));
+    }
+
+    if (!wasFound)
+    {
+        return;
+    }
+
+    this->publishSchedule(newSchedule.release());
+
+    // at this point the audio thread no longer references the callback
+    if (this->currentDevice != nullptr)
+    {
+        callback->audioDeviceStopped();
+    }
+}
+
+void MixingEngine::prepareJob(Job &job) const
+{
+    job.buffer.setSize(jmax(1, this->numOutputChannels), jmax(1, this->bufferSize));
+}
+
+void MixingEngine::publishSchedule(Schedule *newSchedule)
+{
+    Schedule *oldSchedule = this->currentSchedule.exchange(newSchedule);
+
+    if (oldSchedule != nullptr)
+    {
+        // the audio thread holds a schedule for one block at most
+        while (this->scheduleInUse.get() == oldSchedule)
+        {
+            Thread::yield();
+        }
+
+        delete oldSchedule;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Jobs
+//===----------------------------------------------------------------------===//
+
+void MixingEngine::processPendingJobs()
+{
+    for (;;)
+    {
+        const int jobIndex = (++this->nextJob) - 1;
+
+        if (jobIndex >= this->blockNumJobs)
+        {
+            return;
+        }
+
+        auto *job = this->blockSchedule->jobs.getUnchecked(jobIndex);
+
+        // only grows when the device delivers a larger block than it has promised
+        job->buffer.setSize(jmax(1, this->blockNumOutputs), this->blockNumSamples, false, false, true);
+
+        job->callback->audioDeviceIOCallback(this->blockInputs, this->blockNumInputs,
+            job->buffer.getArrayOfWritePointers(), this->blockNumOutputs, this->blockNumSamples);
+
+        ++this->numJobsDone;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// AudioIODeviceCallback
+//===----------------------------------------------------------------------===//
+
+void MixingEngine::audioDeviceIOCallback(const float **inputChannelData, int numInputChannels,
+    float **outputChannelData, int numOutputChannels, int numSamples)
+{
+    const LoadMeter::ScopedCallback loadMeasurement(this->loadMeter, numSamples);
+
+    // pin the schedule so that the message thread won't delete it under our feet:
+    Schedule *schedule = nullptr;
+
+    do
+    {
+        schedule = this->currentSchedule.get();
+        this->scheduleInUse.set(schedule);
+    }
+    while (schedule != this->currentSchedule.get());
+
+    for (int i = 0; i < numOutputChannels; ++i)
+    {
+        if (outputChannelData[i] != nullptr)
+        {
+            FloatVectorOperations::clear(outputChannelData[i], numSamples);
+        }
+    }
+
+    if (schedule == nullptr || schedule->jobs.isEmpty())
+    {
+        this->scheduleInUse.set(nullptr);
+        return;
+    }
+
+    const int numJobs = schedule->jobs.size();
+
+    this->blockSchedule = schedule;
+    this->blockInputs = inputChannelData;
+    this->blockNumInputs = numInputChannels;
+    this->blockNumOutputs = numOutputChannels;
+    this->blockNumSamples = numSamples;
+    this->blockNumJobs = numJobs;
+    this->numJobsDone.set(0);
+    this->nextJob.set(0);
+
+    // the audio thread takes jobs as well, so wake up one worker less
+    const int numWorkersToWake = jmin(numJobs - 1, this->workers.size());
+    for (int i = 0; i < numWorkersToWake; ++i)
+    {
+        this->workers.getUnchecked(i)->wakeUp();
+    }
+
+    // once this returns, all jobs are taken, and the only thing
+    // left to wait for is the ones still rendered by the workers
+    this->processPendingJobs();
+
+    for (int numSpins = 0; this->numJobsDone.get() < numJobs; ++numSpins)
+    {
+        if (numSpins >= MIXING_ENGINE_MAX_SPINS)
+        {
+            Thread::yield();
+        }
+    }
+
+    this->nextJob.set(MIXING_ENGINE_IDLE_INDEX);
+
+    // sum up in the schedule order, so that the result
+    // doesn't depend on which thread has finished first
+    for (const auto *job : schedule->jobs)
+    {
+        for (int i = 0; i < numOutputChannels; ++i)
+        {
+            if (outputChannelData[i] != nullptr)
+            {
+                FloatVectorOperations::add(outputChannelData[i],
+                    job->buffer.getReadPointer(i), numSamples);
+            }
+        }
+    }
+
+    this->scheduleInUse.set(nullptr);
+}
+
+void MixingEngine::audioDeviceAboutToStart(AudioIODevice *device)
+{
+    const ScopedLock sl(this->scheduleLock);
+
+    this->currentDevice = device;
+    this->numOutputChannels = device->getActiveOutputChannels().countNumberOfSetBits();
+    this->bufferSize = device->getCurrentBufferSizeSamples();
+    this->loadMeter.prepare(device->getCurrentSampleRate());
+
+    // the device doesn't call us back while restarting,
+    // so the current schedule can be updated in place
+    if (auto *schedule = this->currentSchedule.get())
+    {
+        for (auto *job : schedule->jobs)
+        {
+            this->prepareJob(*job);
+            job->callback->audioDeviceAboutToStart(device);
+        }
+    }
+}
+
+void MixingEngine::audioDeviceStopped()
+{
+    const ScopedLock sl(this->scheduleLock);
+
+    if (auto *schedule = this->currentSchedule.get())
+    {
+        for (auto *job : schedule->jobs)
+        {
+            job->callback->audioDeviceStopped();
+        }
+    }
+
+    this->currentDevice = nullptr;
+}
@@ -0,0 +1,105 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "LoadMeter.h"
+
+// Owns the single device callback through which all instruments are rendered:
+// each audio block, independent instrument graphs are processed in parallel
+// by a pool of real-time workers (and the audio thread itself), then summed
+// into the device output in a fixed order, so the mix is deterministic.
+
+class MixingEngine final : public AudioIODeviceCallback
+{
+public:
+
+    MixingEngine();
+    ~MixingEngine() override;
+
+    // Both are called from the message thread;
+    // they never block the audio thread, but wait for it
+    // to release the previous schedule before deleting it.
+    // Callbacks are instruments' players, or anything else
+    // that renders independently, like frozen tracks playback
+    void addAudioCallback(AudioIODeviceCallback *callback);
+    void removeAudioCallback(AudioIODeviceCallback *callback);
+
+    int getNumWorkers() const noexcept;
+
+    // The whole callback, i.e. all instruments, including the waiting
+    // for the workers, and the mixdown; also counts the dropouts
+    LoadMeter &getLoadMeter() noexcept;
+
+    //===------------------------------------------------------------------===//
+    // AudioIODeviceCallback
+    //===------------------------------------------------------------------===//
+
+    void audioDeviceIOCallback(const float **inputChannelData, int numInputChannels,
+        float **outputChannelData, int numOutputChannels, int numSamples) override;
+    void audioDeviceAboutToStart(AudioIODevice *device) override;
+    void audioDeviceStopped() override;
+
+private:
+
+    struct Job final
+    {
+        Job(AudioIODeviceCallback *callback) : callback(callback) {}
+        AudioIODeviceCallback *callback;
+        AudioBuffer<float> buffer;
+    };
+
+    // An immutable list of jobs, replaced as a whole whenever
+    // instruments are added or removed
+    struct Schedule final
+    {
+        OwnedArray<Job> jobs;
+    };
+
+    class Worker;
+    friend class Worker;
+
+    void processPendingJobs();
+    void prepareJob(Job &job) const;
+    void publishSchedule(Schedule *newSchedule);
+
+    Atomic<Schedule *> currentSchedule;
+    Atomic<Schedule *> scheduleInUse;
+
+    // Current block, written by the audio thread before jobs are released
+    Schedule *blockSchedule;
+    const float **blockInputs;
+    int blockNumInputs;
+    int blockNumOutputs;
+    int blockNumSamples;
+    int blockNumJobs;
+
+    Atomic<int> nextJob;
+    Atomic<int> numJobsDone;
+
+    OwnedArray<Worker> workers;
+
+    LoadMeter loadMeter;
+
+    // Guards device state and schedule changes, never taken by the audio thread
+    CriticalSection scheduleLock;
+    AudioIODevice *currentDevice;
+    int numOutputChannels;
+    int bufferSize;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixingEngine)
+};
@@ -19,60 +19,31 @@
 #include "AudioMonitor.h"
 #include "AudioCore.h"
 
-#define AUDIO_MONITOR_SPECTRUM_SIZE                 512
 #define AUDIO_MONITOR_DEFAULT_SAMPLERATE            44100
 #define AUDIO_MONITOR_CLIP_THRESHOLD                0.995f
 #define AUDIO_MONITOR_OVERSATURATION_THRESHOLD      0.5f
 #define AUDIO_MONITOR_OVERSATURATION_RATE           4.f
+#define AUDIO_MONITOR_VOLUME_WINDOW_SIZE            1024
+#define AUDIO_MONITOR_CLIPPING_CHECK_BLOCK_SIZE     512
+#define AUDIO_MONITOR_CLIPPING_CHECK_RATE_HZ        20
+#define AUDIO_MONITOR_CLIPPING_CHECKS_PER_RING      4
 
-class ClippingWarningAsyncCallback final  : public AsyncUpdater
-{
-public:
-    
-    explicit ClippingWarningAsyncCallback(AudioMonitor &parentSpectrumCallback) :
-        audioMonitor(parentSpectrumCallback) {}
-    
-    void handleAsyncUpdate() override
-    {
-        this->audioMonitor.getListeners().
-            call(&AudioMonitor::ClippingListener::onClippingWarning);
-    }
-
-private:
-    
-    AudioMonitor &audioMonitor;
-    
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClippingWarningAsyncCallback)
-};
-
-class OversaturationWarningAsyncCallback final : public AsyncUpdater
-{
-public:
-    
-    explicit OversaturationWarningAsyncCallback(AudioMonitor &parentSpectrumCallback) :
-        audioMonitor(parentSpectrumCallback) {}
-    
-    void handleAsyncUpdate() override
-    {
-        this->audioMonitor.getListeners().
-            call(&AudioMonitor::ClippingListener::onOversaturationWarning);
-    }
-    
-private:
-    
-    AudioMonitor &audioMonitor;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OversaturationWarningAsyncCallback)
-};
+static_assert((AUDIO_MONITOR_MIN_RING_BUFFER_SIZE & (AUDIO_MONITOR_MIN_RING_BUFFER_SIZE - 1)) == 0,
+    "Ring buffer size should be a power of two");
+static_assert(SPECTRUM_FFT_SIZE <= AUDIO_MONITOR_MIN_RING_BUFFER_SIZE / 2,
+    "Ring buffer is too small for the spectrum window");
 
 AudioMonitor::AudioMonitor() :
     fft(),
-    spectrumSize(AUDIO_MONITOR_SPECTRUM_SIZE),
+    ringBufferSize(0),
+    ringBufferMask(0),
+    lastCheckedPosition(0),
+    spectrumSize(AUDIO_MONITOR_MAX_SPECTRUMSIZE),
     sampleRate(AUDIO_MONITOR_DEFAULT_SAMPLERATE)
 {
-    zeromem(this->spectrum, sizeof(float) * AUDIO_MONITOR_MAX_CHANNELS * AUDIO_MONITOR_MAX_SPECTRUMSIZE);
-    this->asyncClippingWarning = new ClippingWarningAsyncCallback(*this);
-    this->asyncOversaturationWarning = new OversaturationWarningAsyncCallback(*this);
+    zeromem(this->spectrum, sizeof(this->spectrum));
+    this->resizeRingBuffer(AUDIO_MONITOR_DEFAULT_SAMPLERATE);
+    this->startTimerHz(AUDIO_MONITOR_CLIPPING_CHECK_RATE_HZ);
 }
 
 //===----------------------------------------------------------------------===//
@@ -82,6 +53,8 @@ AudioMonitor::AudioMonitor() :
 void AudioMonitor::audioDeviceAboutToStart(AudioIODevice *device)
 {
     this->sampleRate = device->getCurrentSampleRate();
+    this->resizeRingBuffer(device->getCurrentSampleRate());
+    this->loadMeter.prepare(device->getCurrentSampleRate());
 }
 
 void AudioMonitor::audioDeviceIOCallback(const float **inputChannelData,
@@ -90,67 +63,173 @@ void AudioMonitor::audioDeviceIOCallback(const float **inputChannelData,
                                          int numOutputChannels,
                                          int numSamples)
 {
+    const LoadMeter::ScopedCallback loadMeasurement(this->loadMeter, numSamples);
     const int numChannels = jmin(AUDIO_MONITOR_MAX_CHANNELS, numOutputChannels);
-    
+
+    // only the most recent samples are ever analyzed,
+    // so a huge block is truncated to what fits the ring
+    const int numSamplesToCopy = jmin(numSamples, this->ringBufferSize);
+    const int sourceOffset = numSamples - numSamplesToCopy;
+    const int position = this->writePosition.get();
+    const int numBeforeWrap = jmin(numSamplesToCopy, this->ringBufferSize - position);
+    const int numAfterWrap = numSamplesToCopy - numBeforeWrap;
+
     for (int channel = 0; channel < numChannels; ++channel)
     {
-        this->fft.computeSpectrum(outputChannelData[channel], 0, numSamples,
-                                  this->spectrum[channel], this->spectrumSize.get(),
-                                  channel, numOutputChannels);
+        const float *source = outputChannelData[channel] + sourceOffset;
+        float *ring = this->ringBuffer[channel];
+        memcpy(ring + position, source, sizeof(float) * numBeforeWrap);
+        memcpy(ring, source + numBeforeWrap, sizeof(float) * numAfterWrap);
     }
-    
-    for (int channel = 0; channel < numChannels; ++channel)
+
+    this->writePosition = (position + numSamplesToCopy) & this->ringBufferMask;
+
+    for (int i = 0; i < numOutputChannels; ++i)
     {
-        float pcmSquaresSum = 0.f;
-        float pcmPeak = 0.f;
-        for (int samplePosition = 0; samplePosition < numSamples; ++samplePosition)
-        {
-            const float &pcmData = outputChannelData[channel][samplePosition];
-            pcmSquaresSum += (pcmData * pcmData);
-            pcmPeak = jmax(pcmPeak, pcmData);
-        }
-        
-        const float rootMeanSquare = sqrtf(pcmSquaresSum / numSamples);
-        this->rms[channel] = rootMeanSquare;
-        this->peak[channel] = pcmPeak;
-        
-        if (pcmPeak > AUDIO_MONITOR_CLIP_THRESHOLD)
+        FloatVectorOperations::clear(outputChannelData[i], numSamples);
+    }
+}
+
+void AudioMonitor::audioDeviceStopped() {}
+
+//===----------------------------------------------------------------------===//
+// Ring buffer
+//===----------------------------------------------------------------------===//
+
+void AudioMonitor::resizeRingBuffer(double newSampleRate)
+{
+    // the clipping check only sees what was played since its previous call,
+    // so the ring has to outlast a few timer periods at this sample rate
+    const int samplesPerCheck = int(newSampleRate / AUDIO_MONITOR_CLIPPING_CHECK_RATE_HZ);
+    const int newSize = nextPowerOfTwo(jmax(AUDIO_MONITOR_MIN_RING_BUFFER_SIZE,
+        samplesPerCheck * AUDIO_MONITOR_CLIPPING_CHECKS_PER_RING));
+
+    const ScopedLock lock(this->ringLock);
+
+    if (newSize != this->ringBufferSize)
+    {
+        for (auto &ring : this->ringBuffer)
         {
-            this->asyncClippingWarning->triggerAsyncUpdate();
+            ring.allocate(newSize, true);
         }
-        
-        if (pcmPeak > AUDIO_MONITOR_OVERSATURATION_THRESHOLD &&
-            (pcmPeak / rootMeanSquare) > AUDIO_MONITOR_OVERSATURATION_RATE)
+
+        this->ringBufferSize = newSize;
+        this->ringBufferMask = newSize - 1;
+    }
+
+    this->writePosition = 0;
+    this->lastCheckedPosition = 0;
+}
+
+void AudioMonitor::readLatestSamples(int channel, float *destination, int numSamples) const
+{
+    const ScopedLock lock(this->ringLock);
+    jassert(numSamples <= this->ringBufferSize);
+    const int endPosition = this->writePosition.get();
+    const int startPosition = (endPosition - numSamples) & this->ringBufferMask;
+    const int numBeforeWrap = jmin(numSamples, this->ringBufferSize - startPosition);
+    const float *ring = this->ringBuffer[channel];
+    memcpy(destination, ring + startPosition, sizeof(float) * numBeforeWrap);
+    memcpy(destination + numBeforeWrap, ring, sizeof(float) * (numSamples - numBeforeWrap));
+}
+
+void AudioMonitor::timerCallback()
+{
+    const ScopedLock lock(this->ringLock);
+    const int endPosition = this->writePosition.get();
+    const int startPosition = this->lastCheckedPosition;
+    this->lastCheckedPosition = endPosition;
+
+    if (this->clippingListeners.size() == 0 || startPosition == endPosition)
+    {
+        return;
+    }
+
+    const int numNewSamples = (endPosition - startPosition) & this->ringBufferMask;
+
+    bool clipped = false;
+    bool oversaturated = false;
+
+    for (int channel = 0; channel < AUDIO_MONITOR_MAX_CHANNELS; ++channel)
+    {
+        const float *ring = this->ringBuffer[channel];
+        for (int offset = 0; offset < numNewSamples; offset += AUDIO_MONITOR_CLIPPING_CHECK_BLOCK_SIZE)
         {
-            this->asyncOversaturationWarning->triggerAsyncUpdate();
+            const int blockSize = jmin(AUDIO_MONITOR_CLIPPING_CHECK_BLOCK_SIZE, numNewSamples - offset);
+            const int blockStart = (startPosition + offset) & this->ringBufferMask;
+            const int numBeforeWrap = jmin(blockSize, this->ringBufferSize - blockStart);
+
+            float pcmSquaresSum = 0.f;
+            float pcmPeak = 0.f;
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float pcmData = (i < numBeforeWrap) ?
+                    ring[blockStart + i] : ring[i - numBeforeWrap];
+                pcmSquaresSum += (pcmData * pcmData);
+                pcmPeak = jmax(pcmPeak, fabsf(pcmData));
+            }
+
+            const float rootMeanSquare = sqrtf(pcmSquaresSum / blockSize);
+            clipped = clipped || (pcmPeak > AUDIO_MONITOR_CLIP_THRESHOLD);
+            oversaturated = oversaturated ||
+                (pcmPeak > AUDIO_MONITOR_OVERSATURATION_THRESHOLD &&
+                (pcmPeak / rootMeanSquare) > AUDIO_MONITOR_OVERSATURATION_RATE);
         }
     }
 
-    for (int i = 0; i < numOutputChannels; ++i)
+    if (clipped)
     {
-        FloatVectorOperations::clear(outputChannelData[i], numSamples);
+        this->clippingListeners.call(&AudioMonitor::ClippingListener::onClippingWarning);
+    }
+
+    if (oversaturated)
+    {
+        this->clippingListeners.call(&AudioMonitor::ClippingListener::onOversaturationWarning);
     }
 }
 
-void AudioMonitor::audioDeviceStopped() {}
+//===----------------------------------------------------------------------===//
+// Load
+//===----------------------------------------------------------------------===//
+
+LoadMeter &AudioMonitor::getLoadMeter() noexcept
+{
+    return this->loadMeter;
+}
 
 //===----------------------------------------------------------------------===//
 // Spectrum data
 //===----------------------------------------------------------------------===//
 
+void AudioMonitor::updateSpectrum()
+{
+    const ScopedLock lock(this->spectrumLock);
+
+    for (int channel = 0; channel < AUDIO_MONITOR_MAX_CHANNELS; ++channel)
+    {
+        this->readLatestSamples(channel, this->fftInput, SPECTRUM_FFT_SIZE);
+        this->fft.computeSpectrum(this->fftInput, this->fftOutput);
+
+        for (int i = 0; i < AUDIO_MONITOR_MAX_SPECTRUMSIZE; ++i)
+        {
+            this->spectrum[channel][i] = this->fftOutput[i];
+        }
+    }
+}
+
 float AudioMonitor::getInterpolatedSpectrumAtFrequency(float frequency) const
 {
     const float resolution = 
         float(this->sampleRate.get() / 2.f) / float(this->spectrumSize.get());
     
     const int index1 = roundToInt(frequency / resolution);
-    const int safeIndex1 = jlimit(0, this->spectrumSize.get(), index1);
+    const int safeIndex1 = jlimit(0, this->spectrumSize.get() - 1, index1);
     const float f1 = index1 * resolution;
     const float y1 = (this->spectrum[0][safeIndex1].get() +
                       this->spectrum[1][safeIndex1].get()) / 2.f;
     
     const int index2 = index1 + 1;
-    const int safeIndex2 = jlimit(0, this->spectrumSize.get(), index2);
+    const int safeIndex2 = jlimit(0, this->spectrumSize.get() - 1, index2);
     const float f2 = index2 * resolution;
     const float y2 = (this->spectrum[0][safeIndex2].get() +
                       this->spectrum[1][safeIndex2].get()) / 2.f;
@@ -184,10 +263,23 @@ ListenerList<AudioMonitor::ClippingListener> &AudioMonitor::getListeners() noexc
 
 float AudioMonitor::getPeak(int channel) const
 {
-    return this->peak[channel].get();
+    float samples[AUDIO_MONITOR_VOLUME_WINDOW_SIZE];
+    this->readLatestSamples(channel, samples, AUDIO_MONITOR_VOLUME_WINDOW_SIZE);
+    const auto range = FloatVectorOperations::findMinAndMax(samples, AUDIO_MONITOR_VOLUME_WINDOW_SIZE);
+    return jmax(range.getEnd(), -range.getStart());
 }
 
 float AudioMonitor::getRootMeanSquare(int channel) const
 {
-    return this->rms[channel].get();
+    float samples[AUDIO_MONITOR_VOLUME_WINDOW_SIZE];
+    this->readLatestSamples(channel, samples, AUDIO_MONITOR_VOLUME_WINDOW_SIZE);
+    FloatVectorOperations::multiply(samples, samples, AUDIO_MONITOR_VOLUME_WINDOW_SIZE);
+
+    float pcmSquaresSum = 0.f;
+    for (int i = 0; i < AUDIO_MONITOR_VOLUME_WINDOW_SIZE; ++i)
+    {
+        pcmSquaresSum += samples[i];
+    }
+
+    return sqrtf(pcmSquaresSum / AUDIO_MONITOR_VOLUME_WINDOW_SIZE);
 }
@@ -18,11 +18,16 @@
 #pragma once
 
 #include "SpectrumAnalyzer.h"
+#include "LoadMeter.h"
 
 #define AUDIO_MONITOR_MAX_CHANNELS      2
-#define AUDIO_MONITOR_MAX_SPECTRUMSIZE  512
+#define AUDIO_MONITOR_MAX_SPECTRUMSIZE  (SPECTRUM_FFT_SIZE / 2)
+#define AUDIO_MONITOR_MIN_RING_BUFFER_SIZE  8192
 
-class AudioMonitor final : public AudioIODeviceCallback
+// The audio thread only copies the output into a ring buffer,
+// all the analysis is done by the threads asking for the data
+
+class AudioMonitor final : public AudioIODeviceCallback, private Timer
 {
 public:
     
@@ -60,30 +65,60 @@ public:
     // Volume data
     //===------------------------------------------------------------------===//
     
+    // Computed over the most recent samples on the caller's thread
     float getPeak(int channel) const;
     float getRootMeanSquare(int channel) const;
     
+    //===------------------------------------------------------------------===//
+    // Load
+    //===------------------------------------------------------------------===//
+
+    // The monitor's own share of the audio callback
+    LoadMeter &getLoadMeter() noexcept;
+
     //===------------------------------------------------------------------===//
     // Spectrum data
     //===------------------------------------------------------------------===//
     
+    // Runs the FFT over the most recent samples on the caller's thread,
+    // monitor components call this before querying the spectrum
+    void updateSpectrum();
     float getInterpolatedSpectrumAtFrequency(float frequency) const;
     
 private:
 
+    // Checks all samples played since the last call for clipping
+    void timerCallback() override;
+
+    void readLatestSamples(int channel, float *destination, int numSamples) const;
+
+    // Holds enough samples for a few clipping checks at the current sample rate
+    void resizeRingBuffer(double sampleRate);
+
+    // Written by the audio thread only; readers never block it,
+    // and the window they read is far behind the write position;
+    // the lock only keeps readers off the ring while it is reallocated
+    // between the device runs, so the audio thread never takes it
+    HeapBlock<float> ringBuffer[AUDIO_MONITOR_MAX_CHANNELS];
+    int ringBufferSize;
+    int ringBufferMask;
+    CriticalSection ringLock;
+    Atomic<int> writePosition;
+    int lastCheckedPosition;
+
+    CriticalSection spectrumLock;
     SpectrumFFT fft;
+    float fftInput[SPECTRUM_FFT_SIZE];
+    float fftOutput[AUDIO_MONITOR_MAX_SPECTRUMSIZE];
 
     Atomic<float> spectrum[AUDIO_MONITOR_MAX_CHANNELS][AUDIO_MONITOR_MAX_SPECTRUMSIZE];
-    Atomic<float> peak[AUDIO_MONITOR_MAX_CHANNELS];
-    Atomic<float> rms[AUDIO_MONITOR_MAX_CHANNELS];
 
     Atomic<int> spectrumSize;
     Atomic<double> sampleRate;
 
     ListenerList<ClippingListener> clippingListeners;
 
-    ScopedPointer<AsyncUpdater> asyncClippingWarning;
-    ScopedPointer<AsyncUpdater> asyncOversaturationWarning;
+    LoadMeter loadMeter;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioMonitor)
     JUCE_DECLARE_WEAK_REFERENCEABLE(AudioMonitor)
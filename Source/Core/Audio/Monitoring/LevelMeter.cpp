@@ -0,0 +1,192 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Common.h"
+#include "LevelMeter.h"
+#include "PolyphaseDecimator.h"
+
+#define LEVEL_METER_DEFAULT_SAMPLERATE 44100.0
+#define LEVEL_METER_PEAK_FALLOFF_DB_PER_SECOND 24.0
+#define LEVEL_METER_RMS_TIME_CONSTANT_SECONDS 0.3
+
+// A short filter, like the 12 taps per phase of ITU-R BS.1770 true-peak meter
+#define LEVEL_METER_KAISER_BETA 5.0
+
+LevelMeter::LevelMeter() :
+    sampleRate(LEVEL_METER_DEFAULT_SAMPLERATE)
+{
+    // the point at t lies between the middle taps, i.e. at (halfTaps - 1 + t)
+    const int halfTaps = LEVEL_METER_INTERPOLATION_TAPS / 2;
+
+    for (int phase = 0; phase < LEVEL_METER_TRUE_PEAK_PHASES; ++phase)
+    {
+        const double t = double(phase + 1) / double(LEVEL_METER_TRUE_PEAK_PHASES + 1);
+
+        double sum = 0.0;
+        double phaseCoefficients[LEVEL_METER_INTERPOLATION_TAPS];
+        for (int tap = 0; tap < LEVEL_METER_INTERPOLATION_TAPS; ++tap)
+        {
+            const double x = double(tap - (halfTaps - 1)) - t;
+            const double sinc = std::sin(MathConstants<double>::pi * x) / (MathConstants<double>::pi * x);
+            const double window = PolyphaseDecimator::getKaiserWindow(x / halfTaps, LEVEL_METER_KAISER_BETA);
+            phaseCoefficients[tap] = sinc * window;
+            sum += phaseCoefficients[tap];
+        }
+
+        // unity gain at DC
+        for (int tap = 0; tap < LEVEL_METER_INTERPOLATION_TAPS; ++tap)
+        {
+            this->coefficients[phase][tap] = float(phaseCoefficients[tap] / sum);
+        }
+    }
+
+    zeromem(this->history, sizeof(this->history));
+}
+
+//===----------------------------------------------------------------------===//
+// Audio thread
+//===----------------------------------------------------------------------===//
+
+void LevelMeter::prepare(double newSampleRate) noexcept
+{
+    this->sampleRate = (newSampleRate > 0.0) ? newSampleRate : LEVEL_METER_DEFAULT_SAMPLERATE;
+    zeromem(this->history, sizeof(this->history));
+
+    for (int channel = 0; channel < LEVEL_METER_MAX_CHANNELS; ++channel)
+    {
+        this->peak[channel] = 0.f;
+        this->truePeak[channel] = 0.f;
+        this->meanSquare[channel] = 0.f;
+    }
+}
+
+void LevelMeter::process(const float *const *channelData, int numChannels, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+    {
+        return;
+    }
+
+    const float peakFalloff = this->getPeakFalloff(numSamples);
+    const float rmsSmoothing = this->getRmsSmoothing(numSamples);
+    const int numMeteredChannels = jmin(numChannels, LEVEL_METER_MAX_CHANNELS);
+
+    for (int channel = 0; channel < numMeteredChannels; ++channel)
+    {
+        float blockPeak = 0.f;
+        float blockTruePeak = 0.f;
+        float squaresSum = 0.f;
+
+        for (int offset = 0; offset < numSamples; offset += LEVEL_METER_CHUNK_SIZE)
+        {
+            const int chunkSize = jmin(LEVEL_METER_CHUNK_SIZE, numSamples - offset);
+            const float *samples = channelData[channel] + offset;
+
+            const auto range = FloatVectorOperations::findMinAndMax(samples, chunkSize);
+            blockPeak = jmax(blockPeak, range.getEnd(), -range.getStart());
+
+            // interpolated[i] lies between line[i + 5] and line[i + 6]
+            memcpy(this->line, this->history[channel], sizeof(float) * LEVEL_METER_HISTORY_SIZE);
+            memcpy(this->line + LEVEL_METER_HISTORY_SIZE, samples, sizeof(float) * chunkSize);
+
+            for (int phase = 0; phase < LEVEL_METER_TRUE_PEAK_PHASES; ++phase)
+            {
+                const float *c = this->coefficients[phase];
+                FloatVectorOperations::multiply(this->interpolated, this->line, c[0], chunkSize);
+
+                for (int tap = 1; tap < LEVEL_METER_INTERPOLATION_TAPS; ++tap)
+                {
+                    FloatVectorOperations::addWithMultiply(this->interpolated, this->line + tap, c[tap], chunkSize);
+                }
+
+                const auto interpolatedRange = FloatVectorOperations::findMinAndMax(this->interpolated, chunkSize);
+                blockTruePeak = jmax(blockTruePeak, interpolatedRange.getEnd(), -interpolatedRange.getStart());
+            }
+
+            memcpy(this->history[channel], this->line + chunkSize, sizeof(float) * LEVEL_METER_HISTORY_SIZE);
+
+            FloatVectorOperations::multiply(this->interpolated, samples, samples, chunkSize);
+            for (int i = 0; i < chunkSize; ++i)
+            {
+                squaresSum += this->interpolated[i];
+            }
+        }
+
+        this->updateLevels(channel, blockPeak, jmax(blockPeak, blockTruePeak),
+            squaresSum / numSamples, peakFalloff, rmsSmoothing);
+    }
+
+    for (int channel = numMeteredChannels; channel < LEVEL_METER_MAX_CHANNELS; ++channel)
+    {
+        this->updateLevels(channel, 0.f, 0.f, 0.f, peakFalloff, rmsSmoothing);
+    }
+}
+
+void LevelMeter::processSilence(int numSamples) noexcept
+{
+    const float peakFalloff = this->getPeakFalloff(numSamples);
+    const float rmsSmoothing = this->getRmsSmoothing(numSamples);
+
+    zeromem(this->history, sizeof(this->history));
+
+    for (int channel = 0; channel < LEVEL_METER_MAX_CHANNELS; ++channel)
+    {
+        this->updateLevels(channel, 0.f, 0.f, 0.f, peakFalloff, rmsSmoothing);
+    }
+}
+
+void LevelMeter::updateLevels(int channel, float blockPeak, float blockTruePeak,
+    float blockMeanSquare, float peakFalloff, float rmsSmoothing) noexcept
+{
+    // the audio thread is the only writer, so no need for compare-and-swap here
+    this->peak[channel] = jmax(blockPeak, this->peak[channel].get() * peakFalloff);
+    this->truePeak[channel] = jmax(blockTruePeak, this->truePeak[channel].get() * peakFalloff);
+    this->meanSquare[channel] = blockMeanSquare +
+        (this->meanSquare[channel].get() - blockMeanSquare) * rmsSmoothing;
+}
+
+float LevelMeter::getPeakFalloff(int numSamples) const noexcept
+{
+    const double seconds = numSamples / this->sampleRate;
+    return float(std::pow(10.0, -LEVEL_METER_PEAK_FALLOFF_DB_PER_SECOND * seconds / 20.0));
+}
+
+float LevelMeter::getRmsSmoothing(int numSamples) const noexcept
+{
+    const double seconds = numSamples / this->sampleRate;
+    return float(std::exp(-seconds / LEVEL_METER_RMS_TIME_CONSTANT_SECONDS));
+}
+
+//===----------------------------------------------------------------------===//
+// Any thread
+//===----------------------------------------------------------------------===//
+
+float LevelMeter::getPeak(int channel) const noexcept
+{
+    return this->peak[jlimit(0, LEVEL_METER_MAX_CHANNELS - 1, channel)].get();
+}
+
+float LevelMeter::getRootMeanSquare(int channel) const noexcept
+{
+    return sqrtf(this->meanSquare[jlimit(0, LEVEL_METER_MAX_CHANNELS - 1, channel)].get());
+}
+
+float LevelMeter::getTruePeak(int channel) const noexcept
+{
+    return this->truePeak[jlimit(0, LEVEL_METER_MAX_CHANNELS - 1, channel)].get();
+}
@@ -0,0 +1,85 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#define LEVEL_METER_MAX_CHANNELS 2
+#define LEVEL_METER_CHUNK_SIZE 512
+#define LEVEL_METER_TRUE_PEAK_PHASES 3
+#define LEVEL_METER_INTERPOLATION_TAPS 12
+#define LEVEL_METER_HISTORY_SIZE (LEVEL_METER_INTERPOLATION_TAPS - 1)
+
+// Peak, RMS and true-peak levels of an audio stream:
+// updated by the audio thread with the vectorized float operations,
+// and published through atomics, so that any number of UI meters
+// could poll them at display rate without locking anything.
+// Peaks fall off and RMS is smoothed on the audio side,
+// so readers don't miss the short peaks between their polls.
+
+class LevelMeter final
+{
+public:
+
+    LevelMeter();
+
+    //===------------------------------------------------------------------===//
+    // Audio thread
+    //===------------------------------------------------------------------===//
+
+    void prepare(double sampleRate) noexcept;
+    void process(const float *const *channelData, int numChannels, int numSamples) noexcept;
+
+    // For the blocks that were not processed at all
+    void processSilence(int numSamples) noexcept;
+
+    //===------------------------------------------------------------------===//
+    // Any thread
+    //===------------------------------------------------------------------===//
+
+    float getPeak(int channel) const noexcept;
+    float getRootMeanSquare(int channel) const noexcept;
+
+    // The inter-sample peak estimated with 4x oversampling,
+    // i.e. the three points between each two samples
+    float getTruePeak(int channel) const noexcept;
+
+private:
+
+    void updateLevels(int channel, float blockPeak, float blockTruePeak,
+        float blockMeanSquare, float peakFalloff, float rmsSmoothing) noexcept;
+
+    float getPeakFalloff(int numSamples) const noexcept;
+    float getRmsSmoothing(int numSamples) const noexcept;
+
+    Atomic<float> peak[LEVEL_METER_MAX_CHANNELS];
+    Atomic<float> truePeak[LEVEL_METER_MAX_CHANNELS];
+    Atomic<float> meanSquare[LEVEL_METER_MAX_CHANNELS];
+
+    double sampleRate;
+
+    // Kaiser windowed sinc interpolator, one phase per point between the samples
+    float coefficients[LEVEL_METER_TRUE_PEAK_PHASES][LEVEL_METER_INTERPOLATION_TAPS];
+
+    // The last samples of the previous block, needed to interpolate across blocks,
+    // followed by the current chunk, so that all taps are read from one array
+    float history[LEVEL_METER_MAX_CHANNELS][LEVEL_METER_HISTORY_SIZE];
+    float line[LEVEL_METER_CHUNK_SIZE + LEVEL_METER_HISTORY_SIZE];
+    float interpolated[LEVEL_METER_CHUNK_SIZE];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeter);
+};
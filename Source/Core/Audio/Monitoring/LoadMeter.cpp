@@ -0,0 +1,212 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "LoadMeter.h"
+
+#define LOAD_METER_DEFAULT_SAMPLERATE 44100.0
+#define LOAD_METER_SMOOTHING_TIME_CONSTANT_SECONDS 0.5
+
+// How late the callbacks may get, relative to the block duration,
+// before the device is considered to have run out of data
+#define LOAD_METER_XRUN_LATENESS 0.5
+
+// The device clock drifts against the system clock, so the callbacks are expected
+// to come at the average measured interval rather than at the nominal block duration;
+// the measured intervals are clamped around the nominal one, so that dropouts
+// themselves don't pull the average
+#define LOAD_METER_INTERVAL_AVERAGING_TIME_SECONDS 2.0
+#define LOAD_METER_INTERVAL_MAX_DRIFT 0.05
+
+LoadMeter::LoadMeter() :
+    numBlocks(0),
+    numOverloads(0),
+    numXruns(0),
+    currentLoad(0.f),
+    minLoad(0.f),
+    maxLoad(0.f),
+    totalLoad(0.0),
+    resetRequested(0),
+    sampleRate(LOAD_METER_DEFAULT_SAMPLERATE),
+    lastStartTicks(0),
+    lastBlockSeconds(0.0),
+    averageIntervalSeconds(0.0),
+    lateSeconds(0.0),
+    wasLate(false) {}
+
+//===----------------------------------------------------------------------===//
+// Audio thread
+//===----------------------------------------------------------------------===//
+
+void LoadMeter::prepare(double newSampleRate) noexcept
+{
+    this->sampleRate = (newSampleRate > 0.0) ? newSampleRate : LOAD_METER_DEFAULT_SAMPLERATE;
+    this->lastStartTicks = 0;
+    this->lastBlockSeconds = 0.0;
+    this->averageIntervalSeconds = 0.0;
+    this->lateSeconds = 0.0;
+    this->wasLate = false;
+}
+
+void LoadMeter::addCallback(int numSamples, int64 startTicks, int64 endTicks) noexcept
+{
+    this->resetIfRequested();
+
+    if (numSamples <= 0)
+    {
+        return;
+    }
+
+    if (this->lastStartTicks != 0)
+    {
+        // some drivers call back in bursts, so a late callback may be followed
+        // by an early one; the device has only run out of data, if the callbacks
+        // got late by a good part of a block, and did not catch up on the next one
+        const double intervalSeconds = Time::highResolutionTicksToSeconds(startTicks - this->lastStartTicks);
+        this->lateSeconds = jmax(0.0, this->lateSeconds + intervalSeconds - this->averageIntervalSeconds);
+
+        const double smoothing = std::exp(-this->lastBlockSeconds / LOAD_METER_INTERVAL_AVERAGING_TIME_SECONDS);
+        const double clampedInterval = jlimit(this->lastBlockSeconds * (1.0 - LOAD_METER_INTERVAL_MAX_DRIFT),
+            this->lastBlockSeconds * (1.0 + LOAD_METER_INTERVAL_MAX_DRIFT), intervalSeconds);
+        this->averageIntervalSeconds = clampedInterval +
+            (this->averageIntervalSeconds - clampedInterval) * smoothing;
+
+        const bool isLate = this->lateSeconds > this->lastBlockSeconds * LOAD_METER_XRUN_LATENESS;
+        if (isLate && this->wasLate)
+        {
+            ++this->numXruns;
+            this->lateSeconds = 0.0;
+            this->wasLate = false;
+        }
+        else
+        {
+            this->wasLate = isLate;
+        }
+    }
+
+    const double blockSeconds = numSamples / this->sampleRate;
+    if (blockSeconds != this->lastBlockSeconds)
+    {
+        // the block size has changed, so start averaging over again
+        this->averageIntervalSeconds = blockSeconds;
+    }
+
+    this->lastStartTicks = startTicks;
+    this->lastBlockSeconds = blockSeconds;
+
+    this->updateLoad(numSamples, Time::highResolutionTicksToSeconds(endTicks - startTicks));
+}
+
+void LoadMeter::addBlock(int numSamples, int64 durationTicks) noexcept
+{
+    this->resetIfRequested();
+
+    if (numSamples > 0)
+    {
+        this->updateLoad(numSamples, Time::highResolutionTicksToSeconds(durationTicks));
+    }
+}
+
+void LoadMeter::updateLoad(int numSamples, double durationSeconds) noexcept
+{
+    const double blockSeconds = numSamples / this->sampleRate;
+    const float load = float(durationSeconds / blockSeconds);
+    const float smoothing = float(std::exp(-blockSeconds / LOAD_METER_SMOOTHING_TIME_CONSTANT_SECONDS));
+    const int bucket = jlimit(0, LOAD_METER_HISTOGRAM_SIZE - 1, int(load * 10.f));
+
+    // the audio thread is the only writer, so no need for compare-and-swap here
+    const bool isFirstBlock = (this->numBlocks.get() == 0);
+    this->minLoad = isFirstBlock ? load : jmin(this->minLoad.get(), load);
+    this->maxLoad = isFirstBlock ? load : jmax(this->maxLoad.get(), load);
+    this->currentLoad = isFirstBlock ? load : load + (this->currentLoad.get() - load) * smoothing;
+    this->totalLoad = this->totalLoad.get() + double(load);
+    ++this->histogram[bucket];
+
+    if (load > 1.f)
+    {
+        ++this->numOverloads;
+    }
+
+    ++this->numBlocks;
+}
+
+void LoadMeter::resetIfRequested() noexcept
+{
+    if (this->resetRequested.get() == 0)
+    {
+        return;
+    }
+
+    this->resetRequested = 0;
+    this->numBlocks = 0;
+    this->numOverloads = 0;
+    this->numXruns = 0;
+    this->currentLoad = 0.f;
+    this->minLoad = 0.f;
+    this->maxLoad = 0.f;
+    this->totalLoad = 0.0;
+
+    for (auto &count : this->histogram)
+    {
+        count = 0;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Any thread
+//===----------------------------------------------------------------------===//
+
+LoadMeter::Statistics LoadMeter::getStatistics() const noexcept
+{
+    Statistics stats;
+    stats.numBlocks = this->numBlocks.get();
+    stats.numOverloads = this->numOverloads.get();
+    stats.numXruns = this->numXruns.get();
+    stats.currentLoad = this->currentLoad.get();
+    stats.minLoad = this->minLoad.get();
+    stats.maxLoad = this->maxLoad.get();
+    stats.averageLoad = (stats.numBlocks > 0) ?
+        float(this->totalLoad.get() / stats.numBlocks) : 0.f;
+
+    for (int i = 0; i < LOAD_METER_HISTOGRAM_SIZE; ++i)
+    {
+        stats.histogram[i] = this->histogram[i].get();
+    }
+
+    return stats;
+}
+
+void LoadMeter::reset() noexcept
+{
+    this->resetRequested = 1;
+}
+
+String LoadMeter::Statistics::toString() const
+{
+    String histogramString;
+    for (int i = 0; i < LOAD_METER_HISTOGRAM_SIZE; ++i)
+    {
+        histogramString << (i > 0 ? " " : "") << this->histogram[i];
+    }
+
+    return String(this->numBlocks) + " blocks, load min " +
+        String(roundToInt(this->minLoad * 100.f)) + "%, avg " +
+        String(roundToInt(this->averageLoad * 100.f)) + "%, max " +
+        String(roundToInt(this->maxLoad * 100.f)) + "%, " +
+        String(this->numOverloads) + " overloads, " +
+        String(this->numXruns) + " xruns, histogram [" + histogramString + "]";
+}
@@ -0,0 +1,121 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define LOAD_METER_HISTOGRAM_SIZE 11
+
+// DSP load of an audio callback, i.e. how much of the time available for
+// a block, which is its duration in real time, was spent processing it:
+// updated by the audio thread, and published through atomics,
+// so that the UI or the logs could poll it without locking anything.
+// Realtime callbacks are also checked for timing gaps, which mean that
+// the device has run out of data, and the user has heard a dropout.
+
+class LoadMeter final
+{
+public:
+
+    LoadMeter();
+
+    //===------------------------------------------------------------------===//
+    // Audio thread
+    //===------------------------------------------------------------------===//
+
+    void prepare(double sampleRate) noexcept;
+
+    // For realtime callbacks, where the intervals between them matter
+    void addCallback(int numSamples, int64 startTicks, int64 endTicks) noexcept;
+
+    // For offline processing, e.g. the renderer's blocks
+    void addBlock(int numSamples, int64 durationTicks) noexcept;
+
+    class ScopedCallback final
+    {
+    public:
+
+        ScopedCallback(LoadMeter &meter, int numSamples) noexcept :
+            meter(meter),
+            numSamples(numSamples),
+            startTicks(Time::getHighResolutionTicks()) {}
+
+        ~ScopedCallback() noexcept
+        {
+            this->meter.addCallback(this->numSamples,
+                this->startTicks, Time::getHighResolutionTicks());
+        }
+
+    private:
+
+        LoadMeter &meter;
+        const int numSamples;
+        const int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedCallback)
+    };
+
+    //===------------------------------------------------------------------===//
+    // Any thread
+    //===------------------------------------------------------------------===//
+
+    // Loads are relative to the block duration, so 1.0 means the whole block;
+    // histogram buckets are 10% wide, the last one counts all overloads
+    struct Statistics final
+    {
+        int numBlocks = 0;
+        int numOverloads = 0;
+        int numXruns = 0;
+        float currentLoad = 0.f;
+        float minLoad = 0.f;
+        float averageLoad = 0.f;
+        float maxLoad = 0.f;
+        int histogram[LOAD_METER_HISTOGRAM_SIZE] = {};
+
+        String toString() const;
+    };
+
+    Statistics getStatistics() const noexcept;
+
+    // Applied by the audio thread on its next block
+    void reset() noexcept;
+
+private:
+
+    void updateLoad(int numSamples, double durationSeconds) noexcept;
+    void resetIfRequested() noexcept;
+
+    Atomic<int> numBlocks;
+    Atomic<int> numOverloads;
+    Atomic<int> numXruns;
+    Atomic<float> currentLoad;
+    Atomic<float> minLoad;
+    Atomic<float> maxLoad;
+    Atomic<double> totalLoad;
+    Atomic<int> histogram[LOAD_METER_HISTOGRAM_SIZE];
+    Atomic<int> resetRequested;
+
+    double sampleRate;
+
+    // Timing of the realtime callbacks, audio thread only
+    int64 lastStartTicks;
+    double lastBlockSeconds;
+    double averageIntervalSeconds;
+    double lateSeconds;
+    bool wasLate;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadMeter);
+};
@@ -18,207 +18,85 @@
 #include "Common.h"
 #include "SpectrumAnalyzer.h"
 
-#define FFT_ABS(x)    ((x) < 0  ? -(x) : (x))
-#define FFT_MAX(a, b) ((a) > (b) ? (a) : (b))
-#define FFT_MIN(a, b) ((a) < (b) ? (a) : (b))
-
-#define FFT_PI     3.14159265358979323846f
-#define FFT_PI2   (3.14159265358979323846f * 2.0f)
-#define FFT_PI_2  (3.14159265358979323846f / 2.0f)
-#define FFT_SQRT2  1.41421356237309504880f
-#define FFT_LOG2   0.693147180559945309417f
-
-#if JUCE_WIN32
-
-#define FFT_SIN   (float)sin
-#define FFT_SINH  (float)sinh
-#define FFT_COS   (float)cos
-#define FFT_TAN   (float)tan
-#define FFT_SQRT  (float)sqrt
-#define FFT_POW   (float)pow
-#define FFT_ATAN  (float)atan
-#define FFT_EXP   (float)exp
-#define FFT_LDEXP (float)ldexp
-#define FFT_FABS  fabsf
-#define FFT_LOG   (float)log
-#define FFT_LOG10 (float)log10
-#define FFT_FMOD  (float)fmod
-
-#else
-
-#define FFT_SIN   sinf
-#define FFT_SINH  sinhf
-#define FFT_COS   cosf
-#define FFT_TAN   tanf
-#define FFT_SQRT  sqrtf
-#define FFT_POW   powf
-#define FFT_ATAN  atanf
-#define FFT_EXP   expf
-#define FFT_LDEXP ldexpf
-#define FFT_FABS  fabsf
-#define FFT_LOG   logf
-#define FFT_LOG10 log10f
-#define FFT_EXP2(_val) powf(2.0f, _val)
-#define FFT_FMOD  fmodf
-
-#endif
-
-SpectrumFFT::SpectrumFFT ()
-{
-    for (int count = 0; count < FFT_COSTABSIZE; count++)
-    {
-        this->costab[count] = FFT_COS(FFT_PI_2 * static_cast<float>(count) / static_cast<float>(FFT_COSTABSIZE));
-    }
-}
+// Keeps the look of the spectrum meters as before
+#define SPECTRUM_FFT_GAIN 2.5f
 
-inline const float SpectrumFFT::cosine(float x)
+SpectrumFFT::SpectrumFFT()
 {
-    int y;
-    
-    x *= FFT_TABLERANGE;
-    y = static_cast<int>(x);
-    if (y < 0)
-    {
-        y = -y;
-    }
-    
-    y &= FFT_TABLEMASK;
-    switch (y >> FFT_COSTABBITS)
+    const double pi2 = MathConstants<double>::twoPi;
+
+    for (int i = 0; i < SPECTRUM_FFT_SIZE; ++i)
     {
-        case 0 : return  this->costab[y];
-        case 1 : return -this->costab[(FFT_COSTABSIZE - 1) - (y - (FFT_COSTABSIZE * 1))];
-        case 2 : return -this->costab[                       (y - (FFT_COSTABSIZE * 2))];
-        case 3 : return  this->costab[(FFT_COSTABSIZE - 1) - (y - (FFT_COSTABSIZE * 3))];
-    }
-    
-    return 0.0f;
-}
+        const double hann = 0.5 * (1.0 - cos(pi2 * i / SPECTRUM_FFT_SIZE));
+        this->window[i] = float(hann / SPECTRUM_FFT_SIZE);
 
-inline const float SpectrumFFT::sine(float x)
-{
-    return this->cosine(x - 0.25f);
-}
+        int reversed = 0;
+        for (int bit = 0; bit < SPECTRUM_FFT_ORDER; ++bit)
+        {
+            reversed |= ((i >> bit) & 1) << (SPECTRUM_FFT_ORDER - 1 - bit);
+        }
 
-inline const unsigned int SpectrumFFT::reverse(unsigned int val, int bits)
-{
-    unsigned int retn = 0;
-    
-    while (bits--)
-    {
-        retn <<= 1;
-        retn |= (val & 1);
-        val >>= 1;
+        this->reversedIndices[i] = reversed;
     }
-    
-    return (retn);
-}
 
-inline void SpectrumFFT::process(int bits)
-{
-    int    count, count2, count3;
-    unsigned        i1;
-    int             i2, i3, i4, y;
-    int             fftlen = 1 << bits;
-    float           a1, a2, b1, b2, z1, z2;
-    float           oneoverN = 1.0f / fftlen;
-    
-    i1 = fftlen / 2;
-    i2 = 1;
-    
-    for (count = 0; count < bits; count++)
+    for (int halfSize = 1; halfSize < SPECTRUM_FFT_SIZE; halfSize <<= 1)
     {
-        i3 = 0;
-        i4 = i1;
-        
-        for (count2 = 0; count2 < i2; count2++)
+        for (int k = 0; k < halfSize; ++k)
         {
-            y  = this->reverse(i3 / static_cast<int>(i1), bits);
-            
-            z1 =  this->cosine(static_cast<float>(y) * oneoverN);
-            z2 =   -this->sine(static_cast<float>(y) * oneoverN);
-            
-            for (count3 = i3; count3 < i4; count3++)
-            {
-                a1 = this->buffer[count3].re;
-                a2 = this->buffer[count3].im;
-                
-                b1 = (z1 * this->buffer[count3+i1].re) - (z2 * this->buffer[count3+i1].im);
-                b2 = (z2 * this->buffer[count3+i1].re) + (z1 * this->buffer[count3+i1].im);
-                
-                this->buffer[count3].re = a1 + b1;
-                this->buffer[count3].im = a2 + b2;
-                
-                this->buffer[count3+i1].re = a1 - b1;
-                this->buffer[count3+i1].im = a2 - b2;
-            }
-            
-            i3 += (i1 << 1);
-            i4 += (i1 << 1);
+            const double angle = -MathConstants<double>::pi * k / halfSize;
+            this->twiddlesRe[halfSize - 1 + k] = float(cos(angle));
+            this->twiddlesIm[halfSize - 1 + k] = float(sin(angle));
         }
-        
-        i1 >>= 1;
-        i2 <<= 1;
     }
+
+    this->twiddlesRe[SPECTRUM_FFT_SIZE - 1] = 0.f;
+    this->twiddlesIm[SPECTRUM_FFT_SIZE - 1] = 0.f;
 }
 
-void SpectrumFFT::computeSpectrum(float *pcmbuffer,
-                                  unsigned int pcmposition,
-                                  unsigned int pcmlength,
-                                  Atomic<float> *spectrum,
-                                  int length,
-                                  int channel,
-                                  int numchannels)
+void SpectrumFFT::computeSpectrum(const float *samples, float *magnitudes)
 {
-    int count, bits, bitslength, nyquist;
-    
-    bitslength = length;
-    bits = 0;
-    while (bitslength > 1)
+    FloatVectorOperations::multiply(this->windowed, samples, this->window, SPECTRUM_FFT_SIZE);
+    FloatVectorOperations::clear(this->im, SPECTRUM_FFT_SIZE);
+
+    for (int i = 0; i < SPECTRUM_FFT_SIZE; ++i)
     {
-        bitslength >>= 1;
-        bits++;
+        this->re[this->reversedIndices[i]] = this->windowed[i];
     }
-    
-    // Apply Hanning window
-    for (count = 0; count < length; count++)
+
+    for (int halfSize = 1; halfSize < SPECTRUM_FFT_SIZE; halfSize <<= 1)
     {
-        float window;
-        float percent = static_cast<float>(count) / static_cast<float>(length);
-        
-        window = 0.5f * (1.0f  - this->cosine(percent));
-        
-        this->buffer[count].re = pcmbuffer[pcmposition] * window;
-        this->buffer[count].re /= static_cast<float>(length);
-        this->buffer[count].im = 0.00000001f;
-        
-        pcmposition++;
-        if (pcmposition >= pcmlength)
+        const float *const wRe = this->twiddlesRe + halfSize - 1;
+        const float *const wIm = this->twiddlesIm + halfSize - 1;
+
+        for (int start = 0; start < SPECTRUM_FFT_SIZE; start += (halfSize << 1))
         {
-            pcmposition = 0;
+            float *const aRe = this->re + start;
+            float *const aIm = this->im + start;
+            float *const bRe = aRe + halfSize;
+            float *const bIm = aIm + halfSize;
+
+            for (int k = 0; k < halfSize; ++k)
+            {
+                const float tRe = (wRe[k] * bRe[k]) - (wIm[k] * bIm[k]);
+                const float tIm = (wRe[k] * bIm[k]) + (wIm[k] * bRe[k]);
+                bRe[k] = aRe[k] - tRe;
+                bIm[k] = aIm[k] - tIm;
+                aRe[k] += tRe;
+                aIm[k] += tIm;
+            }
         }
     }
 
-    this->process(bits);
+    const int numBins = SPECTRUM_FFT_SIZE / 2;
+    FloatVectorOperations::multiply(this->re, this->re, numBins);
+    FloatVectorOperations::multiply(this->im, this->im, numBins);
+    FloatVectorOperations::add(this->re, this->im, numBins);
 
-    nyquist = (length / 2);
-    for (count = 0; count < (nyquist - 1); ++count)
+    for (int i = 0; i < numBins; ++i)
     {
-        float magnitude;
-        int n = count;
-        
-        n = this->reverse(n, bits);
-        
-        magnitude = 
-            FFT_SQRT((this->buffer[n].re * this->buffer[n].re)
-                + (this->buffer[n].im * this->buffer[n].im));
-        
-        magnitude *= 2.5f; 
-        
-        if (magnitude > 1.0f)
-        {
-            magnitude = 1.0f;
-        }
-        
-        spectrum[count] = magnitude;
+        magnitudes[i] = sqrtf(this->re[i]);
     }
+
+    FloatVectorOperations::multiply(magnitudes, SPECTRUM_FFT_GAIN, numBins);
+    FloatVectorOperations::min(magnitudes, magnitudes, 1.f, numBins);
 }
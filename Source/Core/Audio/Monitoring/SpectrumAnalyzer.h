@@ -17,41 +17,37 @@
 
 #pragma once
 
-const int FFT_COSTABBITS = 13;
-const int FFT_COSTABSIZE = (1 << FFT_COSTABBITS);
-const int FFT_TABLERANGE = (FFT_COSTABSIZE * 4);
-const int FFT_TABLEMASK  = (FFT_TABLERANGE - 1);
+#define SPECTRUM_FFT_ORDER  10
+#define SPECTRUM_FFT_SIZE   (1 << SPECTRUM_FFT_ORDER)
+
+// A fixed-size radix-2 FFT with precomputed window, bit reversal and twiddles;
+// all the inner loops run over contiguous float arrays, so that they get vectorized.
+// Not thread-safe, the caller is supposed to serialize access to an instance.
 
 class SpectrumFFT final
 {
 public:
-    
+
     SpectrumFFT();
-    
-    void computeSpectrum(float *pcmbuffer,
-        unsigned int pcmposition,
-        unsigned int pcmlength,
-        Atomic<float> *spectrum,
-        int length,
-        int channel,
-        int numchannels);
-    
+
+    // Takes SPECTRUM_FFT_SIZE samples,
+    // writes SPECTRUM_FFT_SIZE / 2 magnitudes in the range of [0, 1]
+    void computeSpectrum(const float *samples, float *magnitudes);
+
 private:
-    
-    typedef struct
-    {
-        float re;
-        float im;
-    }
-    FFT_COMPLEX;
-    
-    FFT_COMPLEX     buffer[16 * 1024];
-    float           costab[FFT_COSTABSIZE];
-    
-    inline const float          cosine(float x);
-    inline const float          sine(float x);
-    inline const unsigned int   reverse(unsigned int val, int bits);
-    inline void                 process(int bits);
-    
+
+    // Hann window, also normalized by the transform size
+    float window[SPECTRUM_FFT_SIZE];
+    int reversedIndices[SPECTRUM_FFT_SIZE];
+
+    // Each stage's twiddles are stored one after another,
+    // a stage with a half size of n starts at index n - 1
+    float twiddlesRe[SPECTRUM_FFT_SIZE];
+    float twiddlesIm[SPECTRUM_FFT_SIZE];
+
+    float windowed[SPECTRUM_FFT_SIZE];
+    float re[SPECTRUM_FFT_SIZE];
+    float im[SPECTRUM_FFT_SIZE];
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumFFT);
 };
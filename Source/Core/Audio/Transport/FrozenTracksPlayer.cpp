@@ -0,0 +1,153 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "FrozenTracksPlayer.h"
+
+#define FROZEN_TRACK_READ_AHEAD_SIZE (32 * 1024)
+
+FrozenTracksPlayer::FrozenTracksPlayer() :
+    readAheadThread("Frozen Tracks Reader")
+{
+    this->formatManager.registerBasicFormats();
+    this->sourcePlayer.setSource(&this->mixer);
+}
+
+FrozenTracksPlayer::~FrozenTracksPlayer()
+{
+    this->sourcePlayer.setSource(nullptr);
+    this->mixer.removeAllInputs();
+
+    for (auto *track : this->tracks)
+    {
+        track->transportSource.setSource(nullptr);
+    }
+
+    this->tracks.clear();
+    this->readAheadThread.stopThread(1000);
+}
+
+bool FrozenTracksPlayer::addTrack(const String &trackId, const File &audioFile)
+{
+    this->removeTrack(trackId);
+
+    AudioFormatReader *reader = this->formatManager.createReaderFor(audioFile);
+    if (reader == nullptr)
+    {
+        return false;
+    }
+
+    if (!this->readAheadThread.isThreadRunning())
+    {
+        this->readAheadThread.startThread(6);
+    }
+
+    ScopedPointer<FrozenTrack> track(new FrozenTrack());
+    track->trackId = trackId;
+    track->readerSource = new AudioFormatReaderSource(reader, true);
+    track->transportSource.setSource(track->readerSource, FROZEN_TRACK_READ_AHEAD_SIZE,
+        &this->readAheadThread, reader->sampleRate, int(reader->numChannels));
+
+    const ScopedLock sl(this->tracksLock);
+    this->mixer.addInputSource(&track->transportSource, false);
+    this->tracks.add(track.release());
+    return true;
+}
+
+void FrozenTracksPlayer::removeTrack(const String &trackId)
+{
+    const ScopedLock sl(this->tracksLock);
+
+    for (int i = 0; i < this->tracks.size(); ++i)
+    {
+        auto *track = this->tracks.getUnchecked(i);
+        if (track->trackId == trackId)
+        {
+            this->mixer.removeInputSource(&track->transportSource);
+            track->transportSource.setSource(nullptr);
+            this->tracks.remove(i);
+            return;
+        }
+    }
+}
+
+bool FrozenTracksPlayer::hasTrack(const String &trackId) const
+{
+    const ScopedLock sl(this->tracksLock);
+
+    for (const auto *track : this->tracks)
+    {
+        if (track->trackId == trackId)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FrozenTracksPlayer::startPlayback(double positionInSeconds)
+{
+    const ScopedLock sl(this->tracksLock);
+
+    for (auto *track : this->tracks)
+    {
+        track->transportSource.setPosition(positionInSeconds);
+        track->transportSource.start();
+    }
+}
+
+void FrozenTracksPlayer::seek(double positionInSeconds)
+{
+    const ScopedLock sl(this->tracksLock);
+
+    for (auto *track : this->tracks)
+    {
+        track->transportSource.setPosition(positionInSeconds);
+    }
+}
+
+void FrozenTracksPlayer::stopPlayback()
+{
+    const ScopedLock sl(this->tracksLock);
+
+    for (auto *track : this->tracks)
+    {
+        track->transportSource.stop();
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// AudioIODeviceCallback
+//===----------------------------------------------------------------------===//
+
+void FrozenTracksPlayer::audioDeviceIOCallback(const float **inputChannelData, int numInputChannels,
+    float **outputChannelData, int numOutputChannels, int numSamples)
+{
+    this->sourcePlayer.audioDeviceIOCallback(inputChannelData, numInputChannels,
+        outputChannelData, numOutputChannels, numSamples);
+}
+
+void FrozenTracksPlayer::audioDeviceAboutToStart(AudioIODevice *device)
+{
+    this->sourcePlayer.audioDeviceAboutToStart(device);
+}
+
+void FrozenTracksPlayer::audioDeviceStopped()
+{
+    this->sourcePlayer.audioDeviceStopped();
+}
@@ -0,0 +1,67 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+// Streams the cached audio of frozen tracks in sync with the playback,
+// so that their instruments don't have to be run live
+
+class FrozenTracksPlayer final : public AudioIODeviceCallback
+{
+public:
+
+    FrozenTracksPlayer();
+    ~FrozenTracksPlayer() override;
+
+    bool addTrack(const String &trackId, const File &audioFile);
+    void removeTrack(const String &trackId);
+    bool hasTrack(const String &trackId) const;
+
+    // These are thread-safe, the player thread calls seek() when looping
+    void startPlayback(double positionInSeconds);
+    void seek(double positionInSeconds);
+    void stopPlayback();
+
+    //===------------------------------------------------------------------===//
+    // AudioIODeviceCallback
+    //===------------------------------------------------------------------===//
+
+    void audioDeviceIOCallback(const float **inputChannelData, int numInputChannels,
+        float **outputChannelData, int numOutputChannels, int numSamples) override;
+    void audioDeviceAboutToStart(AudioIODevice *device) override;
+    void audioDeviceStopped() override;
+
+private:
+
+    struct FrozenTrack final
+    {
+        String trackId;
+        ScopedPointer<AudioFormatReaderSource> readerSource;
+        AudioTransportSource transportSource;
+    };
+
+    CriticalSection tracksLock;
+    OwnedArray<FrozenTrack> tracks;
+
+    AudioFormatManager formatManager;
+    TimeSliceThread readAheadThread;
+
+    MixerAudioSource mixer;
+    AudioSourcePlayer sourcePlayer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrozenTracksPlayer)
+};
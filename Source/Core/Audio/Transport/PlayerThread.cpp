@@ -20,6 +20,7 @@
 #include "PlayerThread.h"
 #include "Instrument.h"
 #include "MidiSequence.h"
+#include "FrozenTracksPlayer.h"
 
 #define MINIMUM_STOP_CHECK_TIME_MS 1000
 
@@ -59,6 +60,7 @@ void PlayerThread::run()
     double currentTimeMs = 0.0;
     double msPerQuarter = 0.0;
     this->transport.calcTimeAndTempoAt(absStartPosition, currentTimeMs, msPerQuarter);
+    const double startTimeMs = currentTimeMs;
     
     if (this->broadcastMode)
     {
@@ -78,7 +80,7 @@ void PlayerThread::run()
     {
         int key;
         int channel;
-        MidiMessageCollector *listener;
+        MidiEventQueue *listener;
     };
     // (some plugins just don't understand allNotesOff message)
     Array<HoldingNote> holdingNotes;
@@ -90,7 +92,7 @@ void PlayerThread::run()
         {
             MidiMessage startPlayback(MidiMessage::midiStart());
             startPlayback.setTimeStamp(Time::getMillisecondCounterHiRes() * 0.001);
-            instrument->getProcessorPlayer().getMidiMessageCollector().addMessageToQueue(startPlayback);
+            instrument->getProcessorPlayer().getMidiEventQueue().push(startPlayback);
         }
     };
 
@@ -100,15 +102,26 @@ void PlayerThread::run()
         {
             MidiMessage noteOff(MidiMessage::noteOff(holding.channel, holding.key, 0.f));
             noteOff.setTimeStamp(Time::getMillisecondCounterHiRes() * 0.001);
-            holding.listener->addMessageToQueue(noteOff);
+            holding.listener->push(noteOff);
         }
         
+        const double timeNow = Time::getMillisecondCounterHiRes() * 0.001;
         MidiMessage stopPlayback(MidiMessage::midiStop());
-        stopPlayback.setTimeStamp(Time::getMillisecondCounterHiRes() * 0.001);
+        stopPlayback.setTimeStamp(timeNow);
         
         for (auto &instrument : uniqueInstruments)
         {
-            instrument->getProcessorPlayer().getMidiMessageCollector().addMessageToQueue(stopPlayback);
+            auto &queue = instrument->getProcessorPlayer().getMidiEventQueue();
+
+            // And all-notes-off as well, for those who do understand it
+            for (int channel = 1; channel <= 16; ++channel)
+            {
+                MidiMessage allNotesOff(MidiMessage::allNotesOff(channel));
+                allNotesOff.setTimeStamp(timeNow);
+                queue.push(allNotesOff);
+            }
+
+            queue.push(stopPlayback);
         }
         
         // Wait until all plugins process the messages in their queues
@@ -119,10 +132,19 @@ void PlayerThread::run()
     {
         for (auto &instrument : uniqueInstruments)
         {
-            instrument->getProcessorPlayer().getMidiMessageCollector().addMessageToQueue(tempoEvent);
+            instrument->getProcessorPlayer().getMidiEventQueue().push(tempoEvent);
         }
     };
     
+    // Frozen tracks are started by the transport, only rewinding is up to us
+    auto rewindFrozenTracks = [this, startTimeMs]()
+    {
+        if (this->broadcastMode)
+        {
+            this->transport.frozenTracksPlayer->seek(startTimeMs / 1000.0);
+        }
+    };
+
     // And here we go.
     sendMidiStart();
     
@@ -155,6 +177,7 @@ void PlayerThread::run()
                 //Logger::writeToLog("Seek to time " + String(startPositionInTime));
                 sequences.seekToTime(startPositionInTime);
                 prevTimeStamp = startPositionInTime;
+                rewindFrozenTracks();
                 continue;
             }
             else
@@ -165,6 +188,7 @@ void PlayerThread::run()
 
                 if (this->broadcastMode)
                 {
+                    this->transport.frozenTracksPlayer->stopPlayback();
                     this->transport.seekToPosition(this->transport.getSeekPosition());
                     this->transport.broadcastStop();
                 }
@@ -216,6 +240,7 @@ void PlayerThread::run()
         {
             sequences.seekToTime(startPositionInTime);
             prevTimeStamp = startPositionInTime;
+            rewindFrozenTracks();
         }
         else
         {
@@ -239,7 +264,7 @@ void PlayerThread::run()
             else
             {
                 //Logger::writeToLog(String(wrapper.message.getNoteNumber()));
-                wrapper.listener->addMessageToQueue(wrapper.message);
+                wrapper.listener->push(wrapper.message);
             }
             
             if (wrapper.message.isNoteOn())
@@ -0,0 +1,115 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Common.h"
+#include "PolyphaseDecimator.h"
+
+// Kaiser window beta for about 100dB of stopband attenuation
+#define DECIMATOR_KAISER_BETA 10.0
+
+// Passband edge, relative to the output Nyquist frequency
+#define DECIMATOR_CUTOFF 0.9
+
+static double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    const double halfX = x / 2.0;
+
+    for (int k = 1; k < 64; ++k)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+
+        if (term < sum * 1e-16)
+        {
+            break;
+        }
+    }
+
+    return sum;
+}
+
+double PolyphaseDecimator::getKaiserWindow(double x, double beta) noexcept
+{
+    return besselI0(beta * std::sqrt(jmax(0.0, 1.0 - x * x))) / besselI0(beta);
+}
+
+PolyphaseDecimator::PolyphaseDecimator(int decimationFactor, int channels, int maxInputBlockSize) :
+    factor(jmax(1, decimationFactor)),
+    numChannels(jmax(1, channels)),
+    numTaps(2 * jmax(1, decimationFactor) * DECIMATOR_TAPS_PER_PHASE_SIDE + 1),
+    lineSize(numTaps - 1 + maxInputBlockSize)
+{
+    this->coefficients.calloc(this->numTaps);
+
+    const double cutoff = DECIMATOR_CUTOFF / this->factor; // relative to the input Nyquist
+    const int middle = (this->numTaps - 1) / 2;
+
+    double sum = 0.0;
+    for (int i = 0; i < this->numTaps; ++i)
+    {
+        const double n = double(i - middle);
+        const double sinc = (i == middle) ? cutoff :
+            std::sin(MathConstants<double>::pi * cutoff * n) / (MathConstants<double>::pi * n);
+
+        const double window = getKaiserWindow(n / middle, DECIMATOR_KAISER_BETA);
+        this->coefficients[i] = sinc * window;
+        sum += this->coefficients[i];
+    }
+
+    // unity gain at DC
+    for (int i = 0; i < this->numTaps; ++i)
+    {
+        this->coefficients[i] /= sum;
+    }
+
+    this->lines.calloc(size_t(this->numChannels) * size_t(this->lineSize));
+}
+
+void PolyphaseDecimator::process(const double *const *input, double *const *output, int numInputSamples)
+{
+    jassert(numInputSamples % this->factor == 0);
+    jassert(numInputSamples <= this->lineSize - (this->numTaps - 1));
+
+    const int historySize = this->numTaps - 1;
+    const int numOutputSamples = numInputSamples / this->factor;
+
+    for (int channel = 0; channel < this->numChannels; ++channel)
+    {
+        double *line = this->lines + channel * this->lineSize;
+        memcpy(line + historySize, input[channel], sizeof(double) * size_t(numInputSamples));
+
+        // the filter is symmetric, so there's no need to reverse it,
+        // and every output sample is a contiguous dot product
+        const double *h = this->coefficients;
+        for (int i = 0; i < numOutputSamples; ++i)
+        {
+            const double *x = line + i * this->factor;
+            double y = 0.0;
+            for (int j = 0; j < this->numTaps; ++j)
+            {
+                y += h[j] * x[j];
+            }
+
+            output[channel][i] = y;
+        }
+
+        memmove(line, line + numInputSamples, sizeof(double) * size_t(historySize));
+    }
+}
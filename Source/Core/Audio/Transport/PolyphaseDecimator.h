@@ -0,0 +1,63 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#define DECIMATOR_TAPS_PER_PHASE_SIDE 32
+
+// A linear phase FIR lowpass with a Kaiser windowed sinc,
+// which only computes every n-th output sample, i.e. the polyphase form
+// of filtering followed by downsampling; used by the offline renderer
+// to bring the oversampled mix back to the project sample rate.
+// The filter has (2 * factor * 32 + 1) taps, so that its group delay
+// is exactly DECIMATOR_TAPS_PER_PHASE_SIDE output samples.
+
+class PolyphaseDecimator final
+{
+public:
+
+    PolyphaseDecimator(int factor, int numChannels, int maxInputBlockSize);
+
+    int getFactor() const noexcept { return this->factor; }
+
+    // In output samples
+    int getLatency() const noexcept { return DECIMATOR_TAPS_PER_PHASE_SIDE; }
+
+    // The number of input samples should be a multiple of the factor;
+    // writes numInputSamples / factor samples to each output channel
+    void process(const double *const *input, double *const *output, int numInputSamples);
+
+    // The Kaiser window at x in [-1, 1], also used by the level meters' interpolator
+    static double getKaiserWindow(double x, double beta) noexcept;
+
+private:
+
+    const int factor;
+    const int numChannels;
+    const int numTaps;
+    const int lineSize;
+
+    HeapBlock<double> coefficients;
+
+    // Each channel's line holds the last (numTaps - 1) samples
+    // of the previous block, followed by the current block;
+    // all lines are stored one after another
+    HeapBlock<double> lines;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolyphaseDecimator)
+};
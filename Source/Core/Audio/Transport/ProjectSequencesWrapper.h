@@ -25,7 +25,7 @@ struct SequenceWrapper final : public ReferenceCountedObject
 {
     MidiMessageSequence midiMessages;
     int currentIndex;
-    MidiMessageCollector *listener;
+    MidiEventQueue *listener;
     Instrument *instrument;
     const MidiSequence *track;
     using Ptr = ReferenceCountedObjectPtr<SequenceWrapper>;
@@ -34,7 +34,7 @@ struct SequenceWrapper final : public ReferenceCountedObject
 struct MessageWrapper final : public ReferenceCountedObject
 {
     MidiMessage message;
-    MidiMessageCollector *listener;
+    MidiEventQueue *listener;
     Instrument *instrument;
     using Ptr = ReferenceCountedObjectPtr<MessageWrapper>;
 };
@@ -0,0 +1,40 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#define RENDER_DEFAULT_BLOCK_SIZE 4096
+
+// Offline render options for the exports:
+// larger blocks are fine here, as nobody waits for them in real time
+
+struct RenderSettings final
+{
+    // 16 and 24 bits are integer and dithered, 32 bits means float
+    int bitDepth = 24;
+    bool dither = true;
+
+    // The graphs are rendered at this multiple of the project sample rate,
+    // and the mix is then decimated back with a polyphase lowpass filter
+    int oversamplingFactor = 1;
+
+    // Graphs that support it are rendered in double precision
+    bool preferDoublePrecision = true;
+
+    int blockSize = RENDER_DEFAULT_BLOCK_SIZE;
+};
@@ -0,0 +1,194 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Common.h"
+#include "RenderStatistics.h"
+#include "Transport.h"
+
+RenderStatistics::RenderStatistics() :
+    totalFrames(0),
+    framesRendered(0),
+    framesQueued(0),
+    framesWritten(0),
+    sampleRate(0.0),
+    startTicks(0),
+    finishTicks(0) {}
+
+//===----------------------------------------------------------------------===//
+// Renderer
+//===----------------------------------------------------------------------===//
+
+void RenderStatistics::prepare(const StringArray &names)
+{
+    this->instrumentNames = names;
+    this->totalFrames = 0;
+    this->framesRendered = 0;
+    this->framesQueued = 0;
+    this->framesWritten = 0;
+    this->startTicks = 0;
+    this->finishTicks = 0;
+
+    for (auto &time : this->instrumentMicroseconds)
+    {
+        time = 0;
+    }
+
+    this->blockLoad.reset();
+}
+
+void RenderStatistics::start(int64 numTotalFrames, double newSampleRate) noexcept
+{
+    this->totalFrames = numTotalFrames;
+    this->sampleRate = newSampleRate;
+    this->blockLoad.prepare(newSampleRate);
+    this->finishTicks = 0;
+    this->startTicks = Time::getHighResolutionTicks();
+}
+
+void RenderStatistics::finish() noexcept
+{
+    this->finishTicks = Time::getHighResolutionTicks();
+}
+
+void RenderStatistics::addFramesRendered(int64 numFrames) noexcept
+{
+    this->framesRendered += numFrames;
+}
+
+void RenderStatistics::addFramesQueued(int64 numFrames) noexcept
+{
+    this->framesQueued += numFrames;
+}
+
+void RenderStatistics::addInstrumentTime(int instrumentIndex, int64 microseconds) noexcept
+{
+    if (isPositiveAndBelow(instrumentIndex, RENDER_STATISTICS_MAX_INSTRUMENTS))
+    {
+        this->instrumentMicroseconds[instrumentIndex] += microseconds;
+    }
+}
+
+void RenderStatistics::addBlockTime(int numFrames, int64 ticks) noexcept
+{
+    this->blockLoad.addBlock(numFrames, ticks);
+}
+
+void RenderStatistics::addBlock(int64, const AudioBuffer<float> &, int, int numSamples)
+{
+    this->framesWritten += numSamples;
+}
+
+//===----------------------------------------------------------------------===//
+// Any thread
+//===----------------------------------------------------------------------===//
+
+float RenderStatistics::getProgress() const noexcept
+{
+    const int64 total = this->totalFrames.get();
+    return (total > 0) ? float(double(this->framesWritten.get()) / double(total)) : 0.f;
+}
+
+int64 RenderStatistics::getTotalFrames() const noexcept
+{
+    return this->totalFrames.get();
+}
+
+int64 RenderStatistics::getFramesRendered() const noexcept
+{
+    return this->framesRendered.get();
+}
+
+int64 RenderStatistics::getFramesWritten() const noexcept
+{
+    return this->framesWritten.get();
+}
+
+int64 RenderStatistics::getWriterQueueDepth() const noexcept
+{
+    return jmax(int64(0), this->framesQueued.get() - this->framesWritten.get());
+}
+
+double RenderStatistics::getElapsedSeconds() const noexcept
+{
+    const int64 start = this->startTicks.get();
+    if (start == 0)
+    {
+        return 0.0;
+    }
+
+    const int64 finish = this->finishTicks.get();
+    const int64 end = (finish != 0) ? finish : Time::getHighResolutionTicks();
+    return Time::highResolutionTicksToSeconds(end - start);
+}
+
+double RenderStatistics::getRealtimeFactor() const noexcept
+{
+    const double elapsed = this->getElapsedSeconds();
+    const double rate = this->sampleRate.get();
+    if (elapsed <= 0.0 || rate <= 0.0)
+    {
+        return 0.0;
+    }
+
+    return (this->framesRendered.get() / rate) / elapsed;
+}
+
+double RenderStatistics::getEstimatedSecondsLeft() const noexcept
+{
+    const double realtimeFactor = this->getRealtimeFactor();
+    const double rate = this->sampleRate.get();
+    if (realtimeFactor <= 0.0 || rate <= 0.0)
+    {
+        return 0.0;
+    }
+
+    const int64 framesLeft = jmax(int64(0), this->totalFrames.get() - this->framesRendered.get());
+    return (framesLeft / rate) / realtimeFactor;
+}
+
+int RenderStatistics::getNumInstruments() const noexcept
+{
+    return jmin(this->instrumentNames.size(), RENDER_STATISTICS_MAX_INSTRUMENTS);
+}
+
+String RenderStatistics::getInstrumentName(int instrumentIndex) const
+{
+    return this->instrumentNames[instrumentIndex];
+}
+
+double RenderStatistics::getInstrumentSeconds(int instrumentIndex) const noexcept
+{
+    if (isPositiveAndBelow(instrumentIndex, RENDER_STATISTICS_MAX_INSTRUMENTS))
+    {
+        return this->instrumentMicroseconds[instrumentIndex].get() / 1000000.0;
+    }
+
+    return 0.0;
+}
+
+LoadMeter::Statistics RenderStatistics::getBlockLoad() const noexcept
+{
+    return this->blockLoad.getStatistics();
+}
+
+String RenderStatistics::getDescription() const
+{
+    return String(roundToInt(this->getProgress() * 100.f)) + "%, " +
+        String(this->getRealtimeFactor(), 1) + "x, " +
+        Transport::getTimeString(this->getEstimatedSecondsLeft() * 1000.0);
+}
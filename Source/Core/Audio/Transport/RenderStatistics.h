@@ -0,0 +1,106 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "LoadMeter.h"
+
+#define RENDER_STATISTICS_MAX_INSTRUMENTS 64
+
+// Progress and performance counters of an offline render:
+// written by the renderer thread and its disk writer thread,
+// and polled lock-free by the render dialog or the command line renderer.
+
+class RenderStatistics final : public AudioFormatWriter::ThreadedWriter::IncomingDataReceiver
+{
+public:
+
+    RenderStatistics();
+
+    //===------------------------------------------------------------------===//
+    // Renderer
+    //===------------------------------------------------------------------===//
+
+    // Called before the render thread starts, this is the only non-atomic part
+    void prepare(const StringArray &instrumentNames);
+
+    void start(int64 totalFrames, double sampleRate) noexcept;
+    void finish() noexcept;
+
+    void addFramesRendered(int64 numFrames) noexcept;
+    void addFramesQueued(int64 numFrames) noexcept;
+    void addInstrumentTime(int instrumentIndex, int64 microseconds) noexcept;
+    void addBlockTime(int numFrames, int64 ticks) noexcept;
+
+    //===------------------------------------------------------------------===//
+    // Any thread
+    //===------------------------------------------------------------------===//
+
+    float getProgress() const noexcept;
+
+    int64 getTotalFrames() const noexcept;
+    int64 getFramesRendered() const noexcept;
+    int64 getFramesWritten() const noexcept;
+
+    // Frames rendered but not yet written to disk
+    int64 getWriterQueueDepth() const noexcept;
+
+    double getElapsedSeconds() const noexcept;
+
+    // How many seconds of audio are rendered per second
+    double getRealtimeFactor() const noexcept;
+    double getEstimatedSecondsLeft() const noexcept;
+
+    int getNumInstruments() const noexcept;
+    String getInstrumentName(int instrumentIndex) const;
+    double getInstrumentSeconds(int instrumentIndex) const noexcept;
+
+    // How much of each block's real time duration it took to render,
+    // i.e. whether the project could be played back without dropouts
+    LoadMeter::Statistics getBlockLoad() const noexcept;
+
+    // A one-line summary, e.g. for the command line
+    String getDescription() const;
+
+    //===------------------------------------------------------------------===//
+    // IncomingDataReceiver, called by the writer thread
+    //===------------------------------------------------------------------===//
+
+    void reset(int numChannels, double sampleRate, int64 totalSamplesInSource) override {}
+    void addBlock(int64 sampleNumberInSource, const AudioBuffer<float> &newData,
+        int startOffsetInBuffer, int numSamples) override;
+
+private:
+
+    StringArray instrumentNames;
+
+    Atomic<int64> totalFrames;
+    Atomic<int64> framesRendered;
+    Atomic<int64> framesQueued;
+    Atomic<int64> framesWritten;
+    Atomic<double> sampleRate;
+
+    Atomic<int64> startTicks;
+    Atomic<int64> finishTicks;
+
+    Atomic<int64> instrumentMicroseconds[RENDER_STATISTICS_MAX_INSTRUMENTS];
+
+    LoadMeter blockLoad;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderStatistics)
+};
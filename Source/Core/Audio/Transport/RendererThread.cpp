@@ -22,12 +22,34 @@
 #include "App.h"
 #include "Workspace.h"
 #include "AudioCore.h"
+#include "PolyphaseDecimator.h"
+
+// Freezing runs while the instruments are still connected to the device,
+// so it keeps them at the device sample rate and precision
+#define RENDERER_FREEZE_BLOCK_SIZE 512
+
+// Smaller blocks would spend more time on per-block overhead than on rendering
+#define RENDERER_MIN_BLOCK_SIZE 512
+
+// The disk writer's buffer, in frames
+#define RENDERER_WRITER_FIFO_SIZE (1 << 18)
+
+static StringArray getInstrumentNames(const ProjectSequences &sequences)
+{
+    StringArray names;
+    for (const auto *instrument : sequences.getUniqueInstruments())
+    {
+        names.add(instrument->getName());
+    }
+
+    return names;
+}
 
 RendererThread::RendererThread(Transport &parentTrasport) :
     Thread("RendererThread"),
     transport(parentTrasport),
-    writer(nullptr),
-    percentsDone(0.f) {}
+    writerThread("RendererWriterThread"),
+    writer(nullptr) {}
 
 RendererThread::~RendererThread()
 {
@@ -36,12 +58,11 @@ RendererThread::~RendererThread()
 
 float RendererThread::getPercentsComplete() const
 {
-    const ScopedReadLock lock(this->percentsLock);
-    return this->percentsDone;
+    return this->statistics.getProgress();
 }
 
 
-void RendererThread::startRecording(const File &file)
+void RendererThread::startRecording(const File &file, const RenderSettings &renderSettings)
 {
     this->transport.rebuildSequencesIfNeeded();
     const ProjectSequences sequences = this->transport.getSequences();
@@ -52,32 +73,42 @@ void RendererThread::startRecording(const File &file)
     }
 
     this->stop();
+    this->sequencesToFreeze = nullptr;
+    this->freezeCallback = nullptr;
 
     double sampleRate = sequences.getSampleRate();
     int numChannels = sequences.getNumOutputChannels();
 
+    this->settings = renderSettings;
+    this->settings.oversamplingFactor = (renderSettings.oversamplingFactor >= 4) ? 4 :
+        ((renderSettings.oversamplingFactor >= 2) ? 2 : 1);
+    this->settings.blockSize = jmax(RENDERER_MIN_BLOCK_SIZE, renderSettings.blockSize);
+
     // Create an OutputStream to write to our destination file...
     file.deleteFile();
     ScopedPointer<FileOutputStream> fileStream(file.createOutputStream());
 
     if (fileStream != nullptr)
     {
-        {
-            const ScopedWriteLock pl(this->percentsLock);
-            this->percentsDone = 0.f;
-        }
+        this->statistics.prepare(getInstrumentNames(sequences));
         
         if (file.getFileExtension().toLowerCase() == ".wav")
         {
             WavAudioFormat wavFormat;
-            const ScopedLock sl(this->writerLock);
-            this->writer = wavFormat.createWriterFor(fileStream, sampleRate, numChannels, 16, StringPairArray(), 0);
+            this->settings.bitDepth = (renderSettings.bitDepth >= 32) ? 32 :
+                ((renderSettings.bitDepth >= 24) ? 24 : 16);
+
+            this->writer = wavFormat.createWriterFor(fileStream, sampleRate,
+                numChannels, this->settings.bitDepth, StringPairArray(), 0);
         }
         else if (file.getFileExtension().toLowerCase() == ".flac")
         {
+            // flac has no float samples
             FlacAudioFormat flacFormat;
-            const ScopedLock sl(this->writerLock);
-            this->writer = flacFormat.createWriterFor(fileStream, sampleRate, numChannels, 16, StringPairArray(), 0);
+            this->settings.bitDepth = (renderSettings.bitDepth >= 24) ? 24 : 16;
+
+            this->writer = flacFormat.createWriterFor(fileStream, sampleRate,
+                numChannels, this->settings.bitDepth, StringPairArray(), 0);
         }
 
         if (writer != nullptr)
@@ -89,6 +120,44 @@ void RendererThread::startRecording(const File &file)
     }
 }
 
+void RendererThread::startFreezing(const File &file,
+    const ProjectSequences &sequences, FreezeCallback callback)
+{
+    if (sequences.empty())
+    {
+        return;
+    }
+
+    this->stop();
+
+    file.deleteFile();
+    ScopedPointer<FileOutputStream> fileStream(file.createOutputStream());
+
+    if (fileStream != nullptr)
+    {
+        this->statistics.prepare(getInstrumentNames(sequences));
+
+        this->settings = {};
+        this->settings.bitDepth = 32;
+        this->settings.dither = false;
+        this->settings.oversamplingFactor = 1;
+        this->settings.preferDoublePrecision = false;
+        this->settings.blockSize = RENDERER_FREEZE_BLOCK_SIZE;
+
+        WavAudioFormat wavFormat;
+        this->writer = wavFormat.createWriterFor(fileStream, sequences.getSampleRate(),
+            sequences.getNumOutputChannels(), this->settings.bitDepth, StringPairArray(), 0);
+
+        if (writer != nullptr)
+        {
+            fileStream.release();
+            this->sequencesToFreeze = new ProjectSequences(sequences);
+            this->freezeCallback = callback;
+            this->startThread(9);
+        }
+    }
+}
+
 void RendererThread::stop()
 {
     if (this->isThreadRunning())
@@ -96,10 +165,13 @@ void RendererThread::stop()
         this->stopThread(500);
     }
 
-    {
-        const ScopedLock sl(this->writerLock);
-        this->writer = nullptr;
-    }
+    // the writer is only accessed by the render thread, which is stopped now
+    this->writer = nullptr;
+}
+
+const RenderStatistics &RendererThread::getStatistics() const noexcept
+{
+    return this->statistics;
 }
 
 bool RendererThread::isRecording() const
@@ -116,7 +188,10 @@ bool RendererThread::isRecording() const
 struct RenderBuffer final
 {
     Instrument *instrument;
-    AudioSampleBuffer sampleBuffer;
+    bool isDoublePrecision;
+    int deviceBlockSize;
+    AudioBuffer<float> sampleBuffer;
+    AudioBuffer<double> sampleBufferDouble;
     MidiBuffer midiBuffer;
 };
 
@@ -124,13 +199,19 @@ void RendererThread::run()
 {
     // step 0. init.
     this->transport.rebuildSequencesIfNeeded();
-    ProjectSequences sequences = this->transport.getSequences();
-    const int bufferSize = 512;
+    ProjectSequences sequences = (this->sequencesToFreeze != nullptr) ?
+        ProjectSequences(*this->sequencesToFreeze) : this->transport.getSequences();
+
+    const RenderSettings renderSettings(this->settings);
+    const int oversamplingFactor = renderSettings.oversamplingFactor;
+    const int outputBufferSize = renderSettings.blockSize;
+    const int bufferSize = outputBufferSize * oversamplingFactor;
 
     // assuming that number of channels and sample rate is equal for all instruments
     const int numOutChannels = sequences.getNumOutputChannels();
     const int numInChannels = sequences.getNumInputChannels();
-    const double sampleRate = sequences.getSampleRate();
+    const double outputSampleRate = sequences.getSampleRate();
+    const double sampleRate = outputSampleRate * oversamplingFactor;
     
     double totalTimeMs = 0.0;
     double tempoAtTheEndOfTrack = 0.0;
@@ -142,7 +223,8 @@ void RendererThread::run()
     double secPerQuarter = msPerQuarter / 1000.0;
 
     double currentFrame = 0.0;
-    const double lastFrame = totalTimeMs / 1000.0 * sampleRate;
+    const int64 numFramesToWrite = int64(totalTimeMs / 1000.0 * outputSampleRate);
+    int64 numFramesWritten = 0;
 
     // step 1. create a list of unique instruments with audio buffers for them.
     OwnedArray<RenderBuffer> subBuffers;
@@ -151,9 +233,22 @@ void RendererThread::run()
     for (int i = 0; i < uniqueInstruments.size(); ++i)
     {
         Instrument *instrument = uniqueInstruments[i];
+        AudioProcessorGraph *graph = instrument->getProcessorGraph();
         auto subBuffer = new RenderBuffer();
         subBuffer->instrument = instrument;
-        subBuffer->sampleBuffer = AudioSampleBuffer(numOutChannels, bufferSize);
+        subBuffer->deviceBlockSize = graph->getBlockSize();
+        subBuffer->isDoublePrecision = renderSettings.preferDoublePrecision &&
+            graph->supportsDoublePrecisionProcessing();
+
+        if (subBuffer->isDoublePrecision)
+        {
+            subBuffer->sampleBufferDouble = AudioBuffer<double>(numOutChannels, bufferSize);
+        }
+        else
+        {
+            subBuffer->sampleBuffer = AudioBuffer<float>(numOutChannels, bufferSize);
+        }
+
         subBuffers.add(subBuffer);
         //Logger::writeToLog("Adding instrument: " + String(instrument->getName()));
     }
@@ -164,8 +259,8 @@ void RendererThread::run()
         AudioProcessorGraph *graph = subBuffer->instrument->getProcessorGraph();
         graph->setPlayConfigDetails(numInChannels, numOutChannels, sampleRate, bufferSize);
         graph->releaseResources();
-        // TODO:
-        //graph->setProcessingPrecision(AudioProcessor::singlePrecision);
+        graph->setProcessingPrecision(subBuffer->isDoublePrecision ?
+            AudioProcessor::doublePrecision : AudioProcessor::singlePrecision);
         graph->prepareToPlay(graph->getSampleRate(), bufferSize);
         graph->setNonRealtime(true);
     }
@@ -173,6 +268,15 @@ void RendererThread::run()
     // let processor graphs call handle their async updates
     Thread::sleep(200);
 
+    // the disk is written on a separate thread, so that rendering never waits for it
+    this->writerThread.startThread(7);
+    ScopedPointer<AudioFormatWriter::ThreadedWriter> threadedWriter(
+        new AudioFormatWriter::ThreadedWriter(this->writer.release(),
+            this->writerThread, RENDERER_WRITER_FIFO_SIZE));
+
+    threadedWriter->setDataReceiver(&this->statistics);
+    this->statistics.start(numFramesToWrite, outputSampleRate);
+
     // step 3. render loop itself.
     sequences.seekToTime(0.0);
     
@@ -180,8 +284,26 @@ void RendererThread::run()
     bool hasNextMessage = sequences.getNextMessage(nextMessage);
     jassert(hasNextMessage);
     
-    // TODO: add double precision rendering someday (for processor graphs who support it)
-    AudioSampleBuffer mixingBuffer(numOutChannels, bufferSize);
+    // the mix is always summed in double precision
+    AudioBuffer<double> mixingBuffer(numOutChannels, bufferSize);
+
+    ScopedPointer<PolyphaseDecimator> decimator;
+    AudioBuffer<double> decimatedBuffer;
+    int numLatencyFramesToSkip = 0;
+
+    if (oversamplingFactor > 1)
+    {
+        decimator = new PolyphaseDecimator(oversamplingFactor, numOutChannels, bufferSize);
+        decimatedBuffer = AudioBuffer<double>(numOutChannels, outputBufferSize);
+        numLatencyFramesToSkip = decimator->getLatency();
+    }
+
+    AudioBuffer<float> outputBuffer(numOutChannels, outputBufferSize);
+
+    // TPDF dither of one least significant bit for the integer formats
+    const double ditherAmplitude = (renderSettings.dither && renderSettings.bitDepth < 32) ?
+        1.0 / double(1 << (renderSettings.bitDepth - 1)) : 0.0;
+    Random ditherRandom;
     
     double lastEventTick = 0.0;
     double prevEventTimeStamp = 0.0;
@@ -196,12 +318,14 @@ void RendererThread::run()
         subBuffer->midiBuffer.addEvent(MidiMessage::midiStart(), messageFrame);
     }
 
-    while (currentFrame < lastFrame)
+    while (numFramesWritten < numFramesToWrite)
     {
         if (this->threadShouldExit())
         {
             break;
         }
+
+        const int64 blockStart = Time::getHighResolutionTicks();
         
         // step 3a. fill up the midi buffers.
         while (hasNextMessage &&
@@ -241,18 +365,31 @@ void RendererThread::run()
         }
 
         // step 3b. call processBlock for every instrument.
-        for (auto subBuffer : subBuffers)
+        for (int i = 0; i < subBuffers.size(); ++i)
         {
+            auto *subBuffer = subBuffers.getUnchecked(i);
             AudioProcessorGraph *graph = subBuffer->instrument->getProcessorGraph();
+            const int64 processingStart = Time::getHighResolutionTicks();
+
             {
                 const ScopedLock lock(graph->getCallbackLock());
                 
                 //Logger::writeToLog("processBlock num midi events: " + String(subBuffer->midiBuffer.getNumEvents()));
-                graph->processBlock(subBuffer->sampleBuffer, subBuffer->midiBuffer);
-                subBuffer->midiBuffer.clear();
+                if (subBuffer->isDoublePrecision)
+                {
+                    graph->processBlock(subBuffer->sampleBufferDouble, subBuffer->midiBuffer);
+                }
+                else
+                {
+                    graph->processBlock(subBuffer->sampleBuffer, subBuffer->midiBuffer);
+                }
 
-                //Thread::yield();
+                subBuffer->midiBuffer.clear();
             }
+
+            const int64 processingTicks = Time::getHighResolutionTicks() - processingStart;
+            this->statistics.addInstrumentTime(i,
+                int64(Time::highResolutionTicksToSeconds(processingTicks) * 1000000.0));
         }
 
         // step 3c. mix them down to the render buffer.
@@ -262,51 +399,114 @@ void RendererThread::run()
         {
             for (int j = 0; j < numOutChannels; ++j)
             {
-                mixingBuffer.addFrom(j, 0,
-                    subBuffer->sampleBuffer, j, 0,
-                    bufferSize,
-                    1.0f);
+                if (subBuffer->isDoublePrecision)
+                {
+                    mixingBuffer.addFrom(j, 0, subBuffer->sampleBufferDouble, j, 0, bufferSize, 1.0);
+                }
+                else
+                {
+                    double *destination = mixingBuffer.getWritePointer(j);
+                    const float *source = subBuffer->sampleBuffer.getReadPointer(j);
+                    for (int i = 0; i < bufferSize; ++i)
+                    {
+                        destination[i] += double(source[i]);
+                    }
+                }
             }
         }
 
-        // step 3d. write resulting buffer to disk.
+        // step 3d. get back to the project sample rate, if oversampled.
+        const AudioBuffer<double> *mix = &mixingBuffer;
+
+        if (decimator != nullptr)
         {
-            const ScopedLock sl(this->writerLock);
-            bool writedSuccessfullty = false;
-            
-            while (! writedSuccessfullty)
+            decimator->process(mixingBuffer.getArrayOfReadPointers(),
+                decimatedBuffer.getArrayOfWritePointers(), bufferSize);
+
+            mix = &decimatedBuffer;
+        }
+
+        // the decimator's delay is compensated by skipping its first output frames
+        const int numSkippedFrames = jmin(numLatencyFramesToSkip, outputBufferSize);
+        numLatencyFramesToSkip -= numSkippedFrames;
+
+        const int numFramesToWriteNow = int(jmin(int64(outputBufferSize - numSkippedFrames),
+            numFramesToWrite - numFramesWritten));
+
+        // step 3e. convert to the output precision, with dither if needed.
+        for (int j = 0; j < numOutChannels && numFramesToWriteNow > 0; ++j)
+        {
+            const double *source = mix->getReadPointer(j, numSkippedFrames);
+            float *destination = outputBuffer.getWritePointer(j);
+
+            for (int i = 0; i < numFramesToWriteNow; ++i)
             {
-                writedSuccessfullty =
-                this->writer->writeFromAudioSampleBuffer(mixingBuffer, 0, mixingBuffer.getNumSamples());
+                const double dither = (ditherAmplitude > 0.0) ?
+                    (ditherRandom.nextDouble() - ditherRandom.nextDouble()) * ditherAmplitude : 0.0;
+
+                destination[i] = float(source[i] + dither);
             }
         }
 
-        // step 3e. finally, update counters.
-        currentFrame += bufferSize;
+        // the disk writer is not a part of the load, it has its own thread
+        this->statistics.addBlockTime(outputBufferSize, Time::getHighResolutionTicks() - blockStart);
 
+        // step 3f. queue resulting buffer for the disk writer,
+        // waiting for it only if it's too far behind
+        if (numFramesToWriteNow > 0)
         {
-            const ScopedWriteLock pl(this->percentsLock);
-            this->percentsDone = float(currentFrame / lastFrame);
-            //Logger::writeToLog("this->percentsDone : " + String(this->percentsDone));
+            while (! threadedWriter->write(outputBuffer.getArrayOfReadPointers(), numFramesToWriteNow))
+            {
+                if (this->threadShouldExit())
+                {
+                    break;
+                }
+
+                Thread::sleep(1);
+            }
+
+            this->statistics.addFramesQueued(numFramesToWriteNow);
         }
+
+        // step 3g. finally, update counters.
+        currentFrame += bufferSize;
+        numFramesWritten += numFramesToWriteNow;
+        this->statistics.addFramesRendered(numFramesToWriteNow);
     }
 
-    // step 4. setNonRealtime false.
+    this->statistics.finish();
+
+    // step 4. setNonRealtime false, and get back to the device settings.
     for (auto subBuffer : subBuffers)
     {
         AudioProcessorGraph *graph = subBuffer->instrument->getProcessorGraph();
         graph->setNonRealtime(false);
+
+        // the graph was prepared for the render block size anyway
+        if (subBuffer->deviceBlockSize > 0)
+        {
+            graph->releaseResources();
+            graph->setProcessingPrecision(AudioProcessor::singlePrecision);
+            graph->setPlayConfigDetails(numInChannels, numOutChannels,
+                outputSampleRate, subBuffer->deviceBlockSize);
+            graph->prepareToPlay(outputSampleRate, subBuffer->deviceBlockSize);
+        }
     }
     
-    {
-        const ScopedLock sl(this->writerLock);
-        this->writer = nullptr;
-    }
+    // flushes all the pending data
+    threadedWriter = nullptr;
+    this->writerThread.stopThread(1000);
     
     if (! this->threadShouldExit())
     {
         // dirty hack
         App::Workspace().getAudioCore().unmute();
         App::Workspace().getAudioCore().unmute();
+
+        if (this->freezeCallback != nullptr)
+        {
+            const auto callback = this->freezeCallback;
+            MessageManager::callAsync([callback]() { callback(true); });
+        }
     }
 }
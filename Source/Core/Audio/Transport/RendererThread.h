@@ -18,6 +18,7 @@
 #pragma once
 
 #include "Transport.h"
+#include "RenderStatistics.h"
 
 class RendererThread final : private Thread
 {
@@ -27,11 +28,17 @@ public:
     ~RendererThread() override;
     
     float getPercentsComplete() const;
+    const RenderStatistics &getStatistics() const noexcept;
 
-    void startRecording(const File &file);
+    void startRecording(const File &file, const RenderSettings &renderSettings);
     void stop();
     bool isRecording() const;
 
+    // Renders given sequences only (like a single track along with tempo events)
+    // into a 32-bit float wave file; the callback is called on the message thread
+    using FreezeCallback = Function<void(bool succeeded)>;
+    void startFreezing(const File &file, const ProjectSequences &sequences, FreezeCallback callback);
+
 private:
 
     //===------------------------------------------------------------------===//
@@ -44,11 +51,16 @@ private:
 
     Transport &transport;
 
-    CriticalSection writerLock;
+    TimeSliceThread writerThread;
     ScopedPointer<AudioFormatWriter> writer;
 
-    ReadWriteLock percentsLock;
-    float percentsDone;
+    RenderSettings settings;
+
+    // when set, renders these instead of all the project's sequences
+    ScopedPointer<ProjectSequences> sequencesToFreeze;
+    FreezeCallback freezeCallback;
+
+    RenderStatistics statistics;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RendererThread)
 };
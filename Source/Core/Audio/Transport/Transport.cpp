@@ -32,6 +32,10 @@
 #include "HybridRoll.h"
 #include "SerializationKeys.h"
 #include "PlayerThreadPool.h"
+#include "FrozenTracksPlayer.h"
+#include "MixingEngine.h"
+#include "DocumentHelpers.h"
+#include "Profiler.h"
 
 Transport::Transport(OrchestraPit &orchestraPit) :
     orchestra(orchestraPit),
@@ -44,18 +48,35 @@ Transport::Transport(OrchestraPit &orchestraPit) :
     loopStart(0.0),
     loopEnd(0.0),
     projectFirstBeat(0.f),
-    projectLastBeat(DEFAULT_NUM_BARS * BEATS_PER_BAR)
+    projectLastBeat(DEFAULT_NUM_BARS * BEATS_PER_BAR),
+    frozenTracksBypassed(false),
+    frozenTracksAreOutdated(0)
 {
     this->player = new PlayerThreadPool(*this);
     this->renderer = new RendererThread(*this);
+    this->freezer = new RendererThread(*this);
+    this->frozenTracksPlayer = new FrozenTracksPlayer();
+    App::Workspace().getAudioCore().getMixingEngine()->addAudioCallback(this->frozenTracksPlayer);
     this->orchestra.addOrchestraListener(this);
 }
 
 Transport::~Transport()
 {
     this->orchestra.removeOrchestraListener(this);
+    this->stopObservingInstruments();
+
+    if (this->freezer->isRecording())
+    {
+        this->freezer->stop();
+        App::Workspace().getAudioCore().unmute();
+    }
+
+    this->freezer = nullptr;
     this->renderer = nullptr;
     this->player = nullptr;
+
+    App::Workspace().getAudioCore().getMixingEngine()->removeAudioCallback(this->frozenTracksPlayer);
+    this->frozenTracksPlayer = nullptr;
     this->transportListeners.clear();
 }
 
@@ -162,7 +183,7 @@ void Transport::probeSoundAt(double absTrackPosition, const MidiSequence *limitT
                 {
                     MidiMessage messageTimestampedAsNow(noteOnHolder->message);
                     messageTimestampedAsNow.setTimeStamp(Time::getMillisecondCounterHiRes() * 0.001);
-                    seq->listener->addMessageToQueue(messageTimestampedAsNow);
+                    seq->listener->push(messageTimestampedAsNow);
                 }
             }
         }
@@ -187,7 +208,7 @@ void Transport::probeSequence(const MidiMessageSequence &sequence)
     wrapper->midiMessages = fixedSequence;
     wrapper->currentIndex = 0;
     wrapper->instrument = targetInstrument;
-    wrapper->listener = &targetInstrument->getProcessorPlayer().getMidiMessageCollector();
+    wrapper->listener = &targetInstrument->getProcessorPlayer().getMidiEventQueue();
     this->sequences.addWrapper(wrapper);
 
     if (this->player->isPlaying())
@@ -201,6 +222,7 @@ void Transport::probeSequence(const MidiMessageSequence &sequence)
 
 void Transport::startPlayback()
 {
+    this->validateFrozenTracks();
     this->rebuildSequencesIfNeeded();
     if (this->player->isPlaying())
     {
@@ -210,11 +232,13 @@ void Transport::startPlayback()
     
     this->loopedMode = false;
     this->player->startPlayback();
+    this->startFrozenTracksAt(this->getSeekPosition());
     this->broadcastPlay();
 }
 
 void Transport::startPlaybackLooped(double absLoopStart, double absLoopEnd)
 {
+    this->validateFrozenTracks();
     this->rebuildSequencesIfNeeded();
     
     if (this->player->isPlaying())
@@ -228,6 +252,7 @@ void Transport::startPlaybackLooped(double absLoopStart, double absLoopEnd)
     this->loopEnd = jmin(1.0, absLoopEnd);
     
     this->player->startPlayback();
+    this->startFrozenTracksAt(this->loopStart);
     this->broadcastPlay();
 }
 
@@ -236,6 +261,7 @@ void Transport::stopPlayback()
     if (this->player->isPlaying())
     {
         this->player->stopPlayback();
+        this->frozenTracksPlayer->stopPlayback();
         this->allNotesControllersAndSoundOff();
         this->loopedMode = false;
         this->seekToPosition(this->getSeekPosition());
@@ -269,7 +295,7 @@ double Transport::getLoopEnd() const
 }
 
 
-void Transport::startRender(const String &fileName)
+void Transport::startRender(const String &fileName, const RenderSettings &settings)
 {
     if (this->renderer->isRecording())
     {
@@ -277,9 +303,13 @@ void Transport::startRender(const String &fileName)
     }
     
     App::Workspace().getAudioCore().mute();
+
+    // the export needs all tracks, frozen ones included, to be rendered by their instruments
+    this->frozenTracksBypassed = true;
+    this->sequencesAreOutdated = true;
     
     File file(File::getCurrentWorkingDirectory().getChildFile(fileName));
-    this->renderer->startRecording(file);
+    this->renderer->startRecording(file, settings);
 }
 
 void Transport::stopRender()
@@ -307,6 +337,11 @@ float Transport::getRenderingPercentsComplete() const
     return this->renderer->getPercentsComplete();
 }
 
+const RenderStatistics &Transport::getRenderStatistics() const noexcept
+{
+    return this->renderer->getStatistics();
+}
+
 
 //===----------------------------------------------------------------------===//
 // Sending messages at real-time
@@ -314,19 +349,33 @@ float Transport::getRenderingPercentsComplete() const
 
 void Transport::sendMidiMessage(const String &layerId, const MidiMessage &message) const
 {
+    auto *instrument = this->linksCache[layerId];
+    if (instrument == nullptr)
+    {
+        return;
+    }
+
     MidiMessage messageTimestampedAsNow(message);
     
 #if HELIO_MOBILE
     // iSEM tends to hang >_< if too many messages are send simultaniously
-    messageTimestampedAsNow.setTimeStamp(Time::getMillisecondCounter() + (rand() % 50));
+    messageTimestampedAsNow.setTimeStamp((Time::getMillisecondCounterHiRes() + (rand() % 50)) * 0.001);
 #elif HELIO_DESKTOP
     messageTimestampedAsNow.setTimeStamp(Time::getMillisecondCounterHiRes() * 0.001);
 #endif
     
-    MidiMessageCollector *collector =
-    &this->linksCache[layerId]->getProcessorPlayer().getMidiMessageCollector();
-    
-    collector->addMessageToQueue(messageTimestampedAsNow);
+    instrument->getProcessorPlayer().getMidiEventQueue().push(messageTimestampedAsNow);
+}
+
+void Transport::sendMidiMessageToAllInstruments(const MidiMessage &message) const
+{
+    MidiMessage messageTimestampedAsNow(message);
+    messageTimestampedAsNow.setTimeStamp(Time::getMillisecondCounterHiRes() * 0.001);
+
+    for (auto *queue : this->linkedQueues)
+    {
+        queue->push(messageTimestampedAsNow);
+    }
 }
 
 void Transport::allNotesAndControllersOff() const
@@ -334,25 +383,8 @@ void Transport::allNotesAndControllersOff() const
     const int c = 1;
     //for (int c = 1; c <= 16; ++c)
     {
-        const MidiMessage notesOff(MidiMessage::allNotesOff(c));
-        const MidiMessage controllersOff(MidiMessage::allControllersOff(c));
-        
-        Array<MidiMessageCollector *>duplicateCollectors;
-        
-        for (int l = 0; l < this->tracksCache.size(); ++l)
-        {
-            const String &trackId = this->tracksCache.getUnchecked(l)->getTrackId();
-            
-            MidiMessageCollector *collector =
-                &this->linksCache[trackId]->getProcessorPlayer().getMidiMessageCollector();
-            
-            if (! duplicateCollectors.contains(collector))
-            {
-                this->sendMidiMessage(trackId, notesOff);
-                this->sendMidiMessage(trackId, controllersOff);
-                duplicateCollectors.add(collector);
-            }
-        }
+        this->sendMidiMessageToAllInstruments(MidiMessage::allNotesOff(c));
+        this->sendMidiMessageToAllInstruments(MidiMessage::allControllersOff(c));
     }
 }
 
@@ -361,27 +393,9 @@ void Transport::allNotesControllersAndSoundOff() const
     const int c = 1;
     //for (int c = 1; c <= 16; ++c)
     {
-        const MidiMessage notesOff(MidiMessage::allNotesOff(c));
-        const MidiMessage soundOff(MidiMessage::allSoundOff(c));
-        const MidiMessage controllersOff(MidiMessage::allControllersOff(c));
-        
-        Array<MidiMessageCollector *>duplicateCollectors;
-        
-        for (int l = 0; l < this->tracksCache.size(); ++l)
-        {
-            const String &trackId = this->tracksCache.getUnchecked(l)->getTrackId();
-            
-            MidiMessageCollector *collector =
-               &this->linksCache[trackId]->getProcessorPlayer().getMidiMessageCollector();
-            
-            if (! duplicateCollectors.contains(collector))
-            {
-                this->sendMidiMessage(trackId, notesOff);
-                this->sendMidiMessage(trackId, controllersOff);
-                this->sendMidiMessage(trackId, soundOff);
-                duplicateCollectors.add(collector);
-            }
-        }
+        this->sendMidiMessageToAllInstruments(MidiMessage::allNotesOff(c));
+        this->sendMidiMessageToAllInstruments(MidiMessage::allControllersOff(c));
+        this->sendMidiMessageToAllInstruments(MidiMessage::allSoundOff(c));
     }
 }
 
@@ -401,6 +415,11 @@ void Transport::instrumentAdded(Instrument *instrument)
     {
         this->updateLinkForTrack(this->tracksCache.getUnchecked(i));
     }
+
+    this->instantiateLinkedInstruments();
+    this->updateLinkedQueues();
+    this->updateObservedInstruments();
+    this->frozenTracksAreOutdated = 1;
 }
 
 void Transport::instrumentRemoved(Instrument *instrument)
@@ -408,6 +427,7 @@ void Transport::instrumentRemoved(Instrument *instrument)
     // the instrument stack have still not changed here,
     // so just stop the playback before it's too late
     this->stopPlayback();
+    this->stopObservingInstruments();
 }
 
 void Transport::instrumentRemovedPostAction()
@@ -418,6 +438,32 @@ void Transport::instrumentRemovedPostAction()
     {
         this->updateLinkForTrack(this->tracksCache.getUnchecked(i));
     }
+
+    this->instantiateLinkedInstruments();
+    this->updateLinkedQueues();
+    this->updateObservedInstruments();
+    this->frozenTracksAreOutdated = 1;
+}
+
+//===----------------------------------------------------------------------===//
+// ChangeListener, AudioProcessorListener
+//===----------------------------------------------------------------------===//
+
+void Transport::changeListenerCallback(ChangeBroadcaster *source)
+{
+    // some instrument's graph has changed, and its nodes might have too
+    this->updateObservedInstruments();
+    this->frozenTracksAreOutdated = 1;
+}
+
+void Transport::audioProcessorParameterChanged(AudioProcessor *, int, float)
+{
+    this->frozenTracksAreOutdated = 1;
+}
+
+void Transport::audioProcessorChanged(AudioProcessor *)
+{
+    this->frozenTracksAreOutdated = 1;
 }
 
 //===----------------------------------------------------------------------===//
@@ -437,6 +483,8 @@ void Transport::onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent &ne
     // and getTrackControllerNumber == 0 (not an automation)
     this->stopPlayback();
     updateLengthAndTimeIfNeeded((&newEvent));
+    this->setFrozenTracksOutdatedFor(newEvent.getSequence()->getTrackId(),
+        newEvent.getTrackControllerNumber());
     this->sequencesAreOutdated = true;
 }
 
@@ -446,6 +494,8 @@ void Transport::onAddMidiEvent(const MidiEvent &event)
     // and getTrackControllerNumber == 0 (not an automation)
     this->stopPlayback();
     updateLengthAndTimeIfNeeded((&event));
+    this->setFrozenTracksOutdatedFor(event.getSequence()->getTrackId(),
+        event.getTrackControllerNumber());
     this->sequencesAreOutdated = true;
 }
 
@@ -454,6 +504,8 @@ void Transport::onPostRemoveMidiEvent(MidiSequence *const sequence)
 {
     this->stopPlayback();
     updateLengthAndTimeIfNeeded(sequence->getTrack());
+    this->setFrozenTracksOutdatedFor(sequence->getTrackId(),
+        sequence->getTrack()->getTrackControllerNumber());
     this->sequencesAreOutdated = true;
 }
 
@@ -461,6 +513,7 @@ void Transport::onAddClip(const Clip &clip)
 {
     this->stopPlayback();
     updateLengthAndTimeIfNeeded((&clip));
+    this->setFrozenTracksOutdatedFor(clip.getTrackId(), clip.getTrackControllerNumber());
     this->sequencesAreOutdated = true;
 }
 
@@ -468,6 +521,7 @@ void Transport::onChangeClip(const Clip &oldClip, const Clip &newClip)
 {
     this->stopPlayback();
     updateLengthAndTimeIfNeeded((&newClip));
+    this->setFrozenTracksOutdatedFor(newClip.getTrackId(), newClip.getTrackControllerNumber());
     this->sequencesAreOutdated = true;
 }
 
@@ -476,6 +530,8 @@ void Transport::onPostRemoveClip(Pattern *const pattern)
 {
     this->stopPlayback();
     updateLengthAndTimeIfNeeded(pattern->getTrack());
+    this->setFrozenTracksOutdatedFor(pattern->getTrackId(),
+        pattern->getTrack()->getTrackControllerNumber());
     this->sequencesAreOutdated = true;
 }
 
@@ -489,6 +545,10 @@ void Transport::onChangeTrackProperties(MidiTrack *const track)
         this->stopPlayback();
         this->sequencesAreOutdated = true;
         this->updateLinkForTrack(track);
+        this->instantiateLinkedInstruments();
+        this->updateLinkedQueues();
+        this->updateObservedInstruments();
+        this->setFrozenTracksOutdatedFor(track->getTrackId(), track->getTrackControllerNumber());
     }
 }
 
@@ -505,6 +565,11 @@ void Transport::onReloadProjectContent(const Array<MidiTrack *> &tracks)
         this->updateLinkForTrack(track);
     }
 
+    this->instantiateLinkedInstruments();
+    this->updateLinkedQueues();
+    this->updateObservedInstruments();
+    this->frozenTracksAreOutdated = 1;
+
     this->stopPlayback();
 }
 
@@ -515,6 +580,8 @@ void Transport::onAddTrack(MidiTrack *const track)
     this->sequencesAreOutdated = true;
     this->tracksCache.addIfNotAlreadyThere(track);
     this->updateLinkForTrack(track);
+    this->instantiateLinkedInstruments();
+    this->updateLinkedQueues();
 }
 
 void Transport::onRemoveTrack(MidiTrack *const track)
@@ -524,11 +591,14 @@ void Transport::onRemoveTrack(MidiTrack *const track)
     this->sequencesAreOutdated = true;
     this->tracksCache.removeAllInstancesOf(track);
     this->removeLinkForTrack(track);
+    this->updateLinkedQueues();
+    this->setFrozenTracksOutdatedFor(track->getTrackId(), track->getTrackControllerNumber());
 }
 
 void Transport::onChangeProjectBeatRange(float firstBeat, float lastBeat)
 {
     this->stopPlayback();
+    this->frozenTracksAreOutdated = 1;
     
     const double seekBeat = double(this->projectFirstBeat.get()) +
         double(this->projectLastBeat.get() - this->projectFirstBeat.get()) * this->seekPosition.get(); // may be 0
@@ -633,33 +703,21 @@ void Transport::rebuildSequencesIfNeeded()
 {
     if (this->sequencesAreOutdated)
     {
+        PROFILE_SCOPE("Transport::rebuildSequences");
+
         this->sequences.clear();
-        static Clip noTransform;
-        const double offset = -this->trackStartMs.get();
 
         for (const auto *track : this->tracksCache)
         {
-            auto *instrument = this->linksCache[track->getTrackId()];
-            jassert(instrument != nullptr);
-
-            ScopedPointer<SequenceWrapper> wrapper(new SequenceWrapper());
-            wrapper->track = track->getSequence();
-            wrapper->currentIndex = 0;
-            wrapper->instrument = instrument;
-            wrapper->listener = &instrument->getProcessorPlayer().getMidiMessageCollector();
-
-            if (track->getPattern() != nullptr)
+            // frozen tracks are played back as audio
+            if (!this->frozenTracksBypassed &&
+                this->frozenTracks.contains(track->getTrackId()))
             {
-                for (const auto *clip : track->getPattern()->getClips())
-                {
-                    wrapper->track->exportMidi(wrapper->midiMessages, *clip, offset, 1.0);
-                }
-            }
-            else
-            {
-                wrapper->track->exportMidi(wrapper->midiMessages, noTransform, offset, 1.0);
+                continue;
             }
 
+            ScopedPointer<SequenceWrapper> wrapper(this->createSequenceWrapper(track));
+
             if (wrapper->midiMessages.getNumEvents() > 0)
             {
                 this->sequences.addWrapper(wrapper.release());
@@ -670,6 +728,47 @@ void Transport::rebuildSequencesIfNeeded()
     }
 }
 
+SequenceWrapper *Transport::createSequenceWrapper(const MidiTrack *track) const
+{
+    static Clip noTransform;
+    const double offset = -this->trackStartMs.get();
+
+    auto *instrument = this->linksCache[track->getTrackId()];
+    jassert(instrument != nullptr);
+
+    auto *wrapper = new SequenceWrapper();
+    wrapper->track = track->getSequence();
+    wrapper->currentIndex = 0;
+    wrapper->instrument = instrument;
+    wrapper->listener = &instrument->getProcessorPlayer().getMidiEventQueue();
+
+    if (track->getPattern() != nullptr)
+    {
+        for (const auto *clip : track->getPattern()->getClips())
+        {
+            wrapper->track->exportMidi(wrapper->midiMessages, *clip, offset, 1.0);
+        }
+    }
+    else
+    {
+        wrapper->track->exportMidi(wrapper->midiMessages, noTransform, offset, 1.0);
+    }
+
+    return wrapper;
+}
+
+Array<Instrument *> Transport::getLinkedInstruments() const
+{
+    Array<Instrument *> result;
+    HashMap<String, Instrument *>::Iterator i(this->linksCache);
+    while (i.next())
+    {
+        result.addIfNotAlreadyThere(i.getValue());
+    }
+
+    return result;
+}
+
 ProjectSequences Transport::getSequences()
 {
     const SpinLock::ScopedLockType l(this->sequencesLock);
@@ -715,6 +814,310 @@ void Transport::removeLinkForTrack(const MidiTrack *track)
     this->linksCache.remove(track->getTrackId());
 }
 
+void Transport::updateLinkedQueues()
+{
+    this->linkedQueues.clearQuick();
+
+    for (HashMap<String, Instrument *>::Iterator i(this->linksCache); i.next();)
+    {
+        if (auto *instrument = i.getValue())
+        {
+            this->linkedQueues.addIfNotAlreadyThere(&instrument->getProcessorPlayer().getMidiEventQueue());
+        }
+    }
+}
+
+void Transport::instantiateLinkedInstruments()
+{
+    for (HashMap<String, Instrument *>::Iterator i(this->linksCache); i.next();)
+    {
+        if (auto *instrument = i.getValue())
+        {
+            instrument->instantiateIfNeeded();
+        }
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Track freezing
+//===----------------------------------------------------------------------===//
+
+void Transport::freezeTrack(const MidiTrack *track)
+{
+    // only the tracks that make sounds can be frozen, not automations
+    if (track == nullptr || track->getTrackControllerNumber() != 0 ||
+        this->isRendering() || this->isFreezing())
+    {
+        return;
+    }
+
+    this->stopPlayback();
+
+    const String hash = this->getFreezeHash(track);
+    const File cacheFile = this->getFreezeCacheFile(hash);
+
+    this->freezingTrackId = track->getTrackId();
+    this->freezingHash = hash;
+
+    if (cacheFile.existsAsFile())
+    {
+        this->onTrackFrozen(true);
+        return;
+    }
+
+    // the track is rendered along with tempo events, which are sent to all instruments anyway
+    ProjectSequences trackSequences;
+    ScopedPointer<SequenceWrapper> trackWrapper(this->createSequenceWrapper(track));
+    if (trackWrapper->midiMessages.getNumEvents() == 0)
+    {
+        return;
+    }
+
+    for (const auto *tempoTrack : this->tracksCache)
+    {
+        if (tempoTrack->isTempoTrack())
+        {
+            auto *tempoWrapper = this->createSequenceWrapper(tempoTrack);
+            tempoWrapper->instrument = trackWrapper->instrument;
+            tempoWrapper->listener = trackWrapper->listener;
+            trackSequences.addWrapper(tempoWrapper);
+        }
+    }
+
+    trackSequences.addWrapper(trackWrapper.release());
+
+    // offline rendering calls the instrument graph directly
+    App::Workspace().getAudioCore().mute();
+
+    const File temporaryFile(cacheFile.getSiblingFile(cacheFile.getFileNameWithoutExtension() + ".tmp"));
+    WeakReference<Transport> weakThis(this);
+    this->freezer->startFreezing(temporaryFile, trackSequences,
+        [weakThis, temporaryFile, cacheFile](bool succeeded)
+        {
+            const bool moved = succeeded && temporaryFile.moveFileTo(cacheFile);
+            if (weakThis != nullptr)
+            {
+                weakThis->onTrackFrozen(moved);
+            }
+        });
+
+    if (!this->freezer->isRecording())
+    {
+        App::Workspace().getAudioCore().unmute();
+    }
+}
+
+void Transport::unfreezeTrack(const MidiTrack *track)
+{
+    if (track == nullptr || !this->frozenTracks.contains(track->getTrackId()))
+    {
+        return;
+    }
+
+    this->stopPlayback();
+    this->frozenTracks.remove(track->getTrackId());
+    this->frozenTracksPlayer->removeTrack(track->getTrackId());
+    this->sequencesAreOutdated = true;
+    this->updateObservedInstruments();
+}
+
+bool Transport::isTrackFrozen(const MidiTrack *track) const
+{
+    return track != nullptr && this->frozenTracks.contains(track->getTrackId());
+}
+
+bool Transport::isFreezing() const
+{
+    return this->freezer->isRecording();
+}
+
+void Transport::onTrackFrozen(bool succeeded)
+{
+    if (succeeded &&
+        this->frozenTracksPlayer->addTrack(this->freezingTrackId,
+            this->getFreezeCacheFile(this->freezingHash)))
+    {
+        this->frozenTracks.set(this->freezingTrackId, this->freezingHash);
+        this->sequencesAreOutdated = true;
+        this->updateObservedInstruments();
+    }
+
+    this->freezingTrackId = {};
+    this->freezingHash = {};
+}
+
+void Transport::setFrozenTracksOutdatedFor(const String &trackId, int trackControllerNumber)
+{
+    // tempo changes affect all frozen tracks
+    if (trackControllerNumber == MidiTrack::tempoController ||
+        this->frozenTracks.contains(trackId))
+    {
+        this->frozenTracksAreOutdated = 1;
+    }
+}
+
+void Transport::updateObservedInstruments()
+{
+    this->stopObservingInstruments();
+
+    for (HashMap<String, String>::Iterator i(this->frozenTracks); i.next();)
+    {
+        auto *instrument = this->linksCache[i.getKey()];
+        if (instrument == nullptr || this->observedInstruments.contains(instrument))
+        {
+            continue;
+        }
+
+        this->observedInstruments.add(instrument);
+        instrument->addChangeListener(this);
+
+        // the nodes are held, so that their processors
+        // are still there when we stop listening to them
+        for (int j = 0; j < instrument->getNumNodes(); ++j)
+        {
+            const auto node = instrument->getNode(j);
+            if (node != nullptr && node->getProcessor() != nullptr)
+            {
+                node->getProcessor()->addListener(this);
+                this->observedNodes.add(node);
+            }
+        }
+    }
+}
+
+void Transport::stopObservingInstruments()
+{
+    for (auto *node : this->observedNodes)
+    {
+        node->getProcessor()->removeListener(this);
+    }
+
+    for (auto *instrument : this->observedInstruments)
+    {
+        instrument->removeChangeListener(this);
+    }
+
+    this->observedNodes.clear();
+    this->observedInstruments.clearQuick();
+}
+
+String Transport::getFreezeHash(const MidiTrack *track)
+{
+    MemoryOutputStream data;
+
+    auto writeSequence = [&data](const MidiMessageSequence &sequence)
+    {
+        for (int i = 0; i < sequence.getNumEvents(); ++i)
+        {
+            const auto &message = sequence.getEventPointer(i)->message;
+            data.writeDouble(message.getTimeStamp());
+            data.write(message.getRawData(), size_t(message.getRawDataSize()));
+        }
+    };
+
+    const ScopedPointer<SequenceWrapper> trackWrapper(this->createSequenceWrapper(track));
+    writeSequence(trackWrapper->midiMessages);
+
+    for (const auto *tempoTrack : this->tracksCache)
+    {
+        if (tempoTrack->isTempoTrack())
+        {
+            const ScopedPointer<SequenceWrapper> tempoWrapper(this->createSequenceWrapper(tempoTrack));
+            writeSequence(tempoWrapper->midiMessages);
+        }
+    }
+
+    // the project range defines the rendered length
+    data.writeDouble(this->trackStartMs.get());
+    data.writeDouble(this->getTotalTime());
+
+    if (auto *instrument = trackWrapper->instrument)
+    {
+        data.writeString(instrument->getIdAndHash());
+        instrument->serialize().writeToStream(data);
+
+        auto *graph = instrument->getProcessorGraph();
+        data.writeDouble(graph->getSampleRate());
+        data.writeInt(graph->getTotalNumOutputChannels());
+    }
+
+    return MD5(data.getData(), data.getDataSize()).toHexString();
+}
+
+File Transport::getFreezeCacheFile(const String &hash) const
+{
+    const File cacheFolder(File(DocumentHelpers::getTemporaryFolder()).getChildFile("FrozenTracks"));
+    cacheFolder.createDirectory();
+    return cacheFolder.getChildFile(hash + ".wav");
+}
+
+// Called before each playback to drop the caches of the tracks that have changed
+// since they were frozen, and to load the caches that are still valid;
+// does nothing unless any of their events, tempo, range or instruments has changed
+void Transport::validateFrozenTracks()
+{
+    if (this->frozenTracksBypassed && !this->isRendering())
+    {
+        this->frozenTracksBypassed = false;
+        this->sequencesAreOutdated = true;
+    }
+
+    if (this->frozenTracksAreOutdated.exchange(0) == 0)
+    {
+        return;
+    }
+
+    StringArray outdatedTrackIds;
+
+    for (HashMap<String, String>::Iterator i(this->frozenTracks); i.next();)
+    {
+        const MidiTrack *track = nullptr;
+        for (const auto *t : this->tracksCache)
+        {
+            if (t->getTrackId() == i.getKey())
+            {
+                track = t;
+                break;
+            }
+        }
+
+        const File cacheFile = this->getFreezeCacheFile(i.getValue());
+
+        if (track == nullptr ||
+            this->getFreezeHash(track) != i.getValue() ||
+            !cacheFile.existsAsFile())
+        {
+            outdatedTrackIds.add(i.getKey());
+        }
+        else if (!this->frozenTracksPlayer->hasTrack(i.getKey()) &&
+            !this->frozenTracksPlayer->addTrack(i.getKey(), cacheFile))
+        {
+            outdatedTrackIds.add(i.getKey());
+        }
+    }
+
+    for (const auto &trackId : outdatedTrackIds)
+    {
+        Logger::writeToLog("Frozen track is outdated: " + trackId);
+        this->frozenTracks.remove(trackId);
+        this->frozenTracksPlayer->removeTrack(trackId);
+        this->sequencesAreOutdated = true;
+    }
+
+    if (!outdatedTrackIds.isEmpty())
+    {
+        this->updateObservedInstruments();
+    }
+}
+
+void Transport::startFrozenTracksAt(double absPosition)
+{
+    double timeMs = 0.0;
+    double tempo = 0.0;
+    this->calcTimeAndTempoAt(absPosition, timeMs, tempo);
+    this->frozenTracksPlayer->startPlayback(timeMs / 1000.0);
+}
+
 //===----------------------------------------------------------------------===//
 // Transport Listeners
 //===----------------------------------------------------------------------===//
@@ -767,6 +1170,15 @@ ValueTree Transport::serialize() const
     using namespace Serialization;
     ValueTree tree(Audio::transport);
     tree.setProperty(Audio::transportSeekPosition, this->getSeekPosition(), nullptr);
+
+    for (HashMap<String, String>::Iterator i(this->frozenTracks); i.next();)
+    {
+        ValueTree frozenTrack(Audio::frozenTrack);
+        frozenTrack.setProperty(Audio::frozenTrackId, i.getKey(), nullptr);
+        frozenTrack.setProperty(Audio::frozenTrackHash, i.getValue(), nullptr);
+        tree.appendChild(frozenTrack, nullptr);
+    }
+
     return tree;
 }
 
@@ -778,6 +1190,28 @@ void Transport::deserialize(const ValueTree &tree)
         tree : tree.getChildWithName(Audio::transport);
     const float seek = root.getProperty(Audio::transportSeekPosition, 0.f);
     this->seekToPosition(seek);
+
+    // caches are checked and loaded before the playback starts
+    forEachValueTreeChildWithType(root, frozenTrack, Audio::frozenTrack)
+    {
+        this->frozenTracks.set(frozenTrack.getProperty(Audio::frozenTrackId),
+            frozenTrack.getProperty(Audio::frozenTrackHash));
+    }
+
+    this->updateObservedInstruments();
+    this->frozenTracksAreOutdated = 1;
+    this->sequencesAreOutdated = true;
 }
 
-void Transport::reset() {}
+void Transport::reset()
+{
+    this->frozenTracksPlayer->stopPlayback();
+
+    for (HashMap<String, String>::Iterator i(this->frozenTracks); i.next();)
+    {
+        this->frozenTracksPlayer->removeTrack(i.getKey());
+    }
+
+    this->frozenTracks.clear();
+    this->stopObservingInstruments();
+}
@@ -22,15 +22,20 @@ class OrchestraPit;
 class PlayerThread;
 class PlayerThreadPool;
 class RendererThread;
+class FrozenTracksPlayer;
+class RenderStatistics;
 
 #include "TransportListener.h"
 #include "ProjectSequencesWrapper.h"
+#include "RenderSettings.h"
 #include "ProjectListener.h"
 #include "OrchestraListener.h"
 
 class Transport final : public Serializable,
                         public ProjectListener,
-                        private OrchestraListener
+                        private OrchestraListener,
+                        private ChangeListener, // watches the frozen tracks' instruments
+                        private AudioProcessorListener // and their plugins' parameters
 {
 public:
 
@@ -66,9 +71,10 @@ public:
     void stopPlayback();
     void toggleStatStopPlayback();
 
-    void startRender(const String &filename);
+    void startRender(const String &filename, const RenderSettings &settings = {});
     bool isRendering() const;
     void stopRender();
+    const RenderStatistics &getRenderStatistics() const noexcept;
     
     float getRenderingPercentsComplete() const;
     
@@ -78,11 +84,28 @@ public:
 
     MidiMessage findFirstTempoEvent();
 
+    // Unique instruments the tracks are currently linked to
+    Array<Instrument *> getLinkedInstruments() const;
+
+    //===------------------------------------------------------------------===//
+    // Track freezing
+    //===------------------------------------------------------------------===//
+
+    // Renders the track through its instrument into a cached audio file,
+    // which is played back instead of running the instrument live;
+    // the cache is keyed by the hash of the track's events, tempo and instrument state,
+    // and gets dropped as soon as any of those changes
+    void freezeTrack(const MidiTrack *track);
+    void unfreezeTrack(const MidiTrack *track);
+    bool isTrackFrozen(const MidiTrack *track) const;
+    bool isFreezing() const;
+
     //===------------------------------------------------------------------===//
     // Sending messages at real-time
     //===------------------------------------------------------------------===//
     
     void sendMidiMessage(const String &layerId, const MidiMessage &message) const;
+    void sendMidiMessageToAllInstruments(const MidiMessage &message) const;
     void allNotesAndControllersOff() const;
     void allNotesControllersAndSoundOff() const;
     
@@ -94,6 +117,15 @@ public:
     void instrumentRemoved(Instrument *instrument) override;
     void instrumentRemovedPostAction() override;
 
+    //===------------------------------------------------------------------===//
+    // ChangeListener, AudioProcessorListener
+    //===------------------------------------------------------------------===//
+
+    void changeListenerCallback(ChangeBroadcaster *source) override;
+    void audioProcessorParameterChanged(AudioProcessor *processor,
+        int parameterIndex, float newValue) override;
+    void audioProcessorChanged(AudioProcessor *processor) override;
+
     //===------------------------------------------------------------------===//
     // ProjectListener
     //===------------------------------------------------------------------===//
@@ -152,6 +184,9 @@ private:
     ScopedPointer<PlayerThreadPool> player;
     ScopedPointer<RendererThread> renderer;
 
+    ScopedPointer<RendererThread> freezer;
+    ScopedPointer<FrozenTracksPlayer> frozenTracksPlayer;
+
     friend class RendererThread;
     friend class PlayerThread;
 
@@ -166,9 +201,46 @@ private:
     
     Array<const MidiTrack *> tracksCache;
     HashMap<String, Instrument *> linksCache; // layer id : instrument
+
+    // Unique event queues of all linked instruments, resolved when links change,
+    // so that sending all-notes-off doesn't need any lookups
+    Array<MidiEventQueue *> linkedQueues;
     
     void updateLinkForTrack(const MidiTrack *track);
     void removeLinkForTrack(const MidiTrack *track);
+    void updateLinkedQueues();
+
+    // Linked instruments are the ones about to be used,
+    // so this is where their plugins get created
+    void instantiateLinkedInstruments();
+
+    SequenceWrapper *createSequenceWrapper(const MidiTrack *track) const;
+
+private:
+
+    HashMap<String, String> frozenTracks; // track id : content hash
+    String freezingTrackId;
+    String freezingHash;
+
+    // full render (export) plays frozen tracks through their instruments
+    bool frozenTracksBypassed;
+
+    // The hashes are only checked again after anything they depend on
+    // has changed, which may also be signalled by plugins from the audio thread
+    Atomic<int> frozenTracksAreOutdated;
+    void setFrozenTracksOutdatedFor(const String &trackId, int trackControllerNumber);
+
+    // Instruments of the frozen tracks, with their nodes, listened for changes
+    Array<Instrument *> observedInstruments;
+    ReferenceCountedArray<AudioProcessorGraph::Node> observedNodes;
+    void updateObservedInstruments();
+    void stopObservingInstruments();
+
+    String getFreezeHash(const MidiTrack *track);
+    File getFreezeCacheFile(const String &hash) const;
+    void validateFrozenTracks();
+    void startFrozenTracksAt(double absPosition);
+    void onTrackFrozen(bool succeeded);
     
 private:
     
@@ -190,4 +262,5 @@ private:
     ListenerList<TransportListener> transportListeners;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Transport)
+    JUCE_DECLARE_WEAK_REFERENCEABLE(Transport)
 };
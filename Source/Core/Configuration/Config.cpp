@@ -98,6 +98,7 @@ bool Config::saveIfNeeded()
         return false;
     }
 
+    const ScopedLock lock(this->configLock);
     if (DocumentHelpers::save<XmlSerializer>(this->propertiesFile, this->config))
     {
         needsSaving = false;
@@ -121,6 +122,7 @@ bool Config::reload()
 
     if (doc.isValid() && doc.hasType(Serialization::Core::globalConfig))
     {
+        const ScopedLock lock(this->configLock);
         this->config = doc;
         Logger::writeToLog("Config reloaded");
         return true;
@@ -137,19 +139,29 @@ void Config::timerCallback()
 
 void Config::saveConfigFor(const Identifier &key, const Serializable *serializable)
 {
-    const ValueTree existingChild(this->config.getChildWithName(key));
-    this->config.removeChild(existingChild, nullptr);
-
     ValueTree root(key);
     root.appendChild(serializable->serialize(), nullptr);
 
-    this->config.appendChild(root, nullptr);
+    {
+        const ScopedLock lock(this->configLock);
+        const ValueTree existingChild(this->config.getChildWithName(key));
+        this->config.removeChild(existingChild, nullptr);
+        this->config.appendChild(root, nullptr);
+    }
+
     this->onConfigChanged();
 }
 
 void Config::loadConfigFor(const Identifier &key, Serializable *serializable)
 {
-    const auto tree(this->config.getChildWithName(key));
+    ValueTree tree;
+
+    {
+        const ScopedLock lock(this->configLock);
+        tree = this->config.getChildWithName(key);
+    }
+
+    // saving replaces the whole child, so this one is safe to read unlocked
     if (tree.isValid() && tree.getChild(0).isValid())
     {
         serializable->deserialize(tree.getChild(0));
@@ -158,7 +170,11 @@ void Config::loadConfigFor(const Identifier &key, Serializable *serializable)
 
 void Config::setProperty(const Identifier &key, const var &value, bool delayedSave)
 {
-    this->config.setProperty(key, value, nullptr);
+    {
+        const ScopedLock lock(this->configLock);
+        this->config.setProperty(key, value, nullptr);
+    }
+
     if (delayedSave)
     {
         this->onConfigChanged();
@@ -167,11 +183,13 @@ void Config::setProperty(const Identifier &key, const var &value, bool delayedSa
 
 String Config::getProperty(const Identifier &key, const String &fallback) const noexcept
 {
+    const ScopedLock lock(this->configLock);
     return this->config.getProperty(key, fallback);
 }
 
 bool Config::containsPropertyOrChild(const Identifier &key) const noexcept
 {
+    const ScopedLock lock(this->configLock);
     return this->config.hasProperty(key) || this->config.getChildWithName(key).isValid();
 }
 
@@ -58,6 +58,8 @@ private:
     InterProcessLock fileLock;
     File propertiesFile;
     
+    // Resource managers read the config from the startup threads
+    CriticalSection configLock;
     ValueTree config;
 
     bool needsSaving;
@@ -38,9 +38,11 @@ bool operator==(const Script &l, const Script &r)
     return &l == &r || (l.name == r.name);
 }
 
-Script::Script(const String &name, const Identifier &type, const String &content)
+Script::Script(const String &name, const Identifier &type, const String &content) :
+    name(name),
+    type(type)
 {
-    // TODO
+    this->content.replaceAllContent(content);
 }
 
 //===----------------------------------------------------------------------===//
@@ -69,6 +71,7 @@ ValueTree Script::serialize() const
 
     tree.setProperty(Scripts::name, this->name, nullptr);
     tree.setProperty(Scripts::type, this->type.toString(), nullptr);
+    tree.setProperty(Scripts::content, this->content.getAllContent(), nullptr);
 
     return tree;
 }
@@ -86,11 +89,12 @@ void Script::deserialize(const ValueTree &tree)
 
     this->name = root.getProperty(Scripts::name);
     this->type = root.getProperty(Scripts::type).toString();
-    //this->mapper = createMapperOfType(this->type);
+    this->content.replaceAllContent(root.getProperty(Scripts::content));
 }
 
 void Script::reset()
 {
     this->name.clear();
-    // TODO
+    this->type = {};
+    this->content.replaceAllContent({});
 }
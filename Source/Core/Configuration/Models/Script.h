@@ -31,6 +31,8 @@ public:
     using Ptr = ReferenceCountedObjectPtr<Script>;
 
     String getName() const noexcept { return this->name; };
+    Identifier getType() const noexcept { return this->type; };
+    String getContent() const { return this->content.getAllContent(); };
 
     Script &operator=(const Script &other);
     friend bool operator==(const Script &l, const Script &r);
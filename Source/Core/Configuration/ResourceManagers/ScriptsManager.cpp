@@ -18,6 +18,7 @@
 #include "Common.h"
 #include "ScriptsManager.h"
 #include "Script.h"
+#include "SelectionTransformExecutor.h"
 #include "SerializationKeys.h"
 #include "DocumentHelpers.h"
 #include "App.h"
@@ -26,6 +27,24 @@
 ScriptsManager::ScriptsManager() :
     ResourceManager(Serialization::Resources::scripts) {}
 
+ScriptsManager::~ScriptsManager() {}
+
+void ScriptsManager::shutdown()
+{
+    this->reset();
+    this->selectionTransformExecutor = nullptr;
+}
+
+Scripting::SelectionTransformExecutor &ScriptsManager::getSelectionTransformExecutor()
+{
+    if (this->selectionTransformExecutor == nullptr)
+    {
+        this->selectionTransformExecutor = new Scripting::SelectionTransformExecutor();
+    }
+
+    return *this->selectionTransformExecutor;
+}
+
 //===----------------------------------------------------------------------===//
 // Serializable
 //===----------------------------------------------------------------------===//
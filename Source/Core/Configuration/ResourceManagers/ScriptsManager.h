@@ -20,6 +20,11 @@
 #include "Script.h"
 #include "ResourceManager.h"
 
+namespace Scripting
+{
+    class SelectionTransformExecutor;
+}
+
 class ScriptsManager final : public ResourceManager
 {
 public:
@@ -35,6 +40,11 @@ public:
         return this->getResources<Script>();
     }
 
+    void shutdown() override;
+
+    // Created on demand and kept alive, so that compiled scripts stay cached:
+    Scripting::SelectionTransformExecutor &getSelectionTransformExecutor();
+
 private:
     
     //===------------------------------------------------------------------===//
@@ -47,6 +57,10 @@ private:
 private:
 
     ScriptsManager();
+    ~ScriptsManager() override;
+
+    ScopedPointer<Scripting::SelectionTransformExecutor> selectionTransformExecutor;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScriptsManager)
 
 };
@@ -94,6 +94,33 @@ public:
         this->midiEvents.addSorted(comparator, event.release());
     }
 
+    // Checks out all the events of a given type at once,
+    // sorting the sequence only after all of them are added
+    template<typename T>
+    void checkoutEvents(const ValueTree &state, const Identifier &eventType)
+    {
+        static T empty;
+        this->midiEvents.ensureStorageAllocated(this->midiEvents.size() + state.getNumChildren());
+
+        forEachValueTreeChildWithType(state, e, eventType)
+        {
+            ScopedPointer<T> event(new T(this, empty));
+            event->deserialize(e);
+
+            if (this->usedEventIds.contains(event->getId()))
+            {
+                jassertfalse;
+                continue;
+            }
+
+            this->usedEventIds.insert(event->getId());
+            this->midiEvents.add(event.release());
+        }
+
+        static T comparator;
+        this->midiEvents.sort(comparator, true);
+    }
+
     //===------------------------------------------------------------------===//
     // Accessors
     //===------------------------------------------------------------------===//
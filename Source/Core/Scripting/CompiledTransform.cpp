@@ -0,0 +1,693 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "CompiledTransform.h"
+#include "SerializationKeys.h"
+
+using namespace Scripting;
+using namespace Serialization::Scripts;
+
+void NoteRecords::resize(int numRecords)
+{
+    this->keys.resize(numRecords);
+    this->beats.resize(numRecords);
+    this->lengths.resize(numRecords);
+    this->velocities.resize(numRecords);
+}
+
+//===----------------------------------------------------------------------===//
+// Parser
+//===----------------------------------------------------------------------===//
+
+class CompiledTransform::Parser final
+{
+public:
+
+    Parser(const String &source, CompiledTransform &target) :
+        input(source.getCharPointer()),
+        target(target) {}
+
+    // Expects exactly the form that the interpreter would run:
+    // function transform(selection, time, key) { for (...) { ... } }
+    Result parse()
+    {
+        if (!this->expectKeyword("function") ||
+            !this->expectKeyword(Api::transform.toString()) ||
+            !this->parseParameters() ||
+            !this->expect('{') ||
+            !this->parseLoop() ||
+            !this->expect('}'))
+        {
+            return Result::fail(this->error);
+        }
+
+        this->skipWhitespaceAndComments();
+        if (!this->input.isEmpty())
+        {
+            return Result::fail("Unexpected code after transform()");
+        }
+
+        return Result::ok();
+    }
+
+private:
+
+    String::CharPointerType input;
+    CompiledTransform &target;
+
+    String error;
+    int stackDepth = 0;
+
+    // Names given by the script to transform() parameters,
+    // to the loop counter and to the current note alias:
+    String selectionName;
+    String timeName;
+    String keyName;
+    String indexName;
+    String noteName;
+
+    static int findNoteVariable(const String &name)
+    {
+        if (name == Api::Note::key.toString()) { return Key; }
+        if (name == Api::Note::position.toString()) { return Position; }
+        if (name == Api::Note::length.toString()) { return Length; }
+        if (name == Api::Note::volume.toString()) { return Volume; }
+        return -1;
+    }
+
+    bool fail(const String &message)
+    {
+        this->error = message;
+        return false;
+    }
+
+    bool emit(OpCode opCode, int stackDelta, double value = 0.0, int index = 0)
+    {
+        this->target.code.add({ opCode, value, index });
+        this->stackDepth += stackDelta;
+        jassert(this->stackDepth >= 0);
+        if (this->stackDepth > COMPILED_TRANSFORM_MAX_STACK_SIZE)
+        {
+            return this->fail("Expression is too complex");
+        }
+
+        return true;
+    }
+
+    void skipWhitespaceAndComments()
+    {
+        for (;;)
+        {
+            this->input = this->input.findEndOfWhitespace();
+
+            if (*this->input == '/' && this->input[1] == '/')
+            {
+                while (!this->input.isEmpty() && *this->input != '\n')
+                {
+                    ++this->input;
+                }
+            }
+            else if (*this->input == '/' && this->input[1] == '*')
+            {
+                this->input += 2;
+                while (!this->input.isEmpty() &&
+                    !(*this->input == '*' && this->input[1] == '/'))
+                {
+                    ++this->input;
+                }
+
+                if (!this->input.isEmpty())
+                {
+                    this->input += 2;
+                }
+            }
+            else
+            {
+                return;
+            }
+        }
+    }
+
+    String readIdentifier()
+    {
+        this->skipWhitespaceAndComments();
+        const auto start = this->input;
+
+        if (CharacterFunctions::isLetter(*this->input) || *this->input == '_' || *this->input == '$')
+        {
+            while (CharacterFunctions::isLetterOrDigit(*this->input) || *this->input == '_' || *this->input == '$')
+            {
+                ++this->input;
+            }
+        }
+
+        return String(start, this->input);
+    }
+
+    bool expectIdentifier(String &outName)
+    {
+        outName = this->readIdentifier();
+        if (outName.isEmpty())
+        {
+            return this->fail("Expected an identifier");
+        }
+
+        return true;
+    }
+
+    bool expectKeyword(const String &keyword)
+    {
+        const auto name = this->readIdentifier();
+        if (name != keyword)
+        {
+            return this->fail("Expected '" + keyword + "', got: " + name);
+        }
+
+        return true;
+    }
+
+    bool expectName(const String &expectedName)
+    {
+        const auto name = this->readIdentifier();
+        if (expectedName.isEmpty() || name != expectedName)
+        {
+            return this->fail("Expected '" + expectedName + "', got: " + name);
+        }
+
+        return true;
+    }
+
+    bool expect(juce_wchar c)
+    {
+        this->skipWhitespaceAndComments();
+        if (*this->input != c)
+        {
+            return this->fail("Expected '" + String::charToString(c) + "'");
+        }
+
+        ++this->input;
+        return true;
+    }
+
+    bool expectOperator(const char *op)
+    {
+        this->skipWhitespaceAndComments();
+        auto lookahead = this->input;
+        for (const char *c = op; *c != 0; ++c, ++lookahead)
+        {
+            if (*lookahead != juce_wchar(*c))
+            {
+                return this->fail("Expected '" + String(op) + "'");
+            }
+        }
+
+        this->input = lookahead;
+        return true;
+    }
+
+    bool skipIf(juce_wchar c)
+    {
+        this->skipWhitespaceAndComments();
+        if (*this->input == c)
+        {
+            ++this->input;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool skipIfKeyword(const String &keyword)
+    {
+        const auto start = this->input;
+        if (this->readIdentifier() == keyword)
+        {
+            return true;
+        }
+
+        this->input = start;
+        return false;
+    }
+
+    bool parseParameters()
+    {
+        if (!this->expect('(')) { return false; }
+
+        // Parameters are positional, same as the interpreter passes them:
+        String *names[] = { &this->selectionName, &this->timeName, &this->keyName };
+        for (int i = 0; i < 3 && !this->skipIf(')'); ++i)
+        {
+            if (i > 0 && !this->expect(',')) { return false; }
+            if (!this->expectIdentifier(*names[i])) { return false; }
+            if (i == 2 && !this->expect(')')) { return false; }
+        }
+
+        if (this->selectionName.isEmpty())
+        {
+            return this->fail("transform() has no selection parameter");
+        }
+
+        return true;
+    }
+
+    // for (var i = 0; i < selection.length; ++i) { [var note = selection[i];] statements }
+    bool parseLoop()
+    {
+        if (!this->expectKeyword("for") || !this->expect('(')) { return false; }
+
+        this->skipIfKeyword("var");
+        if (!this->expectIdentifier(this->indexName)) { return false; }
+
+        if (this->indexName == this->selectionName ||
+            this->indexName == this->timeName ||
+            this->indexName == this->keyName)
+        {
+            return this->fail("Loop counter shadows a parameter");
+        }
+
+        this->skipWhitespaceAndComments();
+        if (!this->expect('=') || !this->expect('0') || !this->expect(';')) { return false; }
+
+        if (!this->expectName(this->indexName) || !this->expect('<') ||
+            !this->expectName(this->selectionName) || !this->expect('.') ||
+            !this->expectKeyword("length") || !this->expect(';')) { return false; }
+
+        if (!this->parseIncrement() || !this->expect(')') || !this->expect('{')) { return false; }
+
+        // An optional alias for the current note, which has to come first:
+        const auto beforeAlias = this->input;
+        if (this->skipIfKeyword("var"))
+        {
+            if (!this->expectIdentifier(this->noteName) || !this->expect('=') ||
+                !this->parseSelectionItem() || !this->expect(';'))
+            {
+                return false;
+            }
+
+            if (this->noteName == this->selectionName ||
+                this->noteName == this->timeName ||
+                this->noteName == this->keyName ||
+                this->noteName == this->indexName)
+            {
+                return this->fail("Note variable shadows a parameter");
+            }
+        }
+        else
+        {
+            this->input = beforeAlias;
+        }
+
+        while (!this->skipIf('}'))
+        {
+            if (this->input.isEmpty())
+            {
+                return this->fail("Unexpected end of script");
+            }
+
+            if (!this->parseStatement()) { return false; }
+
+            while (this->skipIf(';')) {}
+        }
+
+        return true;
+    }
+
+    bool parseIncrement()
+    {
+        this->skipWhitespaceAndComments();
+        if (*this->input == '+')
+        {
+            return this->expectOperator("++") && this->expectName(this->indexName);
+        }
+
+        if (!this->expectName(this->indexName)) { return false; }
+
+        this->skipWhitespaceAndComments();
+        if (*this->input == '+' && this->input[1] == '+')
+        {
+            return this->expectOperator("++");
+        }
+
+        return this->expectOperator("+=") && this->expect('1');
+    }
+
+    // selection[i], where i is the loop counter
+    bool parseSelectionItem()
+    {
+        return this->expectName(this->selectionName) && this->expect('[') &&
+            this->expectName(this->indexName) && this->expect(']');
+    }
+
+    // note.key or selection[i].key, returns the variable index or -1
+    int parseNoteReference(const String &name)
+    {
+        if (name == this->noteName && this->noteName.isNotEmpty())
+        {
+            // fall through to the field access
+        }
+        else if (name == this->selectionName)
+        {
+            if (!this->expect('[') || !this->expectName(this->indexName) || !this->expect(']'))
+            {
+                return -1;
+            }
+        }
+        else
+        {
+            this->fail("Unknown variable: " + name);
+            return -1;
+        }
+
+        if (!this->expect('.')) { return -1; }
+
+        const auto field = this->readIdentifier();
+        const int variable = findNoteVariable(field);
+        if (variable < 0)
+        {
+            this->fail("Unknown note parameter: " + field);
+        }
+
+        return variable;
+    }
+
+    bool parseStatement()
+    {
+        String name;
+        if (!this->expectIdentifier(name)) { return false; }
+
+        const int variable = this->parseNoteReference(name);
+        if (variable < 0) { return false; }
+
+        this->skipWhitespaceAndComments();
+
+        // Compound assignments like "note.key += 12"
+        bool hasCompoundOperator = true;
+        OpCode compoundOperator = OpCode::Add;
+        switch (*this->input)
+        {
+            case '+': compoundOperator = OpCode::Add; break;
+            case '-': compoundOperator = OpCode::Subtract; break;
+            case '*': compoundOperator = OpCode::Multiply; break;
+            case '/': compoundOperator = OpCode::Divide; break;
+            case '%': compoundOperator = OpCode::Modulo; break;
+            default: hasCompoundOperator = false; break;
+        }
+
+        if (hasCompoundOperator)
+        {
+            ++this->input;
+            if (!this->emit(OpCode::PushVariable, 1, 0.0, variable)) { return false; }
+        }
+
+        if (*this->input != '=' || this->input[1] == '=')
+        {
+            return this->fail("Expected an assignment to " + name);
+        }
+
+        ++this->input;
+
+        if (!this->parseExpression()) { return false; }
+
+        if (hasCompoundOperator &&
+            !this->emit(compoundOperator, -1)) { return false; }
+
+        return this->emit(OpCode::Store, -1, 0.0, variable);
+    }
+
+    bool parseExpression()
+    {
+        if (!this->parseTerm()) { return false; }
+
+        for (;;)
+        {
+            this->skipWhitespaceAndComments();
+            const auto c = *this->input;
+            if ((c != '+' && c != '-') || this->input[1] == '=' || this->input[1] == c) { return true; }
+
+            ++this->input;
+            if (!this->parseTerm()) { return false; }
+            if (!this->emit(c == '+' ? OpCode::Add : OpCode::Subtract, -1)) { return false; }
+        }
+    }
+
+    bool parseTerm()
+    {
+        if (!this->parseUnary()) { return false; }
+
+        for (;;)
+        {
+            this->skipWhitespaceAndComments();
+            const auto c = *this->input;
+            if ((c != '*' && c != '/' && c != '%') || this->input[1] == '=') { return true; }
+
+            ++this->input;
+            if (!this->parseUnary()) { return false; }
+
+            const auto opCode = (c == '*') ? OpCode::Multiply :
+                ((c == '/') ? OpCode::Divide : OpCode::Modulo);
+
+            if (!this->emit(opCode, -1)) { return false; }
+        }
+    }
+
+    bool parseUnary()
+    {
+        this->skipWhitespaceAndComments();
+        if (this->input[1] == *this->input && (*this->input == '-' || *this->input == '+'))
+        {
+            return this->fail("Increments are not supported");
+        }
+
+        if (*this->input == '-')
+        {
+            ++this->input;
+            return this->parseUnary() && this->emit(OpCode::Negate, 0);
+        }
+
+        if (*this->input == '+')
+        {
+            ++this->input;
+            return this->parseUnary();
+        }
+
+        return this->parsePrimary();
+    }
+
+    bool parsePrimary()
+    {
+        this->skipWhitespaceAndComments();
+        const auto c = *this->input;
+
+        if (c == '(')
+        {
+            ++this->input;
+            return this->parseExpression() && this->expect(')');
+        }
+
+        if (CharacterFunctions::isDigit(c) || c == '.')
+        {
+            const auto value = CharacterFunctions::readDoubleValue(this->input);
+            return this->emit(OpCode::PushConstant, 1, value);
+        }
+
+        const auto name = this->readIdentifier();
+        if (name.isEmpty())
+        {
+            return this->fail("Unexpected character: " + String::charToString(c));
+        }
+
+        if (name == "Math")
+        {
+            String function;
+            return this->expect('.') && this->expectIdentifier(function) &&
+                this->parseFunctionCall(function);
+        }
+
+        if (name == this->indexName)
+        {
+            return this->emit(OpCode::PushVariable, 1, 0.0, Index);
+        }
+
+        if (name == this->timeName || name == this->keyName)
+        {
+            String field;
+            if (!this->expect('.') || !this->expectIdentifier(field)) { return false; }
+
+            if (name == this->timeName && field == Api::TimeSignature::numerator.toString())
+            {
+                return this->emit(OpCode::PushVariable, 1, 0.0, Numerator);
+            }
+
+            if (name == this->timeName && field == Api::TimeSignature::denominator.toString())
+            {
+                return this->emit(OpCode::PushVariable, 1, 0.0, Denominator);
+            }
+
+            if (name == this->keyName && field == Api::KeySignature::rootKey.toString())
+            {
+                return this->emit(OpCode::PushVariable, 1, 0.0, RootKey);
+            }
+
+            return this->fail("Unsupported property: " + name + "." + field);
+        }
+
+        if (name == this->selectionName)
+        {
+            this->skipWhitespaceAndComments();
+            if (*this->input == '.')
+            {
+                return this->expect('.') && this->expectKeyword("length") &&
+                    this->emit(OpCode::PushVariable, 1, 0.0, Count);
+            }
+        }
+
+        const int variable = this->parseNoteReference(name);
+        if (variable < 0) { return false; }
+
+        return this->emit(OpCode::PushVariable, 1, 0.0, variable);
+    }
+
+    bool parseFunctionCall(const String &name)
+    {
+        OpCode opCode;
+        int numArguments = 1;
+
+        if (name == "min") { opCode = OpCode::Min; numArguments = 2; }
+        else if (name == "max") { opCode = OpCode::Max; numArguments = 2; }
+        else if (name == "abs") { opCode = OpCode::Abs; }
+        else if (name == "floor") { opCode = OpCode::Floor; }
+        else if (name == "ceil") { opCode = OpCode::Ceil; }
+        else if (name == "round") { opCode = OpCode::Round; }
+        else { return this->fail("Unsupported function: Math." + name); }
+
+        if (!this->expect('(')) { return false; }
+
+        for (int i = 0; i < numArguments; ++i)
+        {
+            if (i > 0 && !this->expect(',')) { return false; }
+            if (!this->parseExpression()) { return false; }
+        }
+
+        return this->expect(')') && this->emit(opCode, 1 - numArguments);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(Parser)
+};
+
+//===----------------------------------------------------------------------===//
+// CompiledTransform
+//===----------------------------------------------------------------------===//
+
+CompiledTransform::Ptr CompiledTransform::compile(const String &source, Result &outResult)
+{
+    Ptr program(new CompiledTransform());
+    Parser parser(source, *program);
+    outResult = parser.parse();
+    return outResult.wasOk() ? program : nullptr;
+}
+
+void CompiledTransform::run(NoteRecords &records, int startIndex, int endIndex,
+    const TransformContext &context) const noexcept
+{
+    jassert(startIndex >= 0 && endIndex <= records.size());
+
+    double variables[NumVariables];
+    double stack[COMPILED_TRANSFORM_MAX_STACK_SIZE];
+
+    variables[Count] = context.count;
+    variables[Numerator] = context.numerator;
+    variables[Denominator] = context.denominator;
+    variables[RootKey] = context.rootKey;
+
+    auto *keys = records.keys.getRawDataPointer();
+    auto *beats = records.beats.getRawDataPointer();
+    auto *lengths = records.lengths.getRawDataPointer();
+    auto *velocities = records.velocities.getRawDataPointer();
+
+    for (int i = startIndex; i < endIndex; ++i)
+    {
+        variables[Key] = keys[i];
+        variables[Position] = beats[i];
+        variables[Length] = lengths[i];
+        variables[Volume] = velocities[i];
+        variables[Index] = double(i);
+
+        int sp = 0;
+        for (const auto &instruction : this->code)
+        {
+            switch (instruction.opCode)
+            {
+                case OpCode::PushConstant:
+                    stack[sp++] = instruction.value;
+                    break;
+                case OpCode::PushVariable:
+                    stack[sp++] = variables[instruction.index];
+                    break;
+                case OpCode::Store:
+                    variables[instruction.index] = stack[--sp];
+                    break;
+                case OpCode::Negate:
+                    stack[sp - 1] = -stack[sp - 1];
+                    break;
+                case OpCode::Add:
+                    --sp; stack[sp - 1] += stack[sp];
+                    break;
+                case OpCode::Subtract:
+                    --sp; stack[sp - 1] -= stack[sp];
+                    break;
+                case OpCode::Multiply:
+                    --sp; stack[sp - 1] *= stack[sp];
+                    break;
+                // JavascriptEngine gives infinity for any division by zero, modulo included:
+                case OpCode::Divide:
+                    --sp; stack[sp - 1] = (stack[sp] != 0.0) ?
+                        (stack[sp - 1] / stack[sp]) : std::numeric_limits<double>::infinity();
+                    break;
+                case OpCode::Modulo:
+                    --sp; stack[sp - 1] = (stack[sp] != 0.0) ?
+                        std::fmod(stack[sp - 1], stack[sp]) : std::numeric_limits<double>::infinity();
+                    break;
+                case OpCode::Min:
+                    --sp; stack[sp - 1] = jmin(stack[sp - 1], stack[sp]);
+                    break;
+                case OpCode::Max:
+                    --sp; stack[sp - 1] = jmax(stack[sp - 1], stack[sp]);
+                    break;
+                case OpCode::Abs:
+                    stack[sp - 1] = std::abs(stack[sp - 1]);
+                    break;
+                case OpCode::Floor:
+                    stack[sp - 1] = std::floor(stack[sp - 1]);
+                    break;
+                case OpCode::Ceil:
+                    stack[sp - 1] = std::ceil(stack[sp - 1]);
+                    break;
+                case OpCode::Round:
+                    stack[sp - 1] = double(roundToIntAccurate(stack[sp - 1]));
+                    break;
+            }
+        }
+
+        jassert(sp == 0);
+
+        keys[i] = variables[Key];
+        beats[i] = variables[Position];
+        lengths[i] = variables[Length];
+        velocities[i] = variables[Volume];
+    }
+}
@@ -0,0 +1,127 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define COMPILED_TRANSFORM_MAX_STACK_SIZE 32
+
+namespace Scripting
+{
+    // Plain note parameters, laid out as separate arrays,
+    // so that compiled transforms could process them in batches:
+    struct NoteRecords final
+    {
+        void resize(int numRecords);
+        int size() const noexcept { return this->keys.size(); }
+
+        Array<double> keys;
+        Array<double> beats;
+        Array<double> lengths;
+        Array<double> velocities;
+    };
+
+    // Read-only values, which are the same for all notes in a batch:
+    struct TransformContext final
+    {
+        double numerator = 4.0;
+        double denominator = 4.0;
+        double rootKey = 0.0;
+        double count = 0.0;
+    };
+
+    // A tiny stack machine for transform() functions which consist of a single
+    // loop over the selection with per-note assignments, like
+    //
+    //     function transform(selection, time, key) {
+    //         for (var i = 0; i < selection.length; ++i) {
+    //             var note = selection[i];
+    //             note.volume = Math.min(note.volume * 1.5, 1);
+    //         }
+    //     }
+    //
+    // This covers most of the typical scripts, which then don't need JavascriptEngine.
+    // All arithmetic is done in doubles and follows JavascriptEngine's semantics,
+    // so that a compiled script gives exactly the same results as the interpreted one.
+    // A program is compiled once and is immutable afterwards,
+    // so it's safe to run it from several threads over the disjoint ranges.
+    class CompiledTransform final : public ReferenceCountedObject
+    {
+    public:
+
+        using Ptr = ReferenceCountedObjectPtr<CompiledTransform>;
+
+        // Returns nullptr and a failed result, if the source
+        // cannot be expressed as a loop of per-note assignments
+        static Ptr compile(const String &source, Result &outResult);
+
+        void run(NoteRecords &records, int startIndex, int endIndex,
+            const TransformContext &context) const noexcept;
+
+    private:
+
+        CompiledTransform() = default;
+
+        enum class OpCode : uint8
+        {
+            PushConstant,
+            PushVariable,
+            Store,
+            Negate,
+            Add,
+            Subtract,
+            Multiply,
+            Divide,
+            Modulo,
+            Min,
+            Max,
+            Abs,
+            Floor,
+            Ceil,
+            Round
+        };
+
+        struct Instruction final
+        {
+            OpCode opCode;
+            double value;
+            int index;
+        };
+
+        // Variables that a program can read; only the first four can be written to
+        enum Variable
+        {
+            Key = 0,
+            Position,
+            Length,
+            Volume,
+            Index,
+            Count,
+            Numerator,
+            Denominator,
+            RootKey,
+            NumVariables
+        };
+
+        static constexpr int numWritableVariables = Index;
+
+        Array<Instruction> code;
+
+        class Parser;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CompiledTransform)
+    };
+}
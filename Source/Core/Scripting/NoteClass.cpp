@@ -34,12 +34,24 @@ NoteClass::NoteClass(const Note &note) : note(note)
 
 bool Scripting::NoteClass::hasBeenChanged() const
 {
-    // TODO
-    return false;
+    const auto updatedNote = this->getUpdatedNote();
+    return updatedNote.getKey() != this->note.getKey() ||
+        updatedNote.getBeat() != this->note.getBeat() ||
+        updatedNote.getLength() != this->note.getLength() ||
+        updatedNote.getVelocity() != this->note.getVelocity();
 }
 
 Note Scripting::NoteClass::getUpdatedNote() const
 {
-    // TODO
-    return Note();
+    const int key = this->getProperty(Api::Note::key);
+    const float beat = this->getProperty(Api::Note::position);
+    const float length = this->getProperty(Api::Note::length);
+    const float velocity = this->getProperty(Api::Note::volume);
+    return this->note.withKeyBeat(key, beat)
+        .withLength(length).withVelocity(velocity);
+}
+
+const Note &Scripting::NoteClass::getOriginalNote() const noexcept
+{
+    return this->note;
 }
@@ -29,6 +29,7 @@ namespace Scripting
 
         bool hasBeenChanged() const;
         Note getUpdatedNote() const;
+        const Note &getOriginalNote() const noexcept;
 
     private:
 
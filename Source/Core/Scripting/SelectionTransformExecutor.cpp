@@ -17,6 +17,7 @@
 
 #include "Common.h"
 #include "SelectionTransformExecutor.h"
+#include "SerializationKeys.h"
 #include "NoteComponent.h"
 
 #include "NoteClass.h"
@@ -26,39 +27,228 @@
 
 using namespace Scripting;
 
-SelectionTransformExecutor::SelectionTransformExecutor()
+class TransformJob final : public ThreadPoolJob
 {
-    // TODO init engine
+public:
+
+    TransformJob(const CompiledTransform &transform, NoteRecords &records,
+        int startIndex, int endIndex, const TransformContext &context) :
+        ThreadPoolJob("Selection transform"),
+        transform(transform),
+        records(records),
+        startIndex(startIndex),
+        endIndex(endIndex),
+        context(context) {}
+
+    JobStatus runJob() override
+    {
+        this->transform.run(this->records, this->startIndex, this->endIndex, this->context);
+        return jobHasFinished;
+    }
+
+private:
+
+    const CompiledTransform &transform;
+    NoteRecords &records;
+    const int startIndex;
+    const int endIndex;
+    const TransformContext &context;
+
+    JUCE_DECLARE_NON_COPYABLE(TransformJob)
+};
+
+static bool hasSameParameters(const Note &a, const Note &b) noexcept
+{
+    return a.getKey() == b.getKey() &&
+        a.getBeat() == b.getBeat() &&
+        a.getLength() == b.getLength() &&
+        a.getVelocity() == b.getVelocity();
+}
+
+SelectionTransformExecutor::SelectionTransformExecutor() :
+    lastEvaluatedScriptHash(0)
+{
+    this->engine.maximumExecutionTime = RelativeTime::seconds(5);
+}
+
+SelectionTransformExecutor::~SelectionTransformExecutor()
+{
+    if (this->threadPool != nullptr)
+    {
+        this->threadPool->removeAllJobs(true, 1000);
+    }
+}
+
+Result SelectionTransformExecutor::execute(const Script &script, const Lasso &selection,
+    const TimeSignatureEvent &time, const KeySignatureEvent &key,
+    Array<Note> &outGroupBefore, Array<Note> &outGroupAfter)
+{
+    Array<Note> notes;
+    notes.ensureStorageAllocated(selection.getNumSelected());
+
+    for (const auto &s : selection.getGroupedSelections())
+    {
+        const auto trackSelection(s.second);
+        for (int i = 0; i < trackSelection->size(); ++i)
+        {
+            notes.add(trackSelection->getItemAs<NoteComponent>(i)->getNote());
+        }
+    }
+
+    if (notes.isEmpty())
+    {
+        return Result::ok();
+    }
+
+    const auto source = script.getContent();
+    const auto transform = this->getCompiledTransform(source);
+    if (transform == nullptr)
+    {
+        return this->executeInterpreted(source, notes,
+            time, key, outGroupBefore, outGroupAfter);
+    }
+
+    NoteRecords records;
+    records.resize(notes.size());
+
+    for (int i = 0; i < notes.size(); ++i)
+    {
+        const auto &note = notes.getReference(i);
+        records.keys.setUnchecked(i, double(note.getKey()));
+        records.beats.setUnchecked(i, note.getBeat());
+        records.lengths.setUnchecked(i, note.getLength());
+        records.velocities.setUnchecked(i, note.getVelocity());
+    }
+
+    TransformContext context;
+    context.numerator = double(time.getNumerator());
+    context.denominator = double(time.getDenominator());
+    context.rootKey = double(key.getRootKey());
+    context.count = double(notes.size());
+
+    this->executeCompiled(*transform, records, context);
+
+    for (int i = 0; i < notes.size(); ++i)
+    {
+        // Converted back the same way NoteClass reads its properties:
+        const auto &note = notes.getReference(i);
+        const int newKey = var(records.keys.getUnchecked(i));
+        const float newBeat = var(records.beats.getUnchecked(i));
+        const float newLength = var(records.lengths.getUnchecked(i));
+        const float newVelocity = var(records.velocities.getUnchecked(i));
+        const auto newNote = note.withKeyBeat(newKey, newBeat)
+            .withLength(newLength).withVelocity(newVelocity);
+
+        if (!hasSameParameters(note, newNote))
+        {
+            outGroupBefore.add(note);
+            outGroupAfter.add(newNote);
+        }
+    }
+
+    return Result::ok();
+}
+
+CompiledTransform::Ptr SelectionTransformExecutor::getCompiledTransform(const String &source)
+{
+    const auto sourceHash = source.hashCode64();
+    if (this->compiledTransforms.contains(sourceHash))
+    {
+        return this->compiledTransforms[sourceHash];
+    }
+
+    // Scripts that don't compile are simply run by the interpreter,
+    // which will also report any real errors in them:
+    Result result = Result::ok();
+    const auto transform = CompiledTransform::compile(source, result);
+    this->compiledTransforms.set(sourceHash, transform);
+    return transform;
 }
 
-Array<Note> Scripting::SelectionTransformExecutor::execute(Lasso &selection,
-    TimeSignatureEvent &time, KeySignatureEvent &key)
+void SelectionTransformExecutor::executeCompiled(const CompiledTransform &transform,
+    NoteRecords &records, const TransformContext &context)
 {
+    const int numRecords = records.size();
+    if (numRecords <= SELECTION_TRANSFORM_CHUNK_SIZE)
+    {
+        transform.run(records, 0, numRecords, context);
+        return;
+    }
+
+    if (this->threadPool == nullptr)
+    {
+        this->threadPool = new ThreadPool(SystemStats::getNumCpus());
+    }
+
+    OwnedArray<TransformJob> jobs;
+    for (int start = SELECTION_TRANSFORM_CHUNK_SIZE; start < numRecords; start += SELECTION_TRANSFORM_CHUNK_SIZE)
+    {
+        const int end = jmin(start + SELECTION_TRANSFORM_CHUNK_SIZE, numRecords);
+        auto *job = jobs.add(new TransformJob(transform, records, start, end, context));
+        this->threadPool->addJob(job, false);
+    }
+
+    // The calling thread takes the first chunk:
+    transform.run(records, 0, SELECTION_TRANSFORM_CHUNK_SIZE, context);
+
+    for (auto *job : jobs)
+    {
+        this->threadPool->waitForJobToFinish(job, -1);
+    }
+}
+
+Result SelectionTransformExecutor::executeInterpreted(const String &source,
+    const Array<Note> &notes, const TimeSignatureEvent &time, const KeySignatureEvent &key,
+    Array<Note> &outGroupBefore, Array<Note> &outGroupAfter)
+{
+    const auto sourceHash = source.hashCode64();
+    if (this->lastEvaluatedScriptHash != sourceHash)
+    {
+        const auto result = this->engine.execute(source);
+        if (result.failed())
+        {
+            return result;
+        }
+
+        this->lastEvaluatedScriptHash = sourceHash;
+    }
+
+    ReferenceCountedArray<NoteClass> noteWrappers;
     Array<var> selectionWrapper;
-    for (int i = 0; i <= selection.getNumSelected(); ++i)
+    for (const auto &note : notes)
     {
-        const auto *nc = selection.getItemAs<NoteComponent>(i);
-        NoteClass::Ptr noteWrapper(new NoteClass(nc->getNote()));
-        selectionWrapper.add(var(noteWrapper.get()));
+        auto *noteWrapper = noteWrappers.add(new NoteClass(note));
+        selectionWrapper.add(var(noteWrapper));
     }
 
-    TimeSignatureClass::Ptr timeSignatureWrapper(new TimeSignatureClass(time));
-    KeySignatureClass::Ptr keySignatureWrapper(new KeySignatureClass(key));
+    DynamicObject::Ptr timeSignatureWrapper(new TimeSignatureClass(time));
+    DynamicObject::Ptr keySignatureWrapper(new KeySignatureClass(key));
 
-    var args;
-    args.append(var(selectionWrapper));
-    args.append(var(timeSignatureWrapper.get()));
-    args.append(var(keySignatureWrapper.get()));
+    Array<var> args;
+    args.add(var(selectionWrapper));
+    args.add(var(timeSignatureWrapper.get()));
+    args.add(var(keySignatureWrapper.get()));
 
     // TODO any root object API in future?
     var self(var::undefined());
 
-    Result result = Result::fail("Unknown");
+    Result result = Result::ok();
+    this->engine.callFunction(Serialization::Scripts::Api::transform,
+        var::NativeFunctionArgs(self, args.getRawDataPointer(), args.size()), &result);
+
+    if (result.failed())
+    {
+        return result;
+    }
 
-    const auto call = this->engine.callFunction("transform",
-        var::NativeFunctionArgs(self, &args, args.size()), &result);
+    for (const auto *noteWrapper : noteWrappers)
+    {
+        if (noteWrapper->hasBeenChanged())
+        {
+            outGroupBefore.add(noteWrapper->getOriginalNote());
+            outGroupAfter.add(noteWrapper->getUpdatedNote());
+        }
+    }
 
-    Array<Note> updates;
-    return updates;
-    // TODO apply transforms?
+    return Result::ok();
 }
@@ -19,8 +19,14 @@
 
 #include "Note.h"
 #include "Lasso.h"
+#include "Script.h"
 #include "KeySignatureEvent.h"
 #include "TimeSignatureEvent.h"
+#include "CompiledTransform.h"
+
+// Selections larger than that are split into chunks
+// and transformed in several threads at once:
+#define SELECTION_TRANSFORM_CHUNK_SIZE 8192
 
 namespace Scripting
 {
@@ -29,13 +35,38 @@ namespace Scripting
     public:
 
         SelectionTransformExecutor();
+        ~SelectionTransformExecutor();
+
         using Args = const var::NativeFunctionArgs &;
 
-        Array<Note> execute(Lasso &selection, TimeSignatureEvent &time, KeySignatureEvent &key);
+        // Fills a single change group for the selected notes.
+        // Every script is expected to define transform() function;
+        // the ones made of a plain per-note loop are compiled once,
+        // cached, and run over note records; any other script is evaluated
+        // with JavascriptEngine
+        Result execute(const Script &script, const Lasso &selection,
+            const TimeSignatureEvent &time, const KeySignatureEvent &key,
+            Array<Note> &outGroupBefore, Array<Note> &outGroupAfter);
 
     private:
 
+        CompiledTransform::Ptr getCompiledTransform(const String &source);
+
+        void executeCompiled(const CompiledTransform &transform,
+            NoteRecords &records, const TransformContext &context);
+
+        Result executeInterpreted(const String &source, const Array<Note> &notes,
+            const TimeSignatureEvent &time, const KeySignatureEvent &key,
+            Array<Note> &outGroupBefore, Array<Note> &outGroupAfter);
+
+        // Compiled programs by source hash; null pointers
+        // mark the scripts that cannot be compiled:
+        HashMap<int64, CompiledTransform::Ptr> compiledTransforms;
+
         JavascriptEngine engine;
+        int64 lastEvaluatedScriptHash;
+
+        ScopedPointer<ThreadPool> threadPool;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SelectionTransformExecutor)
     };
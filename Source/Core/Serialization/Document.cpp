@@ -21,6 +21,7 @@
 #include "DocumentHelpers.h"
 #include "App.h"
 #include "MainLayout.h"
+#include "Profiler.h"
 
 Document::Document(DocumentOwner &documentOwner,
                    const String &defaultName,
@@ -261,6 +262,7 @@ bool Document::internalSave(File result)
         return false;
     }
 
+    PROFILE_SCOPE("Document::save");
     const bool savedOk = this->owner.onDocumentSave(result);
 
     if (savedOk)
@@ -71,6 +71,10 @@ namespace Serialization
         static const Identifier recentFileTime = "time";
 
         static const Identifier filePath = "filePath";
+        static const Identifier wasActive = "wasActive";
+        static const Identifier cachedProjectId = "projectId";
+        static const Identifier cachedProjectStats = "projectStats";
+        static const Identifier cachedProjectTime = "projectModified";
 
         static const Identifier clipboard = "helioClipboard";
     } // namespace Core
@@ -139,6 +143,9 @@ namespace Serialization
 
         static const Identifier transport = "transport";
         static const Identifier transportSeekPosition = "seekPosition";
+        static const Identifier frozenTrack = "frozenTrack";
+        static const Identifier frozenTrackId = "trackId";
+        static const Identifier frozenTrackHash = "hash";
 
         static const Identifier audioPlugin = "pluginSettings";
 
@@ -189,6 +196,8 @@ namespace Serialization
         static const Identifier lastUpdatesInfo = "lastUpdatesInfo";
         static const Identifier lastUsedFont = "lastUsedFont";
 
+        static const Identifier undoMemoryBudget = "undoMemoryBudget";
+
         static const Identifier openGLState = "openGL";
         static const Identifier enabledState = "enabled";
         static const Identifier disabledState = "disabled";
@@ -307,6 +316,9 @@ namespace Serialization
 
         namespace Api
         {
+            // An entry point of transformSelection scripts:
+            static const Identifier transform = "transform";
+
             namespace Note
             {
                 static const Identifier key = "key";
@@ -323,10 +323,7 @@ void AutomationTrackTreeItem::resetEventsDelta(const ValueTree &state)
     jassert(state.hasType(Serialization::VCS::AutoSequenceDeltas::eventsAdded));
     this->getSequence()->reset();
 
-    forEachValueTreeChildWithType(state, e, Serialization::Midi::automationEvent)
-    {
-        this->getSequence()->checkoutEvent<AutomationEvent>(e);
-    }
+    this->getSequence()->checkoutEvents<AutomationEvent>(state, Serialization::Midi::automationEvent);
 
     this->getSequence()->updateBeatRange(false);
 }
@@ -0,0 +1,234 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "BeatGrid.h"
+#include "MidiSequence.h"
+
+// Lines closer than that to the end of a beat or a bar are not added
+#define BEAT_GRID_EPSILON 0.001f
+
+const BeatGrid::Segment BeatGrid::defaultSegment =
+{
+    {},
+    0.f,
+    float(BEATS_PER_BAR * TIME_SIGNATURE_DEFAULT_NUMERATOR) / float(TIME_SIGNATURE_DEFAULT_DENOMINATOR),
+    float(BEATS_PER_BAR) / float(TIME_SIGNATURE_DEFAULT_DENOMINATOR)
+};
+
+//===----------------------------------------------------------------------===//
+// Lookup
+//===----------------------------------------------------------------------===//
+
+void BeatGrid::findLines(float startBeat, float endBeat, int snapLevel,
+    float minBarLength, float minBeatLength, Lines &result) const
+{
+    result.bars.clearQuick();
+    result.beats.clearQuick();
+    result.snaps.clearQuick();
+
+    const float snapLength = float(BEATS_PER_BAR) / float(1 << snapLevel);
+    const int numSegments = jmax(1, this->segments.size());
+
+    for (int i = this->findSegmentIndexAt(startBeat); i < numSegments; ++i)
+    {
+        const auto &segment = this->getSegment(i);
+        const bool isFirstSegment = (i == 0);
+        const bool isLastSegment = (i == numSegments - 1);
+
+        // the first segment also covers everything before it
+        if (!isFirstSegment && segment.startBeat >= endBeat)
+        {
+            break;
+        }
+
+        const float segmentEnd = isLastSegment ? endBeat : this->getSegment(i + 1).startBeat;
+        const float rangeStart = isFirstSegment ? startBeat : jmax(startBeat, segment.startBeat);
+        const float rangeEnd = jmin(endBeat, segmentEnd);
+
+        int barsPerLine = 1;
+        while (segment.barLength * barsPerLine < minBarLength)
+        {
+            barsPerLine *= 2;
+        }
+
+        const bool hasBeats = segment.beatLength >= minBeatLength;
+        const bool hasSnaps = snapLength < (segment.beatLength - BEAT_GRID_EPSILON);
+
+        // when there's nothing to show in between the bar lines,
+        // jump from one visible bar line to another
+        const int barStep = (hasBeats || hasSnaps) ? 1 : barsPerLine;
+        const float firstBarOffset = (rangeStart - segment.startBeat) / (segment.barLength * barStep);
+
+        for (int bar = int(floorf(firstBarOffset)) * barStep; ; bar += barStep)
+        {
+            const float barBeat = segment.startBeat + segment.barLength * bar;
+            if (barBeat >= rangeEnd)
+            {
+                break;
+            }
+
+            if (barBeat >= rangeStart && (bar % barsPerLine) == 0)
+            {
+                result.bars.add(barBeat);
+            }
+
+            if (!hasBeats && !hasSnaps)
+            {
+                continue;
+            }
+
+            // the last bar before the next signature might be incomplete
+            const float barEnd = jmin(barBeat + segment.barLength, segmentEnd);
+
+            for (int beat = 0; ; ++beat)
+            {
+                const float beatStart = barBeat + segment.beatLength * beat;
+                if (beatStart >= (barEnd - BEAT_GRID_EPSILON) || beatStart >= rangeEnd)
+                {
+                    break;
+                }
+
+                // the first one is a bar line
+                if (hasBeats && beat > 0 && beatStart >= rangeStart)
+                {
+                    result.beats.add(beatStart);
+                }
+
+                const float beatEnd = jmin(beatStart + segment.beatLength, barEnd);
+                for (int snap = 1; hasSnaps; ++snap)
+                {
+                    const float snapBeat = beatStart + snapLength * snap;
+                    if (snapBeat >= (beatEnd - BEAT_GRID_EPSILON) || snapBeat >= rangeEnd)
+                    {
+                        break;
+                    }
+
+                    if (snapBeat >= rangeStart)
+                    {
+                        result.snaps.add(snapBeat);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Updates
+//===----------------------------------------------------------------------===//
+
+void BeatGrid::rebuild(const MidiSequence &timeSignatures)
+{
+    this->segments.clearQuick();
+
+    // the sequence is already sorted by beat
+    for (int i = 0; i < timeSignatures.size(); ++i)
+    {
+        const auto *event = timeSignatures.getUnchecked(i);
+        jassert(event->isTypeOf(MidiEvent::TimeSignature));
+        this->segments.add(createSegment(static_cast<const TimeSignatureEvent &>(*event)));
+    }
+}
+
+void BeatGrid::addSignature(const TimeSignatureEvent &signature)
+{
+    static SegmentSorter sorter;
+    this->segments.addSorted(sorter, createSegment(signature));
+}
+
+void BeatGrid::removeSignature(const TimeSignatureEvent &signature)
+{
+    const int index = this->findSegmentIndexOf(signature);
+    jassert(index >= 0);
+    this->segments.remove(index);
+}
+
+void BeatGrid::changeSignature(const TimeSignatureEvent &oldSignature,
+    const TimeSignatureEvent &newSignature)
+{
+    this->removeSignature(oldSignature);
+    this->addSignature(newSignature);
+}
+
+//===----------------------------------------------------------------------===//
+// Helpers
+//===----------------------------------------------------------------------===//
+
+int BeatGrid::SegmentSorter::compareElements(const Segment &first, const Segment &second) noexcept
+{
+    const float diff = first.startBeat - second.startBeat;
+    return (diff > 0.f) - (diff < 0.f);
+}
+
+BeatGrid::Segment BeatGrid::createSegment(const TimeSignatureEvent &signature)
+{
+    const float beatLength = float(BEATS_PER_BAR) / float(signature.getDenominator());
+    return { signature.getId(), signature.getBeat(),
+        beatLength * float(signature.getNumerator()), beatLength };
+}
+
+const BeatGrid::Segment &BeatGrid::getSegment(int index) const noexcept
+{
+    return this->segments.isEmpty() ? defaultSegment : this->segments.getReference(index);
+}
+
+int BeatGrid::findSegmentIndexAt(float beat) const noexcept
+{
+    // the last segment starting at or before the given beat
+    int start = 0;
+    int end = this->segments.size();
+    while (start < end)
+    {
+        const int middle = (start + end) / 2;
+        if (this->segments.getReference(middle).startBeat <= beat)
+        {
+            start = middle + 1;
+        }
+        else
+        {
+            end = middle;
+        }
+    }
+
+    return jmax(0, start - 1);
+}
+
+int BeatGrid::findSegmentIndexOf(const TimeSignatureEvent &signature) const noexcept
+{
+    if (this->segments.isEmpty())
+    {
+        return -1;
+    }
+
+    // several signatures may share the same beat, so check them all
+    for (int i = this->findSegmentIndexAt(signature.getBeat()); i >= 0; --i)
+    {
+        const auto &segment = this->segments.getReference(i);
+        if (segment.id == signature.getId())
+        {
+            return i;
+        }
+
+        if (segment.startBeat < signature.getBeat())
+        {
+            break;
+        }
+    }
+
+    return -1;
+}
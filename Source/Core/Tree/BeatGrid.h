@@ -0,0 +1,85 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+class MidiSequence;
+
+#include "TimeSignatureEvent.h"
+
+// A project-wide index of bars and beats, mirroring the time signatures
+// sequence as a sorted list of segments, each one starting a new meter.
+// Grid lines for any beat range are found by a binary search for the first
+// segment, so that no one has to walk all signatures from the beginning.
+
+class BeatGrid final
+{
+public:
+
+    BeatGrid() = default;
+
+    struct Lines final
+    {
+        Array<float> bars;
+        Array<float> beats;
+        Array<float> snaps;
+    };
+
+    // Finds all bar, beat and snap lines (in beats) within [startBeat, endBeat);
+    // bars shorter than minBarLength are thinned out by powers of two,
+    // beats shorter than minBeatLength are skipped, and each beat is divided
+    // into snaps of BEATS_PER_BAR / 2^snapLevel beats
+    void findLines(float startBeat, float endBeat, int snapLevel,
+        float minBarLength, float minBeatLength, Lines &result) const;
+
+    //===------------------------------------------------------------------===//
+    // Updates
+    //===------------------------------------------------------------------===//
+
+    void rebuild(const MidiSequence &timeSignatures);
+    void addSignature(const TimeSignatureEvent &signature);
+    void removeSignature(const TimeSignatureEvent &signature);
+    void changeSignature(const TimeSignatureEvent &oldSignature,
+        const TimeSignatureEvent &newSignature);
+
+private:
+
+    struct Segment final
+    {
+        MidiEvent::Id id;
+        float startBeat;
+        float barLength;
+        float beatLength;
+    };
+
+    struct SegmentSorter final
+    {
+        static int compareElements(const Segment &first, const Segment &second) noexcept;
+    };
+
+    static Segment createSegment(const TimeSignatureEvent &signature);
+    const Segment &getSegment(int index) const noexcept;
+    int findSegmentIndexAt(float beat) const noexcept;
+    int findSegmentIndexOf(const TimeSignatureEvent &signature) const noexcept;
+
+    // The very first segment also defines everything before it,
+    // and if there are no signatures at all, the default 4/4 is used
+    Array<Segment> segments;
+    static const Segment defaultSegment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BeatGrid)
+};
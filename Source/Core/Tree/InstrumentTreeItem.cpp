@@ -73,6 +73,7 @@ void InstrumentTreeItem::showPage()
         return;
     }
 
+    this->instrument->instantiateIfNeeded();
     App::Layout().showPage(this->instrumentEditor, this);
 }
 
@@ -327,10 +327,7 @@ void PianoTrackTreeItem::resetEventsDelta(const ValueTree &state)
     jassert(state.hasType(Serialization::VCS::PianoSequenceDeltas::notesAdded));
 
     this->getSequence()->reset();
-    forEachValueTreeChildWithType(state, e, Serialization::Midi::note)
-    {
-        this->getSequence()->checkoutEvent<Note>(e);
-    }
+    this->getSequence()->checkoutEvents<Note>(state, Serialization::Midi::note);
 
     this->getSequence()->updateBeatRange(false);
 }
@@ -21,6 +21,7 @@
 #include "TimeSignaturesSequence.h"
 #include "KeySignaturesSequence.h"
 #include "ProjectTreeItem.h"
+#include "BeatGrid.h"
 #include "Pattern.h"
 #include "Icons.h"
 
@@ -89,6 +90,8 @@ ProjectTimeline::ProjectTimeline(ProjectTreeItem &parentProject, String trackNam
     this->keySignaturesTrack = new KeySignaturesTrack(*this);
     this->keySignaturesSequence = new KeySignaturesSequence(*this->keySignaturesTrack, *this);
 
+    this->beatGrid = new BeatGrid();
+
     using namespace Serialization::VCS;
     this->vcsDiffLogic = new VCS::ProjectTimelineDiffLogic(*this);
     this->deltas.add(new VCS::Delta({}, ProjectTimelineDeltas::annotationsAdded));
@@ -122,6 +125,11 @@ MidiTrack *ProjectTimeline::getKeySignatures() const noexcept
     return this->keySignaturesTrack;
 }
 
+const BeatGrid &ProjectTimeline::getBeatGrid() const noexcept
+{
+    return *this->beatGrid;
+}
+
 //===----------------------------------------------------------------------===//
 // VCS::TrackedItem
 //===----------------------------------------------------------------------===//
@@ -218,18 +226,37 @@ void ProjectTimeline::resetStateTo(const VCS::TrackedItem &newState)
 // ProjectEventDispatcher
 //===----------------------------------------------------------------------===//
 
+// The beat grid is updated before the broadcast,
+// so that all listeners could already use it
+
 void ProjectTimeline::dispatchChangeEvent(const MidiEvent &oldEvent, const MidiEvent &newEvent)
 {
+    if (oldEvent.isTypeOf(MidiEvent::TimeSignature))
+    {
+        this->beatGrid->changeSignature(static_cast<const TimeSignatureEvent &>(oldEvent),
+            static_cast<const TimeSignatureEvent &>(newEvent));
+    }
+
     this->project.broadcastChangeEvent(oldEvent, newEvent);
 }
 
 void ProjectTimeline::dispatchAddEvent(const MidiEvent &event)
 {
+    if (event.isTypeOf(MidiEvent::TimeSignature))
+    {
+        this->beatGrid->addSignature(static_cast<const TimeSignatureEvent &>(event));
+    }
+
     this->project.broadcastAddEvent(event);
 }
 
 void ProjectTimeline::dispatchRemoveEvent(const MidiEvent &event)
 {
+    if (event.isTypeOf(MidiEvent::TimeSignature))
+    {
+        this->beatGrid->removeSignature(static_cast<const TimeSignatureEvent &>(event));
+    }
+
     this->project.broadcastRemoveEvent(event);
 }
 
@@ -271,6 +298,7 @@ void ProjectTimeline::reset()
     this->annotationsSequence->reset();
     this->keySignaturesSequence->reset();
     this->timeSignaturesSequence->reset();
+    this->beatGrid->rebuild(*this->timeSignaturesSequence);
 }
 
 ValueTree ProjectTimeline::serialize() const
@@ -336,6 +364,8 @@ void ProjectTimeline::deserialize(const ValueTree &tree)
         this->timeSignaturesSequence->deserialize(e);
     }
 
+    this->beatGrid->rebuild(*this->timeSignaturesSequence);
+
     // Debug::
     //TimeSignatureEvent e(this->timeSignaturesSequence, 0.f, 9, 16);
     //(static_cast<TimeSignaturesSequence *>(this->timeSignaturesSequence.get()))->insert(e, false);
@@ -365,10 +395,7 @@ void ProjectTimeline::resetAnnotationsDelta(const ValueTree &state)
     jassert(state.hasType(Serialization::VCS::ProjectTimelineDeltas::annotationsAdded));
     this->annotationsSequence->reset();
 
-    forEachValueTreeChildWithType(state, e, Serialization::Midi::annotation)
-    {
-        this->annotationsSequence->checkoutEvent<AnnotationEvent>(e);
-    }
+    this->annotationsSequence->checkoutEvents<AnnotationEvent>(state, Serialization::Midi::annotation);
 
     this->annotationsSequence->updateBeatRange(false);
 }
@@ -391,12 +418,10 @@ void ProjectTimeline::resetTimeSignaturesDelta(const ValueTree &state)
     jassert(state.hasType(Serialization::VCS::ProjectTimelineDeltas::timeSignaturesAdded));
     this->timeSignaturesSequence->reset();
     
-    forEachValueTreeChildWithType(state, e, Serialization::Midi::timeSignature)
-    {
-        this->timeSignaturesSequence->checkoutEvent<TimeSignatureEvent>(e);
-    }
+    this->timeSignaturesSequence->checkoutEvents<TimeSignatureEvent>(state, Serialization::Midi::timeSignature);
 
     this->timeSignaturesSequence->updateBeatRange(false);
+    this->beatGrid->rebuild(*this->timeSignaturesSequence);
 }
 
 ValueTree ProjectTimeline::serializeKeySignaturesDelta() const
@@ -417,10 +442,7 @@ void ProjectTimeline::resetKeySignaturesDelta(const ValueTree &state)
     jassert(state.hasType(Serialization::VCS::ProjectTimelineDeltas::keySignaturesAdded));
     this->keySignaturesSequence->reset();
 
-    forEachValueTreeChildWithType(state, e, Serialization::Midi::keySignature)
-    {
-        this->keySignaturesSequence->checkoutEvent<KeySignatureEvent>(e);
-    }
+    this->keySignaturesSequence->checkoutEvents<KeySignatureEvent>(state, Serialization::Midi::keySignature);
 
     this->keySignaturesSequence->updateBeatRange(false);
 }
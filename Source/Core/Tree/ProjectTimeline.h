@@ -18,6 +18,7 @@
 #pragma once
 
 class ProjectTreeItem;
+class BeatGrid;
 
 #include "MidiTrack.h"
 #include "ProjectTimelineDiffLogic.h"
@@ -37,6 +38,9 @@ public:
     MidiTrack *getTimeSignatures() const noexcept;
     MidiTrack *getKeySignatures() const noexcept;
 
+    // Bar and beat lines index, shared by all editors
+    const BeatGrid &getBeatGrid() const noexcept;
+
     //===------------------------------------------------------------------===//
     // VCS::TrackedItem
     //===------------------------------------------------------------------===//
@@ -108,6 +112,8 @@ private:
     ScopedPointer<MidiSequence> timeSignaturesSequence;
     ScopedPointer<MidiSequence> keySignaturesSequence;
 
+    ScopedPointer<BeatGrid> beatGrid;
+
     friend class AnnotationsTrack;
     friend class TimeSignaturesTrack;
     friend class KeySignaturesTrack;
@@ -61,6 +61,55 @@
 #include "Config.h"
 #include "Icons.h"
 
+#define PROJECT_LOADER_STOP_TIMEOUT_MS 5000
+
+//===----------------------------------------------------------------------===//
+// Background loader
+//===----------------------------------------------------------------------===//
+
+class ProjectTreeItem::LoaderThread final : public Thread
+{
+public:
+
+    LoaderThread(ProjectTreeItem &project, const File &file) :
+        Thread("Project loader"),
+        project(&project),
+        file(file) {}
+
+    ~LoaderThread() override
+    {
+        this->stopThread(PROJECT_LOADER_STOP_TIMEOUT_MS);
+    }
+
+    void run() override
+    {
+        // only the parsing is done here, the tree is applied on the message thread
+        const ValueTree tree(DocumentHelpers::load(this->file));
+
+        if (this->threadShouldExit())
+        {
+            return;
+        }
+
+        const WeakReference<TreeItem> projectRef(this->project);
+        const File loadedFile(this->file);
+        MessageManager::callAsync([projectRef, loadedFile, tree]()
+        {
+            if (auto *project = dynamic_cast<ProjectTreeItem *>(projectRef.get()))
+            {
+                project->onAsyncLoadDone(loadedFile, tree);
+            }
+        });
+    }
+
+private:
+
+    // created on the message thread, only copied here
+    const WeakReference<TreeItem> project;
+    const File file;
+
+};
+
 ProjectTreeItem::ProjectTreeItem(const String &name) :
     DocumentOwner(name, "helio"),
     TreeItem(name, Serialization::Core::project)
@@ -78,8 +127,12 @@ ProjectTreeItem::ProjectTreeItem(const File &existingFile) :
 void ProjectTreeItem::initialize()
 {
     this->isTracksCacheOutdated = true;
+    this->lastActivationTime = 0.0;
     
-    this->undoStack = new UndoStack(*this);
+    // the undo history budget is configured in megabytes
+    const int64 undoMemoryBudget = Config::get(Serialization::Config::undoMemoryBudget).getLargeIntValue();
+    this->undoStack = new UndoStack(*this, (undoMemoryBudget > 0) ?
+        (undoMemoryBudget * 1024 * 1024) : UNDO_STACK_DEFAULT_MEMORY_BUDGET);
     
     this->autosaver = new Autosaver(*this);
 
@@ -101,14 +154,19 @@ void ProjectTreeItem::initialize()
 
 ProjectTreeItem::~ProjectTreeItem()
 {
+    this->loaderThread = nullptr;
+
     // the main policy: all data is to be autosaved
-    this->getDocument()->save();
+    if (this->isLoaded())
+    {
+        this->getDocument()->save();
+    }
     
     this->transport->stopPlayback();
     this->transport->stopRender();
 
     // remember as the recent file
-    if (this->recentFilesList != nullptr)
+    if (this->recentFilesList != nullptr && this->isLoaded())
     {
         this->recentFilesList->
         onProjectStateChanged(this->getName(),
@@ -154,6 +212,11 @@ void ProjectTreeItem::deletePermanently()
 
 String ProjectTreeItem::getId() const
 {
+    if (! this->isLoaded())
+    {
+        return this->cachedId;
+    }
+
     VersionControlTreeItem *vcsTreeItem =
         this->findChildOfType<VersionControlTreeItem>();
 
@@ -167,6 +230,11 @@ String ProjectTreeItem::getId() const
 
 String ProjectTreeItem::getStats() const
 {
+    if (! this->isLoaded())
+    {
+        return this->cachedStats;
+    }
+
     Array<MidiTrackTreeItem *> layerItems(this->findChildrenOfType<MidiTrackTreeItem>());
     
     int numEvents = 0;
@@ -215,6 +283,8 @@ Image ProjectTreeItem::getIcon() const noexcept
 
 void ProjectTreeItem::showPage()
 {
+    this->lastActivationTime = Time::getMillisecondCounterHiRes();
+    this->loadAsync();
     this->projectPage->updateContent();
     App::Layout().showPage(this->projectPage, this);
 }
@@ -271,6 +341,7 @@ void ProjectTreeItem::recreatePage()
 void ProjectTreeItem::showPatternEditor(WeakReference<TreeItem> source)
 {
     jassert(source != nullptr);
+    this->lastActivationTime = Time::getMillisecondCounterHiRes();
     this->sequencerLayout->showPatternEditor();
     App::Layout().showPage(this->sequencerLayout, source);
 }
@@ -282,6 +353,7 @@ void ProjectTreeItem::showLinearEditor(WeakReference<MidiTrack> activeTrack, Wea
 
     if (const auto *pianoTrack = dynamic_cast<PianoTrackTreeItem *>(activeTrack.get()))
     {
+        this->lastActivationTime = Time::getMillisecondCounterHiRes();
         this->sequencerLayout->showLinearEditor(activeTrack);
         this->lastShownTrack = source;
         App::Layout().showPage(this->sequencerLayout, source);
@@ -474,13 +546,45 @@ StringArray ProjectTreeItem::getAllTrackNames() const
 // Serializable
 //===----------------------------------------------------------------------===//
 
+static bool hasSelection(const TreeViewItem *item)
+{
+    if (item->isSelected())
+    {
+        return true;
+    }
+
+    for (int i = 0; i < item->getNumSubItems(); ++i)
+    {
+        if (hasSelection(item->getSubItem(i)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 ValueTree ProjectTreeItem::serialize() const
 {
-    this->getDocument()->save();
+    if (this->isLoaded())
+    {
+        this->getDocument()->save();
+    }
 
     ValueTree tree(Serialization::Core::treeItem);
     tree.setProperty(Serialization::Core::treeItemType, this->type, nullptr);
-    tree.setProperty(Serialization::Core::filePath, this->getDocument()->getFullPath(), nullptr);
+    tree.setProperty(Serialization::Core::filePath, this->isLoaded() ?
+        this->getDocument()->getFullPath() : this->deferredFile.getFullPathName(), nullptr);
+    tree.setProperty(Serialization::Core::wasActive, hasSelection(this), nullptr);
+
+    // the summary, so that the next time this project can be shown without loading it
+    const File file(this->isLoaded() ? File(this->getDocument()->getFullPath()) : this->deferredFile);
+    tree.setProperty(Serialization::Core::cachedProjectId, this->getId(), nullptr);
+    tree.setProperty(Serialization::Core::cachedProjectStats, this->getStats(), nullptr);
+    tree.setProperty(Serialization::Core::cachedProjectTime,
+        this->isLoaded() ? file.getLastModificationTime().toMilliseconds() :
+        this->cachedLastModified.toMilliseconds(), nullptr);
+
     return tree;
 }
 
@@ -496,8 +600,147 @@ void ProjectTreeItem::deserialize(const ValueTree &tree)
         delete this;
         return;
     }
-    
+
+    // workspaces saved before this flag existed load everything as they did
+    if (tree.getProperty(Serialization::Core::wasActive, true))
+    {
+        this->getDocument()->load(fullPathFile, relativePathFile);
+        return;
+    }
+
+    this->deferredFile = fullPathFile;
+    this->deferredRelativeFile = relativePathFile;
+    this->name = fullPathFile.getFileNameWithoutExtension();
+
+    // the cached stats are only valid, if the file was not changed since
+    const File file(fullPathFile.existsAsFile() ? fullPathFile : relativePathFile);
+    const int64 lastModified = tree.getProperty(Serialization::Core::cachedProjectTime, 0);
+    this->cachedId = tree.getProperty(Serialization::Core::cachedProjectId);
+    this->cachedLastModified = file.getLastModificationTime();
+    if (this->cachedLastModified.toMilliseconds() == lastModified)
+    {
+        this->cachedStats = tree.getProperty(Serialization::Core::cachedProjectStats);
+    }
+}
+
+bool ProjectTreeItem::isLoaded() const noexcept
+{
+    return this->deferredFile == File() && this->deferredRelativeFile == File();
+}
+
+void ProjectTreeItem::loadIfDeferred()
+{
+    if (this->isLoaded())
+    {
+        return;
+    }
+
+    const File fullPathFile(this->deferredFile);
+    const File relativePathFile(this->deferredRelativeFile);
+    this->deferredFile = File();
+    this->deferredRelativeFile = File();
+
+    const double startTime = Time::getMillisecondCounterHiRes();
     this->getDocument()->load(fullPathFile, relativePathFile);
+    Logger::writeToLog("Loaded project " + this->getName() + " in " +
+        String(Time::getMillisecondCounterHiRes() - startTime, 1) + " ms");
+}
+
+void ProjectTreeItem::loadAsync()
+{
+    if (this->isLoaded() || this->loaderThread != nullptr)
+    {
+        return;
+    }
+
+    const File file(this->deferredFile.existsAsFile() ?
+        this->deferredFile : this->deferredRelativeFile);
+
+    if (! file.existsAsFile())
+    {
+        // let the document ask for the file
+        this->loadIfDeferred();
+        return;
+    }
+
+    this->loaderThread = new LoaderThread(*this, file);
+    this->loaderThread->startThread();
+}
+
+void ProjectTreeItem::onAsyncLoadDone(const File &file, const ValueTree &tree)
+{
+    this->loaderThread = nullptr;
+
+    // might have been loaded synchronously in the meantime
+    if (this->isLoaded())
+    {
+        return;
+    }
+
+    this->deferredFile = File();
+    this->deferredRelativeFile = File();
+
+    const double startTime = Time::getMillisecondCounterHiRes();
+    this->preloadedTree = tree;
+    this->getDocument()->load(file, file);
+    this->preloadedTree = ValueTree();
+    Logger::writeToLog("Applied project " + this->getName() + " in " +
+        String(Time::getMillisecondCounterHiRes() - startTime, 1) + " ms");
+
+    if (App::Workspace().getActiveTreeItem() == this)
+    {
+        this->showPage();
+    }
+}
+
+bool ProjectTreeItem::unload()
+{
+    if (! this->isLoaded() ||
+        this->loaderThread != nullptr ||
+        this->transport->isPlaying() ||
+        this->transport->isRendering() ||
+        this->transport->isFreezing())
+    {
+        return false;
+    }
+
+    this->getDocument()->save();
+
+    const File file(this->getDocument()->getFullPath());
+    this->cachedId = this->getId();
+    this->cachedStats = this->getStats();
+    this->cachedLastModified = file.getLastModificationTime();
+
+    if (this->recentFilesList != nullptr)
+    {
+        this->recentFilesList->
+        onProjectStateChanged(this->getName(),
+                              file.getFullPathName(),
+                              this->cachedId,
+                              false);
+    }
+
+    this->deferredFile = file;
+    this->deferredRelativeFile = DocumentHelpers::getDocumentSlot(file.getFileName());
+
+    this->reset();
+    this->info->reset();
+    this->timeline->reset();
+
+    // notify the listeners directly: the broadcasts also send a change message,
+    // which would mark the now empty document as changed and arm the autosaver
+    this->changeListeners.call(&ProjectListener::onReloadProjectContent, this->getTracks());
+    const auto range = this->getProjectRangeInBeats();
+    this->transport->onChangeProjectBeatRange(range.getX(), range.getY());
+    this->changeListeners.call(&ProjectListener::onChangeProjectBeatRange, range.getX(), range.getY());
+
+    Logger::writeToLog("Unloaded project " + this->getName());
+    return true;
+}
+
+double ProjectTreeItem::getLastActivationTime() const noexcept
+{
+    return this->lastActivationTime;
 }
 
 void ProjectTreeItem::reset()
@@ -769,6 +1012,12 @@ void ProjectTreeItem::broadcastChangeViewBeatRange(float firstBeat, float lastBe
 
 bool ProjectTreeItem::onDocumentLoad(File &file)
 {
+    if (this->preloadedTree.isValid())
+    {
+        this->load(this->preloadedTree);
+        return true;
+    }
+
     if (file.existsAsFile())
     {
         const ValueTree tree(DocumentHelpers::load(file));
@@ -796,6 +1045,12 @@ void ProjectTreeItem::onDocumentDidLoad(File &file)
 
 bool ProjectTreeItem::onDocumentSave(File &file)
 {
+    // an unloaded project is empty, it must never overwrite its file
+    if (!this->isLoaded())
+    {
+        return false;
+    }
+
     const auto projectNode(this->save());
     // Debug:
     DocumentHelpers::save<XmlSerializer>(file.withFileExtension("xml"), projectNode);
@@ -59,6 +59,20 @@ public:
     ~ProjectTreeItem() override;
     
     void deletePermanently();
+
+    // Only the last active project is loaded along with the workspace,
+    // others are only pointing to their files until loaded later
+    bool isLoaded() const noexcept;
+    void loadIfDeferred();
+
+    // Parses the document on a background thread and applies it
+    // on the message thread, showing the page again when done
+    void loadAsync();
+
+    // Saves and releases the project contents, keeping the summary;
+    // returns false, if the project is busy and cannot be unloaded
+    bool unload();
+    double getLastActivationTime() const noexcept;
     
     String getId() const;
     String getStats() const;
@@ -214,6 +228,21 @@ private:
 
     WeakReference<TreeItem> lastShownTrack;
 
+    File deferredFile;
+    File deferredRelativeFile;
+
+    // the summary shown while the project is not loaded
+    String cachedId;
+    String cachedStats;
+    Time cachedLastModified;
+
+    double lastActivationTime;
+
+    class LoaderThread;
+    ScopedPointer<LoaderThread> loaderThread;
+    ValueTree preloadedTree;
+    void onAsyncLoadDone(const File &file, const ValueTree &tree);
+
 private:
 
     void initialize();
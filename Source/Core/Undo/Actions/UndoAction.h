@@ -30,6 +30,8 @@ public:
     virtual bool perform() = 0;
     virtual bool undo() = 0;
 
+    // An approximate memory footprint of the action, in bytes,
+    // used by the undo stack to fit the history into its budget
     virtual int getSizeInUnits()
     {
         return 10;
@@ -19,6 +19,7 @@
 #include "UndoStack.h"
 #include "UndoAction.h"
 #include "SerializationKeys.h"
+#include "Profiler.h"
 
 #include "ProjectTreeItem.h"
 
@@ -34,14 +35,135 @@
 
 #define MAX_TRANSACTIONS_TO_STORE 10
 
+// The most recent transactions are always kept as live actions
+#define NUM_HOT_TRANSACTIONS 20
+
+// Packed transactions never get serialized, so there is no need to persist them
+static_assert(MAX_TRANSACTIONS_TO_STORE <= NUM_HOT_TRANSACTIONS,
+    "Undo stack should only serialize the transactions that are never packed");
+
 using namespace Serialization;
 
+//===----------------------------------------------------------------------===//
+// Packed transaction
+//===----------------------------------------------------------------------===//
+
+UndoStack::PackedTransaction::PackedTransaction(const ValueTree &tree) :
+    isCompressed(false),
+    isDetached(false)
+{
+    MemoryOutputStream out(this->data, false);
+    tree.writeToStream(out);
+}
+
+// Accounts the saved bytes in the stack's total, unless the transaction
+// has been unpacked or removed from the stack in the meantime
+void UndoStack::PackedTransaction::compress(Atomic<int64> &totalSize)
+{
+    {
+        const ScopedLock lock(this->dataLock);
+        if (this->isDetached)
+        {
+            return;
+        }
+    }
+
+    MemoryBlock compressedData;
+
+    {
+        // the raw data is never modified once packed,
+        // so we only need a lock to swap it afterwards
+        MemoryOutputStream out(compressedData, false);
+        GZIPCompressorOutputStream compressedOut(&out, 9, false);
+        compressedOut.write(this->data.getData(), this->data.getSize());
+        compressedOut.flush();
+    }
+
+    const ScopedLock lock(this->dataLock);
+    if (this->isDetached)
+    {
+        return;
+    }
+
+    totalSize += int64(compressedData.getSize()) - int64(this->data.getSize());
+    this->data.swapWith(compressedData);
+    this->isCompressed = true;
+}
+
+ValueTree UndoStack::PackedTransaction::unpack() const
+{
+    const ScopedLock lock(this->dataLock);
+    MemoryInputStream in(this->data, false);
+
+    if (this->isCompressed)
+    {
+        GZIPDecompressorInputStream decompressedIn(in);
+        return ValueTree::readFromStream(decompressedIn);
+    }
+
+    return ValueTree::readFromStream(in);
+}
+
+int64 UndoStack::PackedTransaction::getSize() const
+{
+    const ScopedLock lock(this->dataLock);
+    return int64(this->data.getSize());
+}
+
+// Stops the pending compression from changing the size,
+// and returns the size at which the data is accounted
+int64 UndoStack::PackedTransaction::detach()
+{
+    const ScopedLock lock(this->dataLock);
+    this->isDetached = true;
+    return int64(this->data.getSize());
+}
+
+class UndoStack::PackingJob final : public ThreadPoolJob
+{
+public:
+
+    PackingJob(PackedTransaction *target, Atomic<int64> &totalSize) :
+        ThreadPoolJob("Undo packing job"),
+        transaction(target),
+        totalSize(totalSize) {}
+
+    JobStatus runJob() override
+    {
+        this->transaction->compress(this->totalSize);
+        return jobHasFinished;
+    }
+
+private:
+
+    // holds a reference, so that the transaction can be
+    // safely dropped from the stack while being compressed
+    const PackedTransaction::Ptr transaction;
+
+    // the undo stack waits for all jobs before it is deleted
+    Atomic<int64> &totalSize;
+
+    JUCE_DECLARE_NON_COPYABLE(PackingJob)
+};
+
+//===----------------------------------------------------------------------===//
+// Action set
+//===----------------------------------------------------------------------===//
+
 UndoStack::ActionSet::ActionSet(ProjectTreeItem &project, const String &transactionName) :
     project(project),
-    name(transactionName) {}
+    name(transactionName),
+    actionsSize(0) {}
+
+UndoStack::ActionSet::~ActionSet()
+{
+    this->reset();
+}
     
-bool UndoStack::ActionSet::perform() const
+bool UndoStack::ActionSet::perform()
 {
+    this->unpack();
+
     for (int i = 0; i < actions.size(); ++i)
     {
         if (! actions.getUnchecked(i)->perform())
@@ -53,8 +175,10 @@ bool UndoStack::ActionSet::perform() const
     return true;
 }
     
-bool UndoStack::ActionSet::undo() const
+bool UndoStack::ActionSet::undo()
 {
+    this->unpack();
+
     for (int i = actions.size(); --i >= 0;)
     {
         if (! actions.getUnchecked(i)->undo())
@@ -66,19 +190,61 @@ bool UndoStack::ActionSet::undo() const
     return true;
 }
     
-int UndoStack::ActionSet::getTotalSize() const
+int64 UndoStack::ActionSet::getTotalSize() const
 {
-    int total = 0;
-    for (int i = actions.size(); --i >= 0;)
+    return this->isPacked() ? this->packedActions->getSize() : this->actionsSize;
+}
+
+// The size at which the set is accounted in the stack's total, once
+// it is about to be unpacked or removed, so it won't change in the background
+int64 UndoStack::ActionSet::detachTotalSize()
+{
+    return this->isPacked() ? this->packedActions->detach() : this->actionsSize;
+}
+
+bool UndoStack::ActionSet::isPacked() const noexcept
+{
+    return this->packedActions != nullptr;
+}
+
+UndoStack::PackedTransaction *UndoStack::ActionSet::pack()
+{
+    if (this->isPacked())
     {
-        total += actions.getUnchecked(i)->getSizeInUnits();
+        return nullptr;
     }
-        
-    return total;
+
+    this->packedActions = new PackedTransaction(this->serialize());
+    this->actions.clear();
+    return this->packedActions;
+}
+
+bool UndoStack::ActionSet::unpack()
+{
+    if (! this->isPacked())
+    {
+        return false;
+    }
+
+    const ValueTree tree(this->packedActions->unpack());
+    this->packedActions->detach();
+    this->packedActions = nullptr;
+
+    for (const auto &childAction : tree)
+    {
+        if (UndoAction *action = createUndoActionsByTagName(childAction.getType()))
+        {
+            action->deserialize(childAction);
+            this->actions.add(action);
+        }
+    }
+
+    return true;
 }
     
 ValueTree UndoStack::ActionSet::serialize() const
 {
+    jassert(!this->isPacked());
     ValueTree tree(Serialization::Undo::transaction);
 
     for (int i = 0; i < this->actions.size(); ++i)
@@ -98,6 +264,7 @@ void UndoStack::ActionSet::deserialize(const ValueTree &tree)
         if (UndoAction *action = createUndoActionsByTagName(childAction.getType()))
         {
             action->deserialize(childAction);
+            this->actionsSize += action->getSizeInUnits();
             this->actions.add(action);
         }
     }
@@ -105,7 +272,14 @@ void UndoStack::ActionSet::deserialize(const ValueTree &tree)
     
 void UndoStack::ActionSet::reset()
 {
+    if (this->isPacked())
+    {
+        this->packedActions->detach();
+    }
+
     this->actions.clear();
+    this->packedActions = nullptr;
+    this->actionsSize = 0;
 }
 
 UndoAction *UndoStack::ActionSet::createUndoActionsByTagName(const Identifier &tagName)
@@ -159,25 +333,49 @@ UndoAction *UndoStack::ActionSet::createUndoActionsByTagName(const Identifier &t
     return nullptr;
 }
 
+//===----------------------------------------------------------------------===//
+// Undo stack
+//===----------------------------------------------------------------------===//
+
 UndoStack::UndoStack(ProjectTreeItem &parentProject,
-    int maxNumberOfUnitsToKeep,
+    int64 memoryBudgetInBytes,
     int minimumTransactions) :
     project(parentProject),
-    totalUnitsStored(0),
+    packingPool(1),
     nextIndex(0),
     newTransaction(true),
     reentrancyCheck(false),
-    maxNumUnitsToKeep(maxNumberOfUnitsToKeep),
+    memoryBudget(memoryBudgetInBytes),
+    totalSize(0),
+    numPackedTransactions(0),
     minimumTransactionsToKeep(minimumTransactions) {}
 
+UndoStack::~UndoStack()
+{
+    // the jobs refer to the total size, so wait for them all
+    this->packingPool.removeAllJobs(true, -1);
+}
+
 void UndoStack::clearUndoHistory()
 {
     this->transactions.clear();
-    this->totalUnitsStored = 0;
     this->nextIndex = 0;
+    this->totalSize = 0;
+    this->numPackedTransactions = 0;
     this->sendChangeMessage();
 }
 
+void UndoStack::setMemoryBudget(int64 newBudgetInBytes)
+{
+    this->memoryBudget = newBudgetInBytes;
+    this->trimToMemoryBudget();
+}
+
+int64 UndoStack::getMemoryFootprint() const
+{
+    return this->totalSize.get();
+}
+
 bool UndoStack::perform (UndoAction *const newAction, const String &actionName)
 {
     if (this->perform(newAction))
@@ -197,6 +395,8 @@ bool UndoStack::perform (UndoAction *const newAction)
 {
     if (newAction != nullptr)
     {
+        PROFILE_SCOPE("UndoStack::perform");
+
         ScopedPointer<UndoAction> action (newAction);
         
         if (this->reentrancyCheck)
@@ -208,64 +408,117 @@ bool UndoStack::perform (UndoAction *const newAction)
 
         if (action->perform())
         {
-            ActionSet *actionSet = getCurrentSet();
-            
-            if (actionSet != nullptr && ! newTransaction)
+            this->storeAction(action.release());
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void UndoStack::storeAction(UndoAction *const newAction)
+{
+    ScopedPointer<UndoAction> action (newAction);
+    ActionSet *actionSet = getCurrentSet();
+    
+    if (actionSet != nullptr && ! newTransaction)
+    {
+        this->unpackSet(this->nextIndex - 1);
+
+        for (signed int i = (actionSet->actions.size() - 1); i >= 0; --i)
+        {
+            if (UndoAction *const lastAction = actionSet->actions[i])
             {
-                for (signed int i = (actionSet->actions.size() - 1); i >= 0; --i)
+                if (UndoAction *const coalescedAction = lastAction->createCoalescedAction(action))
                 {
-                    if (UndoAction *const lastAction = actionSet->actions[i])
-                    {
-                        if (UndoAction *const coalescedAction = lastAction->createCoalescedAction(action))
-                        {
-                            action = coalescedAction;
-                            this->totalUnitsStored -= lastAction->getSizeInUnits();
-                            actionSet->actions.remove(i);
-                            break;
-                        }
-                    }
+                    action = coalescedAction;
+                    actionSet->actionsSize -= lastAction->getSizeInUnits();
+                    this->totalSize -= lastAction->getSizeInUnits();
+                    actionSet->actions.remove(i);
+                    break;
                 }
             }
-            else
-            {
-                actionSet = new ActionSet(this->project, newTransactionName);
-                transactions.insert (nextIndex, actionSet);
-                ++nextIndex;
-            }
-            
-            this->totalUnitsStored += action->getSizeInUnits();
-            actionSet->actions.add(action.release());
-            this->newTransaction = false;
-            //Logger::writeToLog("size " + String(actionSet->actions.size()));
-            
-            this->clearFutureTransactions();
-            this->sendChangeMessage();
-            return true;
         }
     }
+    else
+    {
+        actionSet = new ActionSet(this->project, newTransactionName);
+        transactions.insert (nextIndex, actionSet);
+        ++nextIndex;
+    }
     
-    return false;
+    actionSet->actionsSize += action->getSizeInUnits();
+    this->totalSize += action->getSizeInUnits();
+    actionSet->actions.add(action.release());
+    this->newTransaction = false;
+    
+    this->clearFutureTransactions();
+    this->sendChangeMessage();
 }
 
 void UndoStack::clearFutureTransactions()
 {
     while (this->nextIndex < this->transactions.size())
     {
-        this->totalUnitsStored -= transactions.getLast()->getTotalSize();
-        this->transactions.removeLast();
+        this->removeSet(this->transactions.size() - 1);
     }
     
+    this->trimToMemoryBudget();
+}
+
+void UndoStack::unpackSet(int index) const
+{
+    ActionSet *set = this->transactions[index];
+    if (set != nullptr && set->isPacked())
+    {
+        this->totalSize -= set->detachTotalSize();
+        set->unpack();
+        this->totalSize += set->getTotalSize();
+        this->numPackedTransactions = jmin(this->numPackedTransactions, index);
+    }
+}
+
+void UndoStack::removeSet(int index)
+{
+    this->totalSize -= this->transactions.getUnchecked(index)->detachTotalSize();
+    this->transactions.remove(index);
+
+    if (index < this->numPackedTransactions)
+    {
+        --this->numPackedTransactions;
+    }
+
+    this->numPackedTransactions = jmin(this->numPackedTransactions, this->transactions.size());
+
+    // if this fails, then some actions may not be returning
+    // consistent results from their getSizeInUnits() method
+    jassert(this->totalSize.get() >= 0);
+}
+
+void UndoStack::trimToMemoryBudget()
+{
+    // older transactions are unlikely to be undone soon,
+    // so they are packed into a compact binary form first,
+    // and then compressed in the background, which shrinks
+    // the total size once again as soon as each job is done
+    for (; this->numPackedTransactions < (this->nextIndex - NUM_HOT_TRANSACTIONS);
+        ++this->numPackedTransactions)
+    {
+        auto *set = this->transactions.getUnchecked(this->numPackedTransactions);
+        const int64 liveSize = set->getTotalSize();
+        if (PackedTransaction *packed = set->pack())
+        {
+            this->totalSize += packed->getSize() - liveSize;
+            this->packingPool.addJob(new PackingJob(packed, this->totalSize), true);
+        }
+    }
+
     while (this->nextIndex > 0
-           && this->totalUnitsStored > this->maxNumUnitsToKeep
+           && this->totalSize.get() > this->memoryBudget
            && this->transactions.size() > this->minimumTransactionsToKeep)
     {
-        this->totalUnitsStored -= this->transactions.getFirst()->getTotalSize();
-        this->transactions.remove (0);
+        this->removeSet(0);
         --this->nextIndex;
-        
-        // if this fails, then some actions may not be returning
-        // consistent results from their getSizeInUnits() method
-        jassert (this->totalUnitsStored >= 0);
     }
 }
 
@@ -303,6 +556,7 @@ bool UndoStack::undo()
     if (const auto s = getCurrentSet())
     {
         const ScopedValueSetter<bool> setter(this->reentrancyCheck, true);
+        this->unpackSet(this->nextIndex - 1);
         
         if (s->undo())
         {
@@ -323,9 +577,10 @@ bool UndoStack::undo()
 
 bool UndoStack::redo()
 {
-    if (const ActionSet *const s = this->getNextSet())
+    if (const auto s = this->getNextSet())
     {
         const ScopedValueSetter<bool> setter(this->reentrancyCheck, true);
+        this->unpackSet(this->nextIndex);
         
         if (s->perform())
         {
@@ -375,6 +630,7 @@ void UndoStack::getActionsInCurrentTransaction(Array<const UndoAction *> &action
     {
         if (const auto s = this->getCurrentSet())
         {
+            this->unpackSet(this->nextIndex - 1);
             for (int i = 0; i < s->actions.size(); ++i)
             {
                 actionsFound.add(s->actions.getUnchecked(i));
@@ -387,6 +643,7 @@ int UndoStack::getNumActionsInCurrentTransaction() const
 {
     if (!this->newTransaction) {
         if (const auto s = this->getCurrentSet()) {
+            this->unpackSet(this->nextIndex - 1);
             return s->actions.size();
         }
     }
@@ -434,9 +691,12 @@ void UndoStack::deserialize(const ValueTree &tree)
     {
         auto actionSet = new ActionSet(this->project, {});
         actionSet->deserialize(childTransaction);
+        this->totalSize += actionSet->getTotalSize();
         this->transactions.insert(this->nextIndex, actionSet);
         ++this->nextIndex;
     }
+
+    this->trimToMemoryBudget();
 }
 
 void UndoStack::reset()
@@ -21,16 +21,26 @@ class ProjectTreeItem;
 
 #include "UndoAction.h"
 
+// Default budget for the whole undo history, in bytes: live transactions
+// are estimated by the actions' getSizeInUnits(), packed ones are counted
+// by the actual size of their (eventually compressed) binary data
+#define UNDO_STACK_DEFAULT_MEMORY_BUDGET (32 * 1024 * 1024)
+
 class UndoStack final : public ChangeBroadcaster, public Serializable
 {
 public:
 
     explicit UndoStack(ProjectTreeItem &parentProject,
-        int maxNumberOfUnitsToKeep = 30000,
+        int64 memoryBudgetInBytes = UNDO_STACK_DEFAULT_MEMORY_BUDGET,
         int minimumTransactionsToKeep = 30);
+
+    ~UndoStack() override;
     
     void clearUndoHistory();
 
+    void setMemoryBudget(int64 newBudgetInBytes);
+    int64 getMemoryFootprint() const;
+
     bool perform(UndoAction *action);
     bool perform(UndoAction *action, const String &actionName);
     
@@ -59,13 +69,40 @@ private:
 
     ProjectTreeItem &project;
     
+    // Cold transactions are kept as a binary ValueTree stream,
+    // which gets gzipped by a background job once it is packed
+    struct PackedTransaction final : public ReferenceCountedObject
+    {
+        typedef ReferenceCountedObjectPtr<PackedTransaction> Ptr;
+
+        explicit PackedTransaction(const ValueTree &tree);
+
+        void compress(Atomic<int64> &totalSize);
+        ValueTree unpack() const;
+        int64 getSize() const;
+        int64 detach();
+
+        CriticalSection dataLock;
+        MemoryBlock data;
+        bool isCompressed;
+        bool isDetached;
+    };
+
+    class PackingJob;
+
     struct ActionSet final : public Serializable
     {
         ActionSet(ProjectTreeItem &project, const String &transactionName);
+        ~ActionSet() override;
 
-        bool perform() const;
-        bool undo() const;
-        int getTotalSize() const;
+        bool perform();
+        bool undo();
+        int64 getTotalSize() const;
+        int64 detachTotalSize();
+
+        bool isPacked() const noexcept;
+        PackedTransaction *pack();
+        bool unpack();
 
         ValueTree serialize() const;
         void deserialize(const ValueTree &tree);
@@ -74,6 +111,10 @@ private:
         UndoAction *createUndoActionsByTagName(const Identifier &tagName);
 
         OwnedArray<UndoAction> actions;
+        PackedTransaction::Ptr packedActions;
+
+        // Estimated size of the live actions
+        int64 actionsSize;
         String name;
 
         ProjectTreeItem &project;
@@ -81,14 +122,30 @@ private:
     
     OwnedArray<ActionSet> transactions;
     String newTransactionName;
+
+    ThreadPool packingPool;
     
-    int totalUnitsStored, maxNumUnitsToKeep, minimumTransactionsToKeep, nextIndex;
+    int64 memoryBudget;
+
+    // Updated by the packing jobs as well, when they are done compressing
+    mutable Atomic<int64> totalSize;
+
+    // All transactions before this index are known to be packed,
+    // so that packing only visits the ones that went cold recently;
+    // it is lowered whenever an older transaction is unpacked
+    mutable int numPackedTransactions;
+
+    int minimumTransactionsToKeep, nextIndex;
     bool newTransaction, reentrancyCheck;
     
     ActionSet *getCurrentSet() const noexcept;
     ActionSet *getNextSet() const noexcept;
+    void unpackSet(int index) const;
+    void removeSet(int index);
     
+    void storeAction(UndoAction *action);
     void clearFutureTransactions();
+    void trimToMemoryBudget();
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UndoStack)
 };
@@ -25,10 +25,12 @@
 
 #include "Diff.h"
 #include "DiffLogic.h"
+#include "Profiler.h"
 
 using namespace VCS;
 
 #define DIFF_BUILD_THREAD_STOP_TIMEOUT 5000
+#define CHECKOUT_JOBS_STOP_TIMEOUT 5000
 
 Head::Head(const Head &other) :
     Thread("Diff Thread"),
@@ -58,6 +60,12 @@ Head::Head(Pack::Ptr packPtr, WeakReference<TrackedItemsSource> targetProject) :
     }
 }
 
+Head::~Head()
+{
+    this->checkoutPool = nullptr;
+    this->cancelPendingUpdate();
+}
+
 ValueTree Head::getHeadingRevision() const
 {
     return this->headingAt;
@@ -312,14 +320,177 @@ bool Head::resetChangedItemToState(const VCS::RevisionItem::Ptr diffItem)
     return false;
 }
 
-void Head::checkout()
+//===----------------------------------------------------------------------===//
+// Checkout
+//===----------------------------------------------------------------------===//
+
+class Head::CheckoutJob final : public ThreadPoolJob
 {
-    if (this->targetVcsItemsSource == nullptr)
-    { return; }
+public:
 
-    if (this->state == nullptr)
-    { return; }
+    CheckoutJob(Head &head, int generation, int index, RevisionItem::Ptr stateItem) :
+        ThreadPoolJob("Checkout job"),
+        head(head),
+        generation(generation),
+        index(index),
+        stateItem(stateItem) {}
+
+    JobStatus runJob() override
+    {
+        if (this->shouldExit())
+        {
+            return jobHasFinished;
+        }
+
+        // a detached copy reads and decodes all the deltas data from pack,
+        // which is the slowest part of checkout, so that the message thread
+        // only has to apply the ready-made state
+        RevisionItem::Ptr decodedItem(new RevisionItem(this->stateItem->getPackPtr(),
+            this->stateItem->getType(), this->stateItem.get()));
+
+        if (! this->shouldExit())
+        {
+            this->head.onCheckoutItemDecoded(this->generation, this->index, decodedItem);
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+
+    Head &head;
+    const int generation;
+    const int index;
+    const RevisionItem::Ptr stateItem;
+
+    JUCE_DECLARE_NON_COPYABLE(CheckoutJob)
+};
+
+void Head::checkout(CheckoutCallback callback)
+{
+    if (this->targetVcsItemsSource == nullptr || this->state == nullptr)
+    {
+        if (callback != nullptr) { callback(false); }
+        return;
+    }
+
+    this->cancelCheckout();
+
+    const int numItems = this->state->getNumTrackedItems();
+    if (numItems == 0)
+    {
+        this->applyCheckout({});
+        if (callback != nullptr) { callback(true); }
+        return;
+    }
+
+    if (this->checkoutPool == nullptr)
+    {
+        this->checkoutPool = new ThreadPool(SystemStats::getNumCpus());
+    }
+
+    this->checkoutCallback = callback;
+    int generation;
+
+    {
+        const ScopedLock lock(this->checkoutLock);
+        generation = ++this->checkoutGeneration;
+        this->numCheckoutItemsDecoded = 0;
+        this->checkoutItems.clearQuick();
+        this->checkoutItems.insertMultiple(0, nullptr, numItems);
+    }
+
+    for (int i = 0; i < numItems; ++i)
+    {
+        RevisionItem::Ptr stateItem = static_cast<RevisionItem *>(this->state->getTrackedItem(i));
+        this->checkoutPool->addJob(new CheckoutJob(*this, generation, i, stateItem), true);
+    }
+}
+
+void Head::cancelCheckout()
+{
+    if (! this->isCheckingOut())
+    {
+        return;
+    }
+
+    if (this->checkoutPool != nullptr)
+    {
+        this->checkoutPool->removeAllJobs(true, CHECKOUT_JOBS_STOP_TIMEOUT);
+    }
+
+    this->cancelPendingUpdate();
+
+    {
+        const ScopedLock lock(this->checkoutLock);
+        ++this->checkoutGeneration;
+        this->checkoutItems.clear();
+    }
+
+    CheckoutCallback callback;
+    std::swap(callback, this->checkoutCallback);
+    if (callback != nullptr)
+    {
+        callback(false);
+    }
+}
+
+bool Head::isCheckingOut() const noexcept
+{
+    const ScopedLock lock(this->checkoutLock);
+    return this->checkoutItems.size() > 0;
+}
+
+float Head::getCheckoutProgress() const noexcept
+{
+    const ScopedLock lock(this->checkoutLock);
+    const int numItems = this->checkoutItems.size();
+    return (numItems > 0) ? (float(this->numCheckoutItemsDecoded.get()) / float(numItems)) : 1.f;
+}
+
+void Head::onCheckoutItemDecoded(int generation, int index, RevisionItem::Ptr decodedItem)
+{
+    const ScopedLock lock(this->checkoutLock);
+    if (generation != this->checkoutGeneration)
+    {
+        return; // a job of a cancelled checkout, which has outlived the timeout
+    }
 
+    jassert(isPositiveAndBelow(index, this->checkoutItems.size()));
+    this->checkoutItems.set(index, decodedItem);
+
+    if (++this->numCheckoutItemsDecoded == this->checkoutItems.size())
+    {
+        this->triggerAsyncUpdate();
+    }
+}
+
+void Head::handleAsyncUpdate()
+{
+    Array<RevisionItem::Ptr> decodedItems;
+
+    {
+        const ScopedLock lock(this->checkoutLock);
+        decodedItems.swapWith(this->checkoutItems);
+    }
+
+    if (decodedItems.isEmpty())
+    {
+        return;
+    }
+
+    this->applyCheckout(decodedItems);
+
+    CheckoutCallback callback;
+    std::swap(callback, this->checkoutCallback);
+    if (callback != nullptr)
+    {
+        callback(true);
+    }
+}
+
+void Head::applyCheckout(const Array<RevisionItem::Ptr> &stateItems)
+{
     // clear all tracked items
     {
         Array<TrackedItem *> itemsToClear;
@@ -340,9 +511,8 @@ void Head::checkout()
         }
     }
 
-    for (int i = 0; i < this->state->getNumTrackedItems(); ++i)
+    for (const auto &stateItem : stateItems)
     {
-        RevisionItem::Ptr stateItem = static_cast<RevisionItem *>(this->state->getTrackedItem(i));
         this->checkoutItem(stateItem);
     }
 
@@ -590,6 +760,8 @@ void Head::run()
 
     if (this->state == nullptr)
     { return; }
+
+    PROFILE_SCOPE("Head::rebuildDiff");
     
     this->setRebuildingDiffMode(true);
     this->sendChangeMessage();
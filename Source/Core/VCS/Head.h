@@ -29,6 +29,7 @@ namespace VCS
 
     class Head :
         private Thread,
+        private AsyncUpdater, // applies the decoded checkout results
         public ChangeListener, // listens to project changes to set diff outdated
         public ChangeBroadcaster, // broadcasts the diff rebuild has started/ended
         public Serializable
@@ -39,6 +40,8 @@ namespace VCS
         explicit Head(Pack::Ptr packPtr,
              WeakReference<TrackedItemsSource> targetProject = nullptr);
 
+        ~Head() override;
+
         ValueTree getHeadingRevision() const;
         
         ValueTree getDiff() const;
@@ -55,7 +58,15 @@ namespace VCS
         bool moveTo(const ValueTree revision); // rebuilds state index
         void pointTo(const ValueTree revision); // does not rebuild index
 
-        void checkout();
+        using CheckoutCallback = Function<void(bool succeeded)>;
+
+        // Decodes all state items on a thread pool, then applies them to the
+        // project in one batch on the message thread and calls back
+        void checkout(CheckoutCallback callback = nullptr);
+        void cancelCheckout();
+        bool isCheckingOut() const noexcept;
+        float getCheckoutProgress() const noexcept;
+
         void cherryPick(const Array<Uuid> uuids);
         void cherryPickAll();
         bool resetChanges(const Array<RevisionItem::Ptr> &changes);
@@ -86,6 +97,27 @@ namespace VCS
 
         void run() override;
         void checkoutItem(VCS::RevisionItem::Ptr stateItem);
+
+        //===--------------------------------------------------------------===//
+        // Checkout
+        //===--------------------------------------------------------------===//
+
+        class CheckoutJob;
+
+        void handleAsyncUpdate() override;
+        void onCheckoutItemDecoded(int generation, int index, RevisionItem::Ptr decodedItem);
+        void applyCheckout(const Array<RevisionItem::Ptr> &stateItems);
+
+        ScopedPointer<ThreadPool> checkoutPool;
+        CheckoutCallback checkoutCallback;
+
+        CriticalSection checkoutLock;
+        Array<RevisionItem::Ptr> checkoutItems;
+        Atomic<int> numCheckoutItemsDecoded;
+
+        // Incremented by each checkout and cancellation, so that the jobs
+        // which could not be stopped in time won't deliver stale results
+        int checkoutGeneration = 0;
         bool resetChangedItemToState(const VCS::RevisionItem::Ptr diffItem);
 
         ReadWriteLock outdatedMarkerLock;
@@ -70,6 +70,21 @@ bool Pack::containsDeltaDataFor(const Uuid &itemId,
 }
 
 ValueTree Pack::createDeltaDataFor(const Uuid &itemId, const Uuid &deltaId) const
+{
+    // Only the raw bytes are copied under the locks, while parsing them,
+    // which is the slow part, can run on several checkout threads at once
+    MemoryBlock deltaData;
+    if (! this->readDeltaData(deltaId, deltaData))
+    {
+        jassertfalse;
+        return {};
+    }
+
+    MemoryInputStream deltaDataStream(deltaData, false);
+    return ValueTree::readFromStream(deltaDataStream);
+}
+
+bool Pack::readDeltaData(const Uuid &deltaId, MemoryBlock &result) const
 {
     const ScopedLock lock(this->packLocker);
     
@@ -81,7 +96,10 @@ ValueTree Pack::createDeltaDataFor(const Uuid &itemId, const Uuid &deltaId) cons
             if (/*header->itemId == itemId &&*/
                 header->deltaId == deltaId)
             {
-                return this->createSerializedData(header);
+                const ScopedLock streamLock(this->packStreamLock);
+                this->packStream->setPosition(header->startPosition);
+                this->packStream->readIntoMemoryBlock(result, header->numBytes);
+                return true;
             }
         }
     }
@@ -92,13 +110,12 @@ ValueTree Pack::createDeltaDataFor(const Uuid &itemId, const Uuid &deltaId) cons
         if (/*chunk->itemId == itemId &&*/
             chunk->deltaId == deltaId)
         {
-            MemoryInputStream chunkDataStream(chunk->data, false);
-            return ValueTree::readFromStream(chunkDataStream);
+            result = chunk->data;
+            return true;
         }
     }
 
-    jassertfalse;
-    return {};
+    return false;
 }
 
 void Pack::setDeltaDataFor(const Uuid &itemId, const Uuid &deltaId, const ValueTree &data)
@@ -67,6 +67,7 @@ namespace VCS
     protected:
 
         ValueTree createSerializedData(const DeltaDataHeader *header) const;
+        bool readDeltaData(const Uuid &deltaId, MemoryBlock &result) const;
 
     private:
 
@@ -232,16 +232,37 @@ void VersionControl::moveHead(const ValueTree revision)
     }
 }
 
-void VersionControl::checkout(const ValueTree revision)
+void VersionControl::checkout(const ValueTree revision, Function<void(bool succeeded)> onComplete)
 {
     if (! Revision::isEmpty(revision))
     {
+        this->head.cancelCheckout();
+
+        const ValueTree headRevision(this->head.getHeadingRevision());
         this->head.moveTo(revision);
-        this->head.checkout();
-        this->sendChangeMessage();
+        this->head.checkout([this, headRevision, onComplete](bool succeeded)
+        {
+            // the project is left untouched if checkout was cancelled
+            if (! succeeded)
+            {
+                this->head.moveTo(headRevision);
+            }
+
+            this->sendChangeMessage();
+
+            if (onComplete != nullptr)
+            {
+                onComplete(succeeded);
+            }
+        });
     }
 }
 
+void VersionControl::cancelCheckout()
+{
+    this->head.cancelCheckout();
+}
+
 void VersionControl::cherryPick(const ValueTree revision, const Array<Uuid> uuids)
 {
     if (! Revision::isEmpty(revision))
@@ -80,7 +80,8 @@ public:
     ValueTree getRoot() { return this->rootRevision; }
 
     void moveHead(const ValueTree revision);
-    void checkout(const ValueTree revision);
+    void checkout(const ValueTree revision, Function<void(bool succeeded)> onComplete = nullptr);
+    void cancelCheckout();
     void cherryPick(const ValueTree revision, const Array<Uuid> uuids);
 
     bool resetChanges(SparseSet<int> selectedItems);
@@ -132,6 +133,7 @@ protected:
 
 private:
 
+    JUCE_DECLARE_WEAK_REFERENCEABLE(VersionControl)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VersionControl)
 
 };
@@ -81,10 +81,12 @@ void GenericAudioMonitorComponent::run()
         Thread::sleep(jlimit(10, 100, 35 - this->skewTime));
         const double b = Time::getMillisecondCounterHiRes();
 
+        this->audioMonitor->updateSpectrum();
+        this->lPeak = this->audioMonitor->getPeak(0);
+        this->rPeak = this->audioMonitor->getPeak(1);
+
         for (int i = 0; i < GENERIC_METER_NUM_BANDS; ++i)
         {
-            this->lPeak = this->audioMonitor->getPeak(0);
-            this->rPeak = this->audioMonitor->getPeak(1);
             this->values[i] = this->audioMonitor->getInterpolatedSpectrumAtFrequency(kSpectrumFrequencies[i]);
         }
 
@@ -0,0 +1,153 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Common.h"
+#include "LevelMeterComponent.h"
+#include "AudioCore.h"
+#include "Instrument.h"
+#include "Workspace.h"
+#include "App.h"
+
+#define LEVEL_METER_COMPONENT_FPS 30
+#define LEVEL_METER_COMPONENT_TOLERANCE 0.001f
+
+LevelMeterComponent::LevelMeterComponent()
+{
+    this->setInterceptsMouseClicks(false, false);
+    this->setPaintingIsUnclipped(true);
+}
+
+void LevelMeterComponent::setInstrumentId(const String &id)
+{
+    if (this->instrumentId != id)
+    {
+        this->instrumentId = id;
+        this->instrument = nullptr;
+        this->levels = {};
+        this->repaint();
+    }
+
+    this->visibilityChanged();
+}
+
+//===----------------------------------------------------------------------===//
+// Levels
+//===----------------------------------------------------------------------===//
+
+LevelMeterComponent::Levels LevelMeterComponent::Levels::fromMeter(const LevelMeter &meter)
+{
+    Levels result;
+    for (int channel = 0; channel < LEVEL_METER_MAX_CHANNELS; ++channel)
+    {
+        result.peak[channel] = meter.getPeak(channel);
+        result.rms[channel] = meter.getRootMeanSquare(channel);
+        result.truePeak[channel] = meter.getTruePeak(channel);
+    }
+
+    return result;
+}
+
+bool LevelMeterComponent::Levels::differsFrom(const Levels &other) const noexcept
+{
+    for (int channel = 0; channel < LEVEL_METER_MAX_CHANNELS; ++channel)
+    {
+        if (std::abs(this->peak[channel] - other.peak[channel]) > LEVEL_METER_COMPONENT_TOLERANCE ||
+            std::abs(this->rms[channel] - other.rms[channel]) > LEVEL_METER_COMPONENT_TOLERANCE ||
+            std::abs(this->truePeak[channel] - other.truePeak[channel]) > LEVEL_METER_COMPONENT_TOLERANCE)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static inline float levelToProportion(float gain)
+{
+    return jlimit(0.f, 1.f, AudioCore::iecLevel(Decibels::gainToDecibels(gain)));
+}
+
+void LevelMeterComponent::paintLevels(Graphics &g, const Rectangle<float> &bounds, const Levels &levels)
+{
+    const float channelHeight = bounds.getHeight() / float(LEVEL_METER_MAX_CHANNELS);
+
+    for (int channel = 0; channel < LEVEL_METER_MAX_CHANNELS; ++channel)
+    {
+        const float y = bounds.getY() + channelHeight * channel;
+        const float rmsWidth = bounds.getWidth() * levelToProportion(levels.rms[channel]);
+        const float peakWidth = bounds.getWidth() * levelToProportion(levels.peak[channel]);
+        const float truePeakX = bounds.getX() + bounds.getWidth() * levelToProportion(levels.truePeak[channel]);
+        const bool isClipping = levels.truePeak[channel] > 1.f;
+
+        g.setColour(Colours::white.withAlpha(0.15f));
+        g.fillRect(bounds.getX(), y, peakWidth, channelHeight);
+
+        g.setColour(Colours::white.withAlpha(0.45f));
+        g.fillRect(bounds.getX(), y, rmsWidth, channelHeight);
+
+        g.setColour(isClipping ? Colours::red.withAlpha(0.85f) : Colours::white.withAlpha(0.65f));
+        g.fillRect(truePeakX - 1.f, y, 1.f, channelHeight);
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Component
+//===----------------------------------------------------------------------===//
+
+void LevelMeterComponent::paint(Graphics &g)
+{
+    LevelMeterComponent::paintLevels(g, this->getLocalBounds().toFloat(), this->levels);
+}
+
+void LevelMeterComponent::visibilityChanged()
+{
+    if (this->isVisible() && this->instrumentId.isNotEmpty())
+    {
+        this->startTimerHz(LEVEL_METER_COMPONENT_FPS);
+    }
+    else
+    {
+        this->stopTimer();
+    }
+}
+
+void LevelMeterComponent::timerCallback()
+{
+    if (!this->isShowing())
+    {
+        return;
+    }
+
+    // only searched for again when the instrument is not there yet or is gone
+    if (this->instrument == nullptr)
+    {
+        this->instrument = App::Workspace().getAudioCore().findInstrumentById(this->instrumentId);
+    }
+
+    Levels newLevels;
+    if (this->instrument != nullptr)
+    {
+        newLevels = Levels::fromMeter(this->instrument->getProcessorPlayer().getLevelMeter());
+    }
+
+    if (newLevels.differsFrom(this->levels))
+    {
+        this->levels = newLevels;
+        this->repaint();
+    }
+}
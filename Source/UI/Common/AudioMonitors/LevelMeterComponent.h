@@ -0,0 +1,62 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+class Instrument;
+
+#include "LevelMeter.h"
+
+// A lightweight meter polling an instrument's levels at display rate;
+// the instrument is looked up by id once and then held by a weak reference,
+// so that the meter never points to an instrument which has been removed
+
+class LevelMeterComponent final : public Component, private Timer
+{
+public:
+
+    LevelMeterComponent();
+
+    void setInstrumentId(const String &id);
+
+    struct Levels final
+    {
+        float peak[LEVEL_METER_MAX_CHANNELS] = {};
+        float rms[LEVEL_METER_MAX_CHANNELS] = {};
+        float truePeak[LEVEL_METER_MAX_CHANNELS] = {};
+
+        static Levels fromMeter(const LevelMeter &meter);
+        bool differsFrom(const Levels &other) const noexcept;
+    };
+
+    // Shared with the list rows which draw the meters themselves
+    static void paintLevels(Graphics &g, const Rectangle<float> &bounds, const Levels &levels);
+
+    void paint(Graphics &g) override;
+
+private:
+
+    void timerCallback() override;
+    void visibilityChanged() override;
+
+    String instrumentId;
+    WeakReference<Instrument> instrument;
+    Levels levels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeterComponent);
+};
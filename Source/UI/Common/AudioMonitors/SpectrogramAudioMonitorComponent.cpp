@@ -40,11 +40,20 @@ SpectrogramAudioMonitorComponent::SpectrogramAudioMonitorComponent(WeakReference
     Thread("Volume Component"),
     audioMonitor(targetAnalyzer),
     head(0),
-    skewTime(0)
+    skewTime(0),
+    ringImage(Image::ARGB, SPECTROGRAM_BUFFER_SIZE * 2, SPECTROGRAM_NUM_BANDS * 4, true),
+    ringImageHead(0)
 {
     this->setInterceptsMouseClicks(false, false);
     this->setPaintingIsUnclipped(true);
 
+    for (int i = 0; i < SPECTROGRAM_COLOUR_TABLE_SIZE; ++i)
+    {
+        const float dB = SPECTROGRAM_METER_MINDB + (SPECTROGRAM_METER_MAXDB - SPECTROGRAM_METER_MINDB) *
+            float(i) / float(SPECTROGRAM_COLOUR_TABLE_SIZE - 1);
+        this->colourTable[i] = Colours::white.withAlpha(AudioCore::iecLevel(dB));
+    }
+
     if (this->audioMonitor != nullptr)
     {
         this->startThread(6);
@@ -72,16 +81,18 @@ void SpectrogramAudioMonitorComponent::run()
         Thread::sleep(jlimit(10, 100, 35 - this->skewTime));
         const double b = Time::getMillisecondCounterHiRes();
 
-        // Move to the next row:
-        this->head = (this->head.get() + 1) % SPECTROGRAM_BUFFER_SIZE;
+        // Fill the next row, then publish it:
+        const int nextHead = (this->head.get() + 1) % SPECTROGRAM_BUFFER_SIZE;
 
-        // Update matrix:
+        this->audioMonitor->updateSpectrum();
         for (int i = 0; i < SPECTROGRAM_NUM_BANDS; ++i)
         {
-            this->spectrum[this->head.get()][i] =
+            this->spectrum[nextHead][i] =
                 this->audioMonitor->getInterpolatedSpectrumAtFrequency(kSpectrumFrequencies[i]);
         }
 
+        this->head = nextHead;
+
         this->triggerAsyncUpdate();
         const double a = Time::getMillisecondCounterHiRes();
         this->skewTime = int(a - b);
@@ -90,6 +101,18 @@ void SpectrogramAudioMonitorComponent::run()
 
 void SpectrogramAudioMonitorComponent::handleAsyncUpdate()
 {
+    const int newHead = this->head.get();
+    if (newHead == this->ringImageHead)
+    {
+        return;
+    }
+
+    while (this->ringImageHead != newHead)
+    {
+        this->ringImageHead = (this->ringImageHead + 1) % SPECTROGRAM_BUFFER_SIZE;
+        this->renderColumn(this->ringImageHead);
+    }
+
     this->repaint();
 }
 
@@ -97,13 +120,24 @@ void SpectrogramAudioMonitorComponent::handleAsyncUpdate()
 // Component
 //===----------------------------------------------------------------------===//
 
-inline static float iecLevel(float peak)
+void SpectrogramAudioMonitorComponent::renderColumn(int column)
 {
-    const float vauleInDb =
-        jlimit(SPECTROGRAM_METER_MINDB, SPECTROGRAM_METER_MAXDB,
-            20.0f * AudioCore::fastLog10(peak));
+    const int x = column * 2;
+    const int imageHeight = this->ringImage.getHeight();
+    this->ringImage.clear({ x, 0, 2, imageHeight });
+
+    const float tableScale = float(SPECTROGRAM_COLOUR_TABLE_SIZE - 1) /
+        (SPECTROGRAM_METER_MAXDB - SPECTROGRAM_METER_MINDB);
 
-    return AudioCore::iecLevel(vauleInDb);
+    // the lowest band used to be drawn right below the bottom edge, so it is skipped
+    for (int j = 1; j < SPECTROGRAM_NUM_BANDS; ++j)
+    {
+        const float dB = jlimit(SPECTROGRAM_METER_MINDB, SPECTROGRAM_METER_MAXDB,
+            20.0f * AudioCore::fastLog10(this->spectrum[column][j].get()));
+
+        const int index = roundToInt((dB - SPECTROGRAM_METER_MINDB) * tableScale);
+        this->ringImage.setPixelAt(x, imageHeight - j * 4, this->colourTable[index]);
+    }
 }
 
 void SpectrogramAudioMonitorComponent::paint(Graphics &g)
@@ -112,33 +146,13 @@ void SpectrogramAudioMonitorComponent::paint(Graphics &g)
     {
         return;
     }
-    
-    const int h = this->getHeight();
-    const int start = this->head.get();
 
-    // Head:
-    for (int i = start + 1; i < SPECTROGRAM_BUFFER_SIZE; ++i)
-    {
-        for (int j = SPECTROGRAM_NUM_BANDS; j-- > 0; )
-        {
-            const float x = float(i - start);
-            const float v = iecLevel(this->spectrum[i][j].get());
-            g.setColour(Colours::white.withAlpha(v));
-            g.drawHorizontalLine(h - j * 4, x * 2.f, x * 2.f + 1.f);
-            //g.drawHorizontalLine(h - j * 4 + 1, x * 2.f, x * 2.f + 1.f);
-        }
-    }
+    // The oldest column goes first, the newest one is the last:
+    const int w = this->ringImage.getWidth();
+    const int h = this->ringImage.getHeight();
+    const int y = this->getHeight() - h;
+    const int splitX = (this->ringImageHead + 1) * 2;
 
-    // Tail:
-    for (int i = 0; i <= start; ++i)
-    {
-        for (int j = SPECTROGRAM_NUM_BANDS; j-- > 0; )
-        {
-            const float x = float(i + (SPECTROGRAM_BUFFER_SIZE - start));
-            const float v = iecLevel(this->spectrum[i][j].get());
-            g.setColour(Colours::white.withAlpha(v));
-            g.drawHorizontalLine(h - j * 4, x * 2.f, x * 2.f + 1.f);
-            //g.drawHorizontalLine(h - j * 4 + 1, x * 2.f, x * 2.f + 1.f);
-        }
-    }
+    g.drawImage(this->ringImage, 2, y, w - splitX, h, splitX, 0, w - splitX, h);
+    g.drawImage(this->ringImage, 2 + w - splitX, y, splitX, h, 0, 0, splitX, h);
 }
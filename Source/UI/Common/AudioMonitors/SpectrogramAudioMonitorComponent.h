@@ -23,6 +23,7 @@ class AudioMonitor;
 
 #define SPECTROGRAM_BUFFER_SIZE (SEQUENCER_SIDEBAR_WIDTH / 2)
 #define SPECTROGRAM_NUM_BANDS (SEQUENCER_SIDEBAR_WIDTH / 2)
+#define SPECTROGRAM_COLOUR_TABLE_SIZE 256
 
 class SpectrogramAudioMonitorComponent :
     public Component, private Thread, private AsyncUpdater
@@ -44,15 +45,24 @@ private:
 
     void run() override;
     void handleAsyncUpdate() override;
+
+    void renderColumn(int column);
     
     WeakReference<AudioMonitor> audioMonitor;
     
-    Atomic<float> peakBuffer[SPECTROGRAM_BUFFER_SIZE];
     Atomic<float> spectrum[SPECTROGRAM_BUFFER_SIZE][SPECTROGRAM_NUM_BANDS];
 
+    // The last row filled by the analyzer thread
     Atomic<int> head;
     int skewTime;
 
+    // History is rendered incrementally into a ring image, one column per row,
+    // so that painting is just blitting its two halves; message thread only
+    Image ringImage;
+    int ringImageHead;
+
+    Colour colourTable[SPECTROGRAM_COLOUR_TABLE_SIZE];
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramAudioMonitorComponent)
 
 };
@@ -27,7 +27,9 @@
 WaveformAudioMonitorComponent::WaveformAudioMonitorComponent(WeakReference<AudioMonitor> targetAnalyzer) :
     Thread("Volume Component"),
     audioMonitor(targetAnalyzer),
-    skewTime(0)
+    head(0),
+    skewTime(0),
+    ringImageHead(0)
 {
     this->setInterceptsMouseClicks(false, false);
     this->setPaintingIsUnclipped(true);
@@ -59,23 +61,16 @@ void WaveformAudioMonitorComponent::run()
         Thread::sleep(jlimit(10, 100, 35 - this->skewTime));
         const double b = Time::getMillisecondCounterHiRes();
 
-        // Shift buffers:
-        for (int i = 0; i < WAVEFORM_METER_BUFFER_SIZE - 1; ++i)
-        {
-            this->lPeakBuffer[i] = this->lPeakBuffer[i + 1].get();
-            this->rPeakBuffer[i] = this->rPeakBuffer[i + 1].get();
-            this->lRmsBuffer[i] = this->lRmsBuffer[i + 1].get();
-            this->rRmsBuffer[i] = this->rRmsBuffer[i + 1].get();
-        }
+        // Fill the next column, then publish it:
+        const int i = (this->head.get() + 1) % WAVEFORM_METER_BUFFER_SIZE;
 
-        const int i = WAVEFORM_METER_BUFFER_SIZE - 1;
-
-        // Push next values:
         this->lPeakBuffer[i] = this->audioMonitor->getPeak(0);
         this->rPeakBuffer[i] = this->audioMonitor->getPeak(1);
         this->lRmsBuffer[i] = this->audioMonitor->getRootMeanSquare(0);
         this->rRmsBuffer[i] = this->audioMonitor->getRootMeanSquare(1);
 
+        this->head = i;
+
         this->triggerAsyncUpdate();
 
         const double a = Time::getMillisecondCounterHiRes();
@@ -85,6 +80,18 @@ void WaveformAudioMonitorComponent::run()
 
 void WaveformAudioMonitorComponent::handleAsyncUpdate()
 {
+    const int newHead = this->head.get();
+    if (newHead == this->ringImageHead || !this->ringImage.isValid())
+    {
+        return;
+    }
+
+    while (this->ringImageHead != newHead)
+    {
+        this->ringImageHead = (this->ringImageHead + 1) % WAVEFORM_METER_BUFFER_SIZE;
+        this->renderColumn(this->ringImageHead);
+    }
+
     this->repaint();
 }
 
@@ -101,30 +108,52 @@ inline static float iecLevel(float peak)
     return AudioCore::iecLevel(vauleInDb);
 }
 
+void WaveformAudioMonitorComponent::renderColumn(int column)
+{
+    const int x = column * 2;
+    const float midH = float(this->ringImage.getHeight()) / 2.f;
+    this->ringImage.clear({ x, 0, 2, this->ringImage.getHeight() });
+
+    Graphics g(this->ringImage);
+
+    const float peakL = iecLevel(this->lPeakBuffer[column].get()) * midH;
+    const float peakR = iecLevel(this->rPeakBuffer[column].get()) * midH;
+    g.setColour(Colours::white.withAlpha(0.1f));
+    g.drawVerticalLine(x + 1, midH - peakL, midH + peakR);
+
+    const float rmsL = iecLevel(this->lRmsBuffer[column].get()) * midH;
+    const float rmsR = iecLevel(this->rRmsBuffer[column].get()) * midH;
+    g.setColour(Colours::white.withAlpha(0.15f));
+    g.drawVerticalLine(x, midH - rmsL, midH + rmsR);
+}
+
 void WaveformAudioMonitorComponent::paint(Graphics &g)
 {
-    if (this->audioMonitor == nullptr)
+    if (this->audioMonitor == nullptr || !this->ringImage.isValid())
     {
         return;
     }
-    
-    const float midH = float(this->getHeight()) / 2.f;
 
-    g.setColour(Colours::white.withAlpha(0.1f));
+    // The oldest column goes first, the newest one is the last:
+    const int w = this->ringImage.getWidth();
+    const int h = this->ringImage.getHeight();
+    const int splitX = (this->ringImageHead + 1) * 2;
 
-    for (int i = 0; i < WAVEFORM_METER_BUFFER_SIZE; ++i)
+    g.drawImage(this->ringImage, 0, 0, w - splitX, h, splitX, 0, w - splitX, h);
+    g.drawImage(this->ringImage, w - splitX, 0, splitX, h, 0, 0, splitX, h);
+}
+
+void WaveformAudioMonitorComponent::resized()
+{
+    if (this->getHeight() <= 0)
     {
-        const float peakL = iecLevel(this->lPeakBuffer[i].get()) * midH;
-        const float peakR = iecLevel(this->rPeakBuffer[i].get()) * midH;
-        g.drawVerticalLine(1 + i * 2, midH - peakL, midH + peakR);
+        return;
     }
 
-    g.setColour(Colours::white.withAlpha(0.15f));
+    this->ringImage = Image(Image::ARGB, WAVEFORM_METER_BUFFER_SIZE * 2, this->getHeight(), true);
 
     for (int i = 0; i < WAVEFORM_METER_BUFFER_SIZE; ++i)
     {
-        const float rmsL = iecLevel(this->lRmsBuffer[i].get()) * midH;
-        const float rmsR = iecLevel(this->rRmsBuffer[i].get()) * midH;
-        g.drawVerticalLine(i * 2, midH - rmsL, midH + rmsR);
+        this->renderColumn(i);
     }
 }
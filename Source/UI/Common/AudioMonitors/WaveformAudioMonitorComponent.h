@@ -39,11 +39,14 @@ public:
     //===------------------------------------------------------------------===//
 
     void paint(Graphics &g) override;
+    void resized() override;
 
 private:
 
     void run() override;
     void handleAsyncUpdate() override;
+
+    void renderColumn(int column);
     
     WeakReference<AudioMonitor> audioMonitor;
     
@@ -53,8 +56,15 @@ private:
     Atomic<float> lRmsBuffer[WAVEFORM_METER_BUFFER_SIZE];
     Atomic<float> rRmsBuffer[WAVEFORM_METER_BUFFER_SIZE];
 
+    // The last column filled by the analyzer thread
+    Atomic<int> head;
     int skewTime;
 
+    // History is rendered incrementally into a ring image, one column per update,
+    // so that painting is just blitting its two halves; message thread only
+    Image ringImage;
+    int ringImageHead;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformAudioMonitorComponent)
 
 };
@@ -137,6 +137,7 @@ int CommandIDs::getIdForName(const String &command)
         CASE_FOR(ToggleShowHideCombo)
         CASE_FOR(StartDragViewport)
         CASE_FOR(EndDragViewport)
+        CASE_FOR(ToggleProfilerOverlay)
         CASE_FOR(SelectAudioDeviceType)
         CASE_FOR(SelectAudioDevice)
         CASE_FOR(SelectSampleRate)
@@ -68,6 +68,8 @@ namespace CommandIDs
         SelectAllEvents                 = 0x1004,
         SelectAllClips                  = 0x1005,
         NewTrackFromSelection           = 0x1006,
+        FreezeTrack                     = 0x1007,
+        UnfreezeTrack                   = 0x1008,
 
         // MidiRollCommandPanel
         DeleteEvents                    = 0x1601,
@@ -172,6 +174,8 @@ namespace CommandIDs
         StartDragViewport               = 0x3308,
         EndDragViewport                 = 0x3309,
 
+        ToggleProfilerOverlay           = 0x330A,
+
         SelectAudioDeviceType           = 0x3400,
         SelectAudioDevice               = 0x3500,
         SelectSampleRate                = 0x3600,
@@ -0,0 +1,175 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "ProfilerOverlay.h"
+#include "DocumentHelpers.h"
+#include "FrameScheduler.h"
+#include "MainWindow.h"
+
+#define PROFILER_OVERLAY_WINDOW_MS 5000.0
+#define PROFILER_OVERLAY_MAX_EVENTS 50000
+#define PROFILER_OVERLAY_UPDATE_RATE_HZ 4
+#define PROFILER_OVERLAY_WIDTH 600
+#define PROFILER_OVERLAY_LINE_HEIGHT 16
+#define PROFILER_OVERLAY_MARGIN 8
+
+ProfilerOverlay::ProfilerOverlay()
+{
+    this->setMouseCursor(MouseCursor::PointingHandCursor);
+    this->setInterceptsMouseClicks(true, false);
+    this->setAlwaysOnTop(true);
+
+    // skip whatever was recorded before the overlay was shown
+    Array<Profiler::Event> staleEvents;
+    Profiler::collectEvents(staleEvents);
+    Profiler::setEnabled(true);
+
+    this->updateStatistics();
+    this->startTimerHz(PROFILER_OVERLAY_UPDATE_RATE_HZ);
+}
+
+ProfilerOverlay::~ProfilerOverlay()
+{
+    this->stopTimer();
+    Profiler::setEnabled(false);
+}
+
+void ProfilerOverlay::paint(Graphics &g)
+{
+    g.fillAll(Colours::black.withAlpha(0.75f));
+
+    g.setColour(Colours::white);
+    g.setFont(Font(Font::getDefaultMonospacedFontName(), 12.f, Font::plain));
+
+    int y = PROFILER_OVERLAY_MARGIN;
+    for (const auto &line : this->lines)
+    {
+        g.drawSingleLineText(line, PROFILER_OVERLAY_MARGIN, y + PROFILER_OVERLAY_LINE_HEIGHT - 4);
+        y += PROFILER_OVERLAY_LINE_HEIGHT;
+    }
+}
+
+void ProfilerOverlay::mouseUp(const MouseEvent &e)
+{
+    const String fileName = "Trace " + Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S") + ".json";
+    const File traceFile(DocumentHelpers::getTempSlot(fileName));
+
+    if (traceFile.replaceWithText(Profiler::exportChromeTrace(this->recentEvents)))
+    {
+        this->lastSavedTrace = traceFile.getFullPathName();
+        Logger::writeToLog("Saved profiler trace to " + this->lastSavedTrace);
+    }
+
+    this->updateStatistics();
+}
+
+void ProfilerOverlay::timerCallback()
+{
+    const int numOldEvents = this->recentEvents.size();
+    Profiler::collectEvents(this->recentEvents);
+
+    // events come grouped by thread, so the new ones are sorted by time,
+    // and merged with the older ones, which are sorted already,
+    // so that trimming always drops the oldest events of all threads
+    const auto byStartTime = [](const Profiler::Event &a, const Profiler::Event &b)
+    {
+        return a.startMs < b.startMs;
+    };
+
+    auto *begin = this->recentEvents.begin();
+    auto *end = this->recentEvents.end();
+    std::sort(begin + numOldEvents, end, byStartTime);
+    std::inplace_merge(begin, begin + numOldEvents, end, byStartTime);
+
+    Profiler::Event windowStart;
+    windowStart.startMs = Time::getMillisecondCounterHiRes() - PROFILER_OVERLAY_WINDOW_MS;
+    const int numOutdatedEvents = int(std::lower_bound(begin, end, windowStart, byStartTime) - begin);
+    const int numExtraEvents = this->recentEvents.size() - PROFILER_OVERLAY_MAX_EVENTS;
+
+    this->recentEvents.removeRange(0, jmax(numOutdatedEvents, numExtraEvents));
+    this->updateStatistics();
+}
+
+static double getPercentile(const Array<double> &sortedValues, double percentile)
+{
+    const int index = int(percentile * sortedValues.size());
+    return sortedValues[jlimit(0, sortedValues.size() - 1, index)];
+}
+
+void ProfilerOverlay::updateStatistics()
+{
+    StringArray keys;
+    OwnedArray<Array<double>> durations;
+
+    for (const auto &event : this->recentEvents)
+    {
+        const String key = (event.label[0] != 0) ?
+            String(CharPointer_UTF8(event.name)) + " [" + String(CharPointer_UTF8(event.label)) + "]" :
+            String(CharPointer_UTF8(event.name));
+
+        int keyIndex = keys.indexOf(key);
+        if (keyIndex < 0)
+        {
+            keyIndex = keys.size();
+            keys.add(key);
+            durations.add(new Array<double>());
+        }
+
+        durations.getUnchecked(keyIndex)->add(event.durationMs);
+    }
+
+    this->lines.clearQuick();
+
+    if (auto *scheduler = MainWindow::getFrameScheduler())
+    {
+        const auto frames = scheduler->getStatistics();
+        this->lines.add("Frames: " + String(frames.numFrames) +
+            ", dropped " + String(frames.numDroppedFrames) +
+            ", frame time avg " + String(frames.averageFrameTimeMs, 2) +
+            " ms, max " + String(frames.maxFrameTimeMs, 2) + " ms");
+    }
+
+    this->lines.add(String("Last " + String(int(PROFILER_OVERLAY_WINDOW_MS / 1000.0)) + " s, ms").paddedRight(' ', 40) +
+        String("count").paddedLeft(' ', 6) +
+        String("p50").paddedLeft(' ', 7) +
+        String("p95").paddedLeft(' ', 7) +
+        String("p99").paddedLeft(' ', 7) +
+        String("max").paddedLeft(' ', 7));
+
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        auto &values = *durations.getUnchecked(i);
+        values.sort();
+
+        this->lines.add(keys[i].substring(0, 40).paddedRight(' ', 40) +
+            String(values.size()).paddedLeft(' ', 6) +
+            String(getPercentile(values, 0.5), 2).paddedLeft(' ', 7) +
+            String(getPercentile(values, 0.95), 2).paddedLeft(' ', 7) +
+            String(getPercentile(values, 0.99), 2).paddedLeft(' ', 7) +
+            String(values.getLast(), 2).paddedLeft(' ', 7));
+    }
+
+    this->lines.add(this->lastSavedTrace.isEmpty() ?
+        String("Click to save a Chrome trace") :
+        "Saved to " + this->lastSavedTrace);
+
+    this->setSize(PROFILER_OVERLAY_WIDTH,
+        this->lines.size() * PROFILER_OVERLAY_LINE_HEIGHT + PROFILER_OVERLAY_MARGIN * 2);
+
+    this->repaint();
+}
@@ -32,6 +32,7 @@
 #include "FailTooltip.h"
 #include "MenuItemComponent.h"
 #include "CommandIDs.h"
+#include "RenderStatistics.h"
 //[/MiscUserDefs]
 
 RenderDialog::RenderDialog(ProjectTreeItem &parentProject, const File &renderTo, const String &formatExtension)
@@ -329,8 +330,11 @@ void RenderDialog::timerCallback()
 
     if (transport.isRendering())
     {
-        const float percentsDone = transport.getRenderingPercentsComplete();
-        this->slider->setValue(percentsDone, dontSendNotification);
+        // statistics are published through atomics,
+        // so polling them never blocks the renderer
+        const RenderStatistics &statistics = transport.getRenderStatistics();
+        this->slider->setValue(statistics.getProgress(), dontSendNotification);
+        this->filenameLabel->setText(statistics.getDescription(), dontSendNotification);
     }
     else
     {
@@ -355,6 +359,7 @@ void RenderDialog::stopTrackingProgress()
     Transport &transport = this->project.getTransport();
     const float percentsDone = transport.getRenderingPercentsComplete();
     this->slider->setValue(percentsDone, dontSendNotification);
+    this->filenameLabel->setText(TRANS("dialog::render::caption"), dontSendNotification);
 
     this->animator.fadeOut(this->indicator, 250);
     this->indicator->stopAnimating();
@@ -0,0 +1,227 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "FrameScheduler.h"
+#include "MainWindow.h"
+#include "Profiler.h"
+
+#define FRAME_SCHEDULER_INTERVAL_MS (1000 / FRAME_SCHEDULER_FPS)
+
+// A frame is considered dropped, when at least one whole timer tick was missed;
+// anything less is just the timer jitter, which is about a millisecond or more
+#define FRAME_SCHEDULER_DROPPED_FRAME_INTERVAL_MS (FRAME_SCHEDULER_INTERVAL_MS * 2.0)
+
+// Enough for all clients, so that requests from other threads don't allocate
+#define FRAME_SCHEDULER_RESERVED_CLIENTS 64
+
+FrameScheduler::FrameScheduler(Component &targetWindow) :
+    window(targetWindow),
+    lastFrameTime(0.0)
+{
+    this->offThreadClients.ensureStorageAllocated(FRAME_SCHEDULER_RESERVED_CLIENTS);
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    this->cancelPendingUpdate();
+    this->stopTimer();
+}
+
+//===----------------------------------------------------------------------===//
+// Requests
+//===----------------------------------------------------------------------===//
+
+void FrameScheduler::requestFrame(Client *client)
+{
+    // weak references are not thread-safe to create, and timers
+    // can only be started on the message thread, so other threads
+    // only flag the client and let the message thread do the rest
+    if (!MessageManager::getInstance()->isThisTheMessageThread())
+    {
+        if (client->hasOffThreadRequest.compareAndSetBool(1, 0))
+        {
+            SpinLock::ScopedLockType lock(this->clientsLock);
+            this->offThreadClients.add(client);
+        }
+
+        this->triggerAsyncUpdate();
+        return;
+    }
+
+    {
+        SpinLock::ScopedLockType lock(this->clientsLock);
+        this->pendingClients.addIfNotAlreadyThere(client);
+    }
+
+    this->handleAsyncUpdate();
+}
+
+void FrameScheduler::cancelFrame(Client *client)
+{
+    SpinLock::ScopedLockType lock(this->clientsLock);
+    this->pendingClients.removeAllInstancesOf(client);
+    this->offThreadClients.removeAllInstancesOf(client);
+    client->hasOffThreadRequest = 0;
+}
+
+void FrameScheduler::handleAsyncUpdate()
+{
+    {
+        SpinLock::ScopedLockType lock(this->clientsLock);
+        for (auto *client : this->offThreadClients)
+        {
+            client->hasOffThreadRequest = 0;
+            this->pendingClients.addIfNotAlreadyThere(client);
+        }
+
+        this->offThreadClients.clearQuick();
+    }
+
+    if (!this->isTimerRunning())
+    {
+        this->lastFrameTime = Time::getMillisecondCounterHiRes();
+        this->burstStats = {};
+        this->startTimer(FRAME_SCHEDULER_INTERVAL_MS);
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Frames
+//===----------------------------------------------------------------------===//
+
+void FrameScheduler::timerCallback()
+{
+    PROFILE_SCOPE("FrameScheduler::frame");
+
+    const double frameStartTime = Time::getMillisecondCounterHiRes();
+    const double intervalMs = frameStartTime - this->lastFrameTime;
+    this->lastFrameTime = frameStartTime;
+
+    {
+        SpinLock::ScopedLockType lock(this->clientsLock);
+        this->currentClients.swapWith(this->pendingClients);
+    }
+
+    // clients may request more frames right from their callbacks,
+    // which are added to the new pending list
+    for (auto &client : this->currentClients)
+    {
+        if (client != nullptr && client->onFrame(intervalMs))
+        {
+            this->requestFrame(client);
+        }
+    }
+
+    this->currentClients.clearQuick();
+
+    // flush all the repaints scheduled by the clients now,
+    // instead of having them painted at some other moment
+    if (auto *peer = this->window.getPeer())
+    {
+        peer->performAnyPendingRepaintsNow();
+    }
+
+    const double frameTimeMs = Time::getMillisecondCounterHiRes() - frameStartTime;
+    this->updateStatistics(this->totalStats, frameTimeMs, intervalMs);
+    this->updateStatistics(this->burstStats, frameTimeMs, intervalMs);
+
+    bool hasPendingClients = false;
+
+    {
+        SpinLock::ScopedLockType lock(this->clientsLock);
+        hasPendingClients = this->pendingClients.size() > 0;
+    }
+
+    if (!hasPendingClients)
+    {
+        this->stopTimer();
+
+        if (this->burstStats.numDroppedFrames > 0)
+        {
+            Logger::writeToLog("Dropped frames: " + this->burstStats.toString());
+        }
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Statistics
+//===----------------------------------------------------------------------===//
+
+FrameScheduler::Statistics FrameScheduler::getStatistics() const noexcept
+{
+    return this->totalStats;
+}
+
+void FrameScheduler::resetStatistics() noexcept
+{
+    this->totalStats = {};
+}
+
+void FrameScheduler::updateStatistics(Statistics &stats,
+    double frameTimeMs, double intervalMs) noexcept
+{
+    const double n = double(stats.numFrames);
+
+    stats.averageFrameTimeMs = (stats.averageFrameTimeMs * n + frameTimeMs) / (n + 1.0);
+    stats.maxFrameTimeMs = jmax(stats.maxFrameTimeMs, frameTimeMs);
+
+    stats.averageIntervalMs = (stats.averageIntervalMs * n + intervalMs) / (n + 1.0);
+    stats.maxIntervalMs = jmax(stats.maxIntervalMs, intervalMs);
+
+    if (intervalMs > FRAME_SCHEDULER_DROPPED_FRAME_INTERVAL_MS)
+    {
+        stats.numDroppedFrames++;
+    }
+
+    stats.numFrames++;
+}
+
+String FrameScheduler::Statistics::toString() const
+{
+    return String(this->numFrames) + " frames, " +
+        String(this->numDroppedFrames) + " dropped, frame time avg " +
+        String(this->averageFrameTimeMs, 2) + " ms, max " +
+        String(this->maxFrameTimeMs, 2) + " ms, interval avg " +
+        String(this->averageIntervalMs, 2) + " ms, max " +
+        String(this->maxIntervalMs, 2) + " ms";
+}
+
+//===----------------------------------------------------------------------===//
+// Client
+//===----------------------------------------------------------------------===//
+
+FrameScheduler::Client::~Client()
+{
+    this->cancelFrame();
+}
+
+void FrameScheduler::Client::requestFrame()
+{
+    if (auto *scheduler = MainWindow::getFrameScheduler())
+    {
+        scheduler->requestFrame(this);
+    }
+}
+
+void FrameScheduler::Client::cancelFrame()
+{
+    if (auto *scheduler = MainWindow::getFrameScheduler())
+    {
+        scheduler->cancelFrame(this);
+    }
+}
@@ -0,0 +1,102 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#define FRAME_SCHEDULER_FPS 60
+
+// A single source of animation frames for the window: instead of each
+// controller running its own timer or thread and triggering relayouts
+// and repaints at arbitrary moments, all clients request a frame,
+// and all requests are coalesced into one layout-and-paint pass per frame.
+
+class FrameScheduler final : private Timer, private AsyncUpdater
+{
+public:
+
+    class Client
+    {
+    public:
+
+        virtual ~Client();
+
+        // Called on the message thread at most once per frame;
+        // returns true, if the client wants to be called on the next frame too
+        virtual bool onFrame(double frameIntervalMs) = 0;
+
+    protected:
+
+        // Can be called from any thread
+        void requestFrame();
+        void cancelFrame();
+
+    private:
+
+        // Set by the requests from other threads, which can't create weak references,
+        // and picked up by the scheduler on the message thread
+        Atomic<int> hasOffThreadRequest;
+
+        friend class FrameScheduler;
+        JUCE_DECLARE_WEAK_REFERENCEABLE(Client)
+    };
+
+    explicit FrameScheduler(Component &targetWindow);
+    ~FrameScheduler() override;
+
+    void requestFrame(Client *client);
+    void cancelFrame(Client *client);
+
+    struct Statistics final
+    {
+        int numFrames = 0;
+        int numDroppedFrames = 0;
+        double averageFrameTimeMs = 0.0;
+        double maxFrameTimeMs = 0.0;
+        double averageIntervalMs = 0.0;
+        double maxIntervalMs = 0.0;
+
+        String toString() const;
+    };
+
+    Statistics getStatistics() const noexcept;
+    void resetStatistics() noexcept;
+
+private:
+
+    void timerCallback() override;
+    void handleAsyncUpdate() override;
+
+    static void updateStatistics(Statistics &stats, double frameTimeMs, double intervalMs) noexcept;
+
+    Component &window;
+
+    SpinLock clientsLock;
+    Array<WeakReference<Client>> pendingClients;
+    Array<WeakReference<Client>> currentClients;
+
+    // Requests from other threads, turned into pending clients in handleAsyncUpdate;
+    // the clients remove themselves from here when deleted, so raw pointers are fine
+    Array<Client *> offThreadClients;
+
+    double lastFrameTime;
+
+    // the whole session and the current animation burst
+    Statistics totalStats;
+    Statistics burstStats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameScheduler)
+};
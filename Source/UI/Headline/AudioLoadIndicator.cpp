@@ -0,0 +1,126 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Common.h"
+#include "AudioLoadIndicator.h"
+#include "App.h"
+#include "Workspace.h"
+#include "AudioCore.h"
+#include "AudioMonitor.h"
+#include "MixingEngine.h"
+#include "MainLayout.h"
+
+#define AUDIO_LOAD_INDICATOR_UPDATE_RATE_HZ 4
+#define AUDIO_LOAD_INDICATOR_HIGH_LOAD 0.7f
+
+static String getLoadString(float load)
+{
+    return String(roundToInt(load * 100.f)) + "%";
+}
+
+AudioLoadIndicator::AudioLoadIndicator()
+{
+    this->setMouseCursor(MouseCursor::PointingHandCursor);
+    this->setPaintingIsUnclipped(true);
+    this->startTimerHz(AUDIO_LOAD_INDICATOR_UPDATE_RATE_HZ);
+}
+
+AudioLoadIndicator::~AudioLoadIndicator()
+{
+    this->stopTimer();
+}
+
+void AudioLoadIndicator::paint(Graphics &g)
+{
+    const auto textColour = this->findColour(Label::textColourId);
+    const auto warningColour = Colours::red.interpolatedWith(textColour, 0.25f);
+    const bool isLoadHigh = this->stats.currentLoad > AUDIO_LOAD_INDICATOR_HIGH_LOAD;
+
+    // the load bar along the bottom
+    const auto bar = this->getLocalBounds().reduced(4, 0).removeFromBottom(6).removeFromTop(2);
+    g.setColour(textColour.withAlpha(0.1f));
+    g.fillRect(bar);
+    g.setColour((isLoadHigh ? warningColour : textColour).withAlpha(0.5f));
+    g.fillRect(bar.withWidth(roundToInt(bar.getWidth() * jmin(1.f, this->stats.currentLoad))));
+
+    String text = "DSP " + getLoadString(this->stats.currentLoad);
+    if (this->stats.numXruns > 0)
+    {
+        text << ", " << this->stats.numXruns << " xruns";
+    }
+
+    g.setFont(Font(14.f));
+    g.setColour((isLoadHigh || this->stats.numXruns > 0) ?
+        warningColour : textColour.withAlpha(0.6f));
+    g.drawText(text, this->getLocalBounds().reduced(4, 0), Justification::centredRight, false);
+}
+
+void AudioLoadIndicator::mouseUp(const MouseEvent &e)
+{
+    if (App::Workspace().isInitialized())
+    {
+        const String details(this->getDetails());
+        Logger::writeToLog(details);
+        App::Layout().showTooltip(details);
+    }
+}
+
+void AudioLoadIndicator::timerCallback()
+{
+    if (!App::Workspace().isInitialized())
+    {
+        return;
+    }
+
+    const auto newStats = App::Workspace().getAudioCore().getMixingEngine()->getLoadMeter().getStatistics();
+
+    if (newStats.numXruns > this->stats.numXruns)
+    {
+        Logger::writeToLog("Audio dropouts detected: " + newStats.toString());
+    }
+
+    const bool needsRepaint =
+        roundToInt(newStats.currentLoad * 100.f) != roundToInt(this->stats.currentLoad * 100.f) ||
+        newStats.numXruns != this->stats.numXruns;
+
+    this->stats = newStats;
+
+    if (needsRepaint)
+    {
+        this->repaint();
+    }
+}
+
+String AudioLoadIndicator::getDetails() const
+{
+    auto &audioCore = App::Workspace().getAudioCore();
+
+    String details;
+    details << "Total: " << audioCore.getMixingEngine()->getLoadMeter().getStatistics().toString();
+    details << newLine << "Monitoring: " << audioCore.getMonitor()->getLoadMeter().getStatistics().toString();
+
+    for (auto *instrument : audioCore.getInstruments())
+    {
+        const auto instrumentStats = instrument->getProcessorPlayer().getLoadMeter().getStatistics();
+        details << newLine << instrument->getName() << ": " <<
+            getLoadString(instrumentStats.currentLoad) << " now, " <<
+            getLoadString(instrumentStats.averageLoad) << " avg, " <<
+            getLoadString(instrumentStats.maxLoad) << " max";
+    }
+
+    return details;
+}
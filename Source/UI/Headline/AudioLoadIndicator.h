@@ -0,0 +1,44 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "LoadMeter.h"
+
+// Shows the DSP load of the audio callback and the number of dropouts
+// in the headline; a click shows the details for every instrument
+
+class AudioLoadIndicator final : public Component, private Timer
+{
+public:
+
+    AudioLoadIndicator();
+    ~AudioLoadIndicator() override;
+
+    void paint(Graphics &g) override;
+    void mouseUp(const MouseEvent &e) override;
+
+private:
+
+    void timerCallback() override;
+
+    String getDetails() const;
+
+    LoadMeter::Statistics stats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioLoadIndicator)
+};
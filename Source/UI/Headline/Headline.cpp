@@ -28,8 +28,10 @@
 #include "HelioTheme.h"
 #include "ColourIDs.h"
 #include "SequencerLayout.h"
+#include "AudioLoadIndicator.h"
 
 #define HEADLINE_ITEMS_OVERLAP (16)
+#define HEADLINE_LOAD_INDICATOR_WIDTH (160)
 #define HEADLINE_ROOT_X SEQUENCER_SIDEBAR_WIDTH
 //[/MiscUserDefs]
 
@@ -47,6 +49,10 @@ Headline::Headline()
     this->setSize(600, 34);
 
     //[Constructor]
+#if HELIO_DESKTOP
+    this->loadIndicator = new AudioLoadIndicator();
+    this->addAndMakeVisible(this->loadIndicator);
+#endif
     //[/Constructor]
 }
 
@@ -54,6 +60,7 @@ Headline::~Headline()
 {
     //[Destructor_pre]
     this->chain.clearQuick(true);
+    this->loadIndicator = nullptr;
     //[/Destructor_pre]
 
     navPanel = nullptr;
@@ -85,6 +92,11 @@ void Headline::resized()
 
     navPanel->setBounds(0, 0, 60, getHeight() - 0);
     //[UserResized] Add your own custom resize handling here..
+    if (this->loadIndicator != nullptr)
+    {
+        this->loadIndicator->setBounds(this->getWidth() - HEADLINE_LOAD_INDICATOR_WIDTH - SEQUENCER_SIDEBAR_WIDTH,
+            0, HEADLINE_LOAD_INDICATOR_WIDTH, this->getHeight() - 2);
+    }
     //[/UserResized]
 }
 
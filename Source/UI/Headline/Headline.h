@@ -23,6 +23,7 @@
 
 class HeadlineItem;
 class HeadlineItemDataSource;
+class AudioLoadIndicator;
 
 #if HELIO_MOBILE
 #   define HEADLINE_HEIGHT (42)
@@ -72,6 +73,9 @@ private:
 
     float getAlphaForAnimation() const noexcept;
 
+    // DSP load and dropouts, at the right side
+    ScopedPointer<AudioLoadIndicator> loadIndicator;
+
     //[/UserVariables]
 
     UniquePointer<HeadlineNavigationPanel> navPanel;
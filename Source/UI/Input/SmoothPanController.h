@@ -18,12 +18,13 @@
 #pragma once
 
 #include "SmoothPanListener.h"
+#include "FrameScheduler.h"
 
 #define SMOOTH_PAN_STOP_FACTOR 5
 #define SMOOTH_PAN_SLOWDOWN_FACTOR 0.95f
 #define SMOOTH_PAN_DISABLED 1
 
-class SmoothPanController final : private Timer
+class SmoothPanController final : private FrameScheduler::Client
 {
 public:
 
@@ -35,7 +36,7 @@ public:
 
     void cancelPan()
     {
-        this->stopTimer();
+        this->cancelFrame();
     }
 
     void panByOffset(Point<int> offset)
@@ -51,14 +52,9 @@ public:
         this->origin = this->listener.getPanOffset().toFloat();
         this->target = offset.toFloat();
 
-        if (!this->isTimerRunning())
+        if (this->process())
         {
-            this->startTimerHz(60);
-            this->process();
-        }
-        else
-        {
-            this->process();
+            this->requestFrame();
         }
 
         #endif
@@ -66,12 +62,12 @@ public:
 
 private:
 
-    void timerCallback() override
+    bool onFrame(double frameIntervalMs) override
     {
-        this->process();
+        return this->process();
     }
 
-    inline void process()
+    inline bool process()
     {
         const Point<float> &diff = this->target - this->origin;
 
@@ -80,10 +76,7 @@ private:
         this->listener.panByOffset(int(this->origin.getX()),
             int(this->origin.getY()));
 
-        if (diff.getDistanceFromOrigin() < SMOOTH_PAN_STOP_FACTOR)
-        {
-            this->stopTimer();
-        }
+        return diff.getDistanceFromOrigin() >= SMOOTH_PAN_STOP_FACTOR;
     }
 
     SmoothPanListener &listener;
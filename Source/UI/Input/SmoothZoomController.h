@@ -18,46 +18,36 @@
 #pragma once
 
 #include "SmoothZoomListener.h"
+#include "FrameScheduler.h"
 
-#define SMOOTH_ZOOM_TIMER_DELAY_MS 8
+// The decay factor is defined per this time step,
+// and is adjusted to the actual frame interval
+#define SMOOTH_ZOOM_STEP_MS 10.0
 #define ZOOM_STOP_FACTOR 0.001f
 #define ZOOM_DECAY_FACTOR 0.77f
 #define ZOOM_INITIAL_SPEED 0.55f
 
-class SmoothZoomController : private Thread, private WaitableEvent, private AsyncUpdater
+class SmoothZoomController final : private FrameScheduler::Client
 {
 public:
 
     explicit SmoothZoomController(SmoothZoomListener &parent) :
-        Thread("SmoothZoomController"),
         listener(parent),
         factorX(0.f),
         factorY(0.f),
         originX(0.f),
         originY(0.f),
-        timerDelay(SMOOTH_ZOOM_TIMER_DELAY_MS),
         zoomStopFactor(ZOOM_STOP_FACTOR),
         zoomDecayFactor(ZOOM_DECAY_FACTOR),
-        initialZoomSpeed(ZOOM_INITIAL_SPEED)
-    {
-        this->startThread(5);
-    }
-
-    ~SmoothZoomController() override
-    {
-        this->signalThreadShouldExit();
-        this->signal();
-        this->stopThread(500);
-    }
+        initialZoomSpeed(ZOOM_INITIAL_SPEED) {}
 
-    inline int getTimerDelay() const noexcept { return timerDelay; }
     inline float getZoomStopFactor() const noexcept { return zoomStopFactor; }
     inline float getZoomDecayFactor() const noexcept { return zoomDecayFactor; }
     inline float getInitialZoomSpeed() const noexcept { return initialZoomSpeed; }
 
     bool isZooming() const
     {
-        return fabs(this->factorX.get()) > 0.f;
+        return fabs(this->factorX) > 0.f;
     }
 
     void cancelZoom()
@@ -77,65 +67,58 @@ public:
         }
         else
         {
-            this->factorX = (this->factorX.get() + zoom.getX()) / 2.f;
-            this->factorY = (this->factorY.get() + zoom.getY()) / 2.f;
-            this->originX = (this->originX.get() + from.getX()) / 2.f;
-            this->originY = (this->originY.get() + from.getY()) / 2.f;
+            this->factorX = (this->factorX + zoom.getX()) / 2.f;
+            this->factorY = (this->factorY + zoom.getY()) / 2.f;
+            this->originX = (this->originX + from.getX()) / 2.f;
+            this->originY = (this->originY + from.getY()) / 2.f;
         }
 
-        WaitableEvent::signal();
+        this->requestFrame();
     }
 
 private:
 
     inline bool stillNeedsZoom() const
     {
-        return juce_hypot(this->factorX.get(), this->factorY.get()) >= this->zoomStopFactor;
+        return juce_hypot(this->factorX, this->factorY) >= this->zoomStopFactor;
     }
 
-    void run() override
+    bool onFrame(double frameIntervalMs) override
     {
-        while (! this->threadShouldExit())
+        if (! this->stillNeedsZoom())
         {
-            while (this->stillNeedsZoom())
-            {
-                const double b = Time::getMillisecondCounterHiRes();
-                this->factorX = this->factorX.get() * this->zoomDecayFactor;
-                this->factorY = this->factorY.get() * this->zoomDecayFactor;
-
-                this->triggerAsyncUpdate();
-                
-                if (this->threadShouldExit())
-                {
-                    return;
-                }
-
-                const double a = Time::getMillisecondCounterHiRes();
-                const int skewTime = int(a - b);
-                Thread::sleep(jlimit(10, 100, this->timerDelay - skewTime));
-            }
-
             this->cancelZoom();
-            WaitableEvent::wait();
+            return false;
         }
-    }
 
-    void handleAsyncUpdate() override
-    {
-        this->listener.zoomRelative({ this->originX.get(), this->originY.get() },
-            { this->factorX.get(), this->factorY.get() });
+        // Frames come less often than the fixed steps used to, each of which
+        // decayed the factor and then applied it, so one frame applies the sum
+        // of those n steps, f * (d + d^2 + ... + d^n) = f * d * (1 - d^n) / (1 - d),
+        // to keep the total zoom amount the same at any frame rate
+        const float d = this->zoomDecayFactor;
+        const float numSteps = float(jlimit(0.1, 10.0, frameIntervalMs / SMOOTH_ZOOM_STEP_MS));
+        const float frameDecay = powf(d, numSteps);
+        const float frameAmount = d * (1.f - frameDecay) / (1.f - d);
+
+        const float zoomX = this->factorX * frameAmount;
+        const float zoomY = this->factorY * frameAmount;
+        this->factorX *= frameDecay;
+        this->factorY *= frameDecay;
+
+        this->listener.zoomRelative({ this->originX, this->originY }, { zoomX, zoomY });
+
+        return true;
     }
 
     SmoothZoomListener &listener;
 
-    Atomic<float> factorX;
-    Atomic<float> factorY;
-    Atomic<float> originX;
-    Atomic<float> originY;
+    float factorX;
+    float factorY;
+    float originX;
+    float originY;
 
 private:
 
-    int timerDelay;
     float zoomStopFactor;
     float zoomDecayFactor;
     float initialZoomSpeed;
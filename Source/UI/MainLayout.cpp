@@ -40,6 +40,7 @@
 #include "JsonSerializer.h"
 #include "ComponentIDs.h"
 #include "CommandIDs.h"
+#include "ProfilerOverlay.h"
 #include "Workspace.h"
 #include "App.h"
 
@@ -213,6 +214,19 @@ void MainLayout::hideModalComponentUnowned()
     ScopedPointer<Component> deleter(Component::getCurrentlyModalComponent());
 }
 
+void MainLayout::toggleProfilerOverlay()
+{
+    if (this->profilerOverlay != nullptr)
+    {
+        this->profilerOverlay = nullptr;
+        return;
+    }
+
+    this->profilerOverlay = new ProfilerOverlay();
+    this->addAndMakeVisible(this->profilerOverlay);
+    this->resized();
+}
+
 // a hack!
 Rectangle<int> MainLayout::getPageBounds() const
 {
@@ -243,6 +257,11 @@ void MainLayout::resized()
     {
         this->initScreen->setBounds(this->getLocalBounds());
     }
+
+    if (this->profilerOverlay)
+    {
+        this->profilerOverlay->setTopRightPosition(r.getRight(), r.getY());
+    }
 }
 
 void MainLayout::lookAndFeelChanged()
@@ -368,6 +387,9 @@ void MainLayout::handleCommandMessage(int commandId)
     case CommandIDs::ToggleShowHideConsole:
         //this->toggleShowHideConsole();
         break;
+    case CommandIDs::ToggleProfilerOverlay:
+        this->toggleProfilerOverlay();
+        break;
     default:
         break;
     }
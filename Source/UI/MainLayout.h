@@ -20,6 +20,7 @@
 class HeadlineItemDataSource;
 class TransientTreeItem;
 class TooltipContainer;
+class ProfilerOverlay;
 class TreeItem;
 class Headline;
 
@@ -85,6 +86,10 @@ private:
     ScopedPointer<Headline> headline;
 
     ScopedPointer<TooltipContainer> tooltipContainer;
+
+    // hot path statistics, toggled by a hotkey
+    ScopedPointer<ProfilerOverlay> profilerOverlay;
+    void toggleProfilerOverlay();
     
     HotkeyScheme::Ptr hotkeyScheme;
     
@@ -18,6 +18,7 @@
 #include "Common.h"
 #include "MainWindow.h"
 #include "MainLayout.h"
+#include "FrameScheduler.h"
 #include "SequencerLayout.h"
 #include "Config.h"
 #include "SerializationKeys.h"
@@ -64,6 +65,9 @@ private:
     int scale;
 };
 
+// Clients may look it up from any thread
+static Atomic<FrameScheduler *> kFrameScheduler(nullptr);
+
 MainWindow::MainWindow() :
     DocumentWindow("Helio", Colours::black, DocumentWindow::allButtons)
 {
@@ -103,6 +107,9 @@ MainWindow::MainWindow() :
         ht->initColours(ColourSchemesManager::getInstance().getCurrentScheme());
     }
 
+    this->frameScheduler = new FrameScheduler(*this);
+    kFrameScheduler = this->frameScheduler.get();
+
     const String openGLState = Config::get(Serialization::Config::openGLState);
 
 #if JUCE_MAC || JUCE_ANDROID
@@ -132,6 +139,9 @@ MainWindow::~MainWindow()
     }
     
     this->dismissLayoutComponent();
+
+    kFrameScheduler = nullptr;
+    this->frameScheduler = nullptr;
 }
 
 #if HELIO_HAS_CUSTOM_TITLEBAR
@@ -254,3 +264,8 @@ bool MainWindow::isOpenGLRendererEnabled() noexcept
 {
     return kOpenGlEnabled.get() != 0;
 }
+
+FrameScheduler *MainWindow::getFrameScheduler() noexcept
+{
+    return kFrameScheduler.get();
+}
@@ -18,6 +18,7 @@
 #pragma once
 
 class MainLayout;
+class FrameScheduler;
 
 #if JUCE_WINDOWS || JUCE_LINUX
 #   define HELIO_HAS_CUSTOM_TITLEBAR 1
@@ -44,6 +45,9 @@ public:
     void setOpenGLRendererEnabled(bool shouldBeEnabled);
     static bool isOpenGLRendererEnabled() noexcept;
 
+    // Returns nullptr when there's no window, e.g. in batch render mode
+    static FrameScheduler *getFrameScheduler() noexcept;
+
     //===------------------------------------------------------------------===//
     // Drag'n'drop
     //===------------------------------------------------------------------===//
@@ -64,6 +68,7 @@ private:
     void createLayoutComponent();
 
     ScopedPointer<MainLayout> layout;
+    ScopedPointer<FrameScheduler> frameScheduler;
 
     friend class App;
 
@@ -38,6 +38,7 @@
 #include "AutomationTrackActions.h"
 #include "UndoStack.h"
 #include "Workspace.h"
+#include "Transport.h"
 #include "App.h"
 
 MidiTrackMenu::MidiTrackMenu(MidiTrackTreeItem &parentLayer) :
@@ -71,6 +72,22 @@ void MidiTrackMenu::handleCommandMessage(int commandId)
         }
             break;
 
+        case CommandIDs::FreezeTrack:
+        {
+            ProjectTreeItem *project = this->trackItem.getProject();
+            project->getTransport().freezeTrack(&this->trackItem);
+            this->dismiss();
+        }
+            break;
+
+        case CommandIDs::UnfreezeTrack:
+        {
+            ProjectTreeItem *project = this->trackItem.getProject();
+            project->getTransport().unfreezeTrack(&this->trackItem);
+            this->dismiss();
+        }
+            break;
+
         case CommandIDs::DeleteTrack:
         {
             ProjectTreeItem *project = this->trackItem.getProject();
@@ -117,6 +134,16 @@ void MidiTrackMenu::initDefaultMenu()
         {
             menu.add(MenuItem::item(Icons::mute, CommandIDs::MuteTrack, TRANS("menu::track::mute")));
         }
+
+        const Transport &transport = this->trackItem.getProject()->getTransport();
+        if (transport.isTrackFrozen(&this->trackItem))
+        {
+            menu.add(MenuItem::item(Icons::render, CommandIDs::UnfreezeTrack, TRANS("menu::track::unfreeze")));
+        }
+        else if (!transport.isFreezing())
+        {
+            menu.add(MenuItem::item(Icons::render, CommandIDs::FreezeTrack, TRANS("menu::track::freeze")));
+        }
     }
     
     menu.add(MenuItem::item(Icons::remove, CommandIDs::DeleteTrack, TRANS("menu::track::delete")));
@@ -23,6 +23,8 @@
 
 #include "ArpeggiatorsManager.h"
 #include "Arpeggiator.h"
+#include "ScriptsManager.h"
+#include "SerializationKeys.h"
 #include "NoteComponent.h"
 
 #include "ProjectTreeItem.h"
@@ -36,6 +38,20 @@
 #include "MainLayout.h"
 #include "ModalDialogInput.h"
 
+static Array<Script::Ptr> getTransformScripts()
+{
+    Array<Script::Ptr> result;
+    for (const auto script : ScriptsManager::getInstance().getScripts())
+    {
+        if (script->getType() == Serialization::Scripts::Types::transformSelection)
+        {
+            result.add(script);
+        }
+    }
+
+    return result;
+}
+
 MenuPanel::Menu PianoRollSelectionMenu::createDefaultPanel()
 {
     MenuPanel::Menu menu;
@@ -63,6 +79,16 @@ MenuPanel::Menu PianoRollSelectionMenu::createDefaultPanel()
         this->updateContent(this->createArpsPanel(), MenuPanel::SlideLeft);
     }));
 
+    if (!getTransformScripts().isEmpty())
+    {
+        menu.add(MenuItem::item(Icons::script,
+            TRANS("menu::selection::notes::script"))->
+            withSubmenu()->withAction([this]()
+        {
+            this->updateContent(this->createScriptsPanel(), MenuPanel::SlideLeft);
+        }));
+    }
+
     // TODO
     //menu.add(MenuItem::item(Icons::arpeggiate,
     //    TRANS("menu::selection::notes::divisions"))->
@@ -170,6 +196,36 @@ MenuPanel::Menu PianoRollSelectionMenu::createArpsPanel()
     return cmds;
 }
 
+MenuPanel::Menu PianoRollSelectionMenu::createScriptsPanel()
+{
+    MenuPanel::Menu menu;
+
+    menu.add(MenuItem::item(Icons::back, TRANS("menu::back"))->withTimer()->withAction([this]()
+    {
+        this->updateContent(this->createDefaultPanel(), MenuPanel::SlideRight);
+    }));
+
+    for (const auto script : getTransformScripts())
+    {
+        menu.add(MenuItem::item(Icons::script, script->getName())->withAction([this, script]()
+        {
+            const Clip &clip = this->lasso->getFirstAs<NoteComponent>()->getClip();
+            const auto timeline = this->project.getTimeline();
+            const auto result = SequencerOperations::applyTransformScript(*this->lasso, clip,
+                timeline->getTimeSignatures(), timeline->getKeySignatures(), *script);
+
+            if (result.failed())
+            {
+                App::Layout().showTooltip(result.getErrorMessage());
+            }
+
+            this->dismiss();
+        }));
+    }
+
+    return menu;
+}
+
 PianoRollSelectionMenu::PianoRollSelectionMenu(WeakReference<Lasso> lasso, const ProjectTreeItem &project) :
     lasso(lasso),
     project(project)
@@ -38,5 +38,6 @@ private:
     MenuPanel::Menu createRefactoringPanel();
     MenuPanel::Menu createTimeDivisionsPanel();
     MenuPanel::Menu createArpsPanel();
+    MenuPanel::Menu createScriptsPanel();
 
 };
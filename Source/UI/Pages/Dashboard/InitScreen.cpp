@@ -31,6 +31,7 @@
 #include "CommandIDs.h"
 #include "ColourIDs.h"
 #include "App.h"
+#include "StartupGraph.h"
 //[/MiscUserDefs]
 
 InitScreen::InitScreen()
@@ -106,6 +107,14 @@ void InitScreen::paint (Graphics& g)
 
     //[UserPaint] Add your own custom painting code here..
     HelioTheme::drawNoiseWithin(this->getLocalBounds().toFloat(), this, g, 1.f);
+
+    static bool isFirstFrame = true;
+    if (isFirstFrame)
+    {
+        isFirstFrame = false;
+        Logger::writeToLog("Startup: first frame at " +
+            String(StartupGraph::getMillisecondsSinceStartup(), 1) + " ms");
+    }
     //[/UserPaint]
 }
 
@@ -143,8 +152,10 @@ void InitScreen::handleCommandMessage (int commandId)
             ht->updateBackgroundRenders();
         }
 
+        const double startTime = StartupGraph::getMillisecondsSinceStartup();
         App::Workspace().init();
         App::Layout().show();
+        StartupGraph::logStage("Workspace shown", startTime);
     }
     //[/UserCode_handleCommandMessage]
 }
@@ -26,6 +26,7 @@
 #include "OrchestraPitPage.h"
 #include "InstrumentMenu.h"
 #include "Instrument.h"
+#include "LevelMeter.h"
 #include "MainLayout.h"
 #include "Icons.h"
 #include "App.h"
@@ -99,6 +100,11 @@ void InstrumentsListComponent::parentHierarchyChanged()
     if (this->getParentComponent() != nullptr)
     {
         this->updateListContent();
+        this->startTimerHz(30);
+    }
+    else
+    {
+        this->stopTimer();
     }
     //[/UserCode_parentHierarchyChanged]
 }
@@ -115,10 +121,35 @@ void InstrumentsListComponent::updateListContent()
 {
     this->instrumentIcon = Icons::findByName(Icons::instrument, int(INSTRUMENTSLIST_ROW_HEIGHT * 0.75f));
     this->instruments = this->instrumentsRoot.findChildrenRefsOfType<InstrumentTreeItem>();
+    this->sleepingStates.clearQuick();
+    this->sleepingStates.insertMultiple(0, false, this->instruments.size());
+    this->levels.clearQuick();
+    this->levels.insertMultiple(0, {}, this->instruments.size());
     this->instrumentsList->updateContent();
     this->clearSelection();
 }
 
+void InstrumentsListComponent::timerCallback()
+{
+    for (int i = 0; i < this->instruments.size(); ++i)
+    {
+        const auto instrumentNode = this->instruments[i];
+        const auto instrument = (instrumentNode != nullptr) ? instrumentNode->getInstrument() : nullptr;
+        const bool isSleeping = (instrument != nullptr) && instrument->getProcessorPlayer().isSleeping();
+        const auto newLevels = (instrument != nullptr) ?
+            LevelMeterComponent::Levels::fromMeter(instrument->getProcessorPlayer().getLevelMeter()) :
+            LevelMeterComponent::Levels();
+
+        if (this->sleepingStates[i] != isSleeping ||
+            newLevels.differsFrom(this->levels.getReference(i)))
+        {
+            this->sleepingStates.set(i, isSleeping);
+            this->levels.set(i, newLevels);
+            this->instrumentsList->repaintRow(i);
+        }
+    }
+}
+
 //===----------------------------------------------------------------------===//
 // ListBoxModel
 //===----------------------------------------------------------------------===//
@@ -148,10 +179,24 @@ void InstrumentsListComponent::paintListBoxItem(int rowNumber, Graphics &g, int
     g.setFont(h * 0.4f);
     const int margin = h / 12;
 
-    g.setColour(Colours::white);
-    g.drawText(instrumentNode->getName(), (margin * 2) + this->instrumentIcon.getWidth(), margin,
+    const bool isSleeping = this->sleepingStates[rowNumber];
+    const int textX = (margin * 2) + this->instrumentIcon.getWidth();
+
+    g.setColour(Colours::white.withAlpha(isSleeping ? 0.5f : 1.f));
+    g.drawText(instrumentNode->getName(), textX, margin,
         w, h - (margin * 2), Justification::centredLeft, false);
 
+    if (isSleeping)
+    {
+        g.setFont(h * 0.3f);
+        g.setColour(Colours::white.withAlpha(0.35f));
+        g.drawText(TRANS("page::orchestra::sleeping"), textX, margin,
+            w - textX - (margin * 2), h - (margin * 2), Justification::centredRight, false);
+    }
+
+    const Rectangle<float> meterBounds(float(textX), float(h - margin - 4), float(w / 3), 4.f);
+    LevelMeterComponent::paintLevels(g, meterBounds, this->levels[rowNumber]);
+
     const auto placement = RectanglePlacement::yMid | RectanglePlacement::xLeft | RectanglePlacement::doNotResize;
     g.drawImageWithin(this->instrumentIcon, margin, 0, w, h, placement);
 }
@@ -233,7 +278,7 @@ String InstrumentsListComponent::getName() const
 BEGIN_JUCER_METADATA
 
 <JUCER_COMPONENT documentType="Component" className="InstrumentsListComponent"
-                 template="../../../Template" componentName="" parentClasses="public Component, public ListBoxModel, public HeadlineItemDataSource"
+                 template="../../../Template" componentName="" parentClasses="public Component, public ListBoxModel, public HeadlineItemDataSource, private Timer"
                  constructorParams="PluginScanner &amp;pluginScanner, OrchestraPitTreeItem &amp;instrumentsRoot"
                  variableInitialisers="pluginScanner(pluginScanner),&#10;instrumentsRoot(instrumentsRoot)"
                  snapPixels="8" snapActive="1" snapShown="1" overlayOpacity="0.330"
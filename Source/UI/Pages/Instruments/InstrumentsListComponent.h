@@ -23,6 +23,7 @@ class OrchestraPitTreeItem;
 
 #include "HeadlineItemDataSource.h"
 #include "InstrumentTreeItem.h"
+#include "LevelMeterComponent.h"
 
 #if HELIO_DESKTOP
 #   define INSTRUMENTSLIST_ROW_HEIGHT (48)
@@ -35,7 +36,8 @@ class OrchestraPitTreeItem;
 
 class InstrumentsListComponent final : public Component,
                                        public ListBoxModel,
-                                       public HeadlineItemDataSource
+                                       public HeadlineItemDataSource,
+                                       private Timer
 {
 public:
 
@@ -81,6 +83,11 @@ private:
 
     Array<WeakReference<InstrumentTreeItem>> instruments;
     Image instrumentIcon;
+
+    // polls instruments' sleeping states and levels, which are changed by the audio thread
+    void timerCallback() override;
+    Array<bool> sleepingStates;
+    Array<LevelMeterComponent::Levels> levels;
     //[/UserVariables]
 
     UniquePointer<ListBox> instrumentsList;
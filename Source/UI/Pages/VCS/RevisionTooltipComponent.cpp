@@ -25,6 +25,9 @@
 #include "RevisionItemComponent.h"
 #include "RevisionItem.h"
 #include "Delta.h"
+#include "App.h"
+#include "MainLayout.h"
+#include "ProgressTooltip.h"
 
 #if HELIO_DESKTOP
 #    define REVISION_TOOLTIP_ROWS_ONSCREEN (4.5)
@@ -127,8 +130,35 @@ void RevisionTooltipComponent::buttonClicked (Button* buttonThatWasClicked)
     if (buttonThatWasClicked == checkoutRevisionButton)
     {
         //[UserButtonCode_checkoutRevisionButton] -- add your button handler code here..
-        this->vcs.checkout(this->revision);
+        // this component is gone after hide(), so keep the references
+        WeakReference<VersionControl> versionControl(&this->vcs);
+        const ValueTree targetRevision(this->revision);
         this->hide();
+
+        ScopedPointer<ProgressTooltip> tooltip(new ProgressTooltip(true));
+        tooltip->onCancel = [versionControl]()
+        {
+            if (versionControl != nullptr)
+            {
+                versionControl->cancelCheckout();
+            }
+        };
+
+        tooltip->setProgressSource([versionControl]()
+        {
+            return (versionControl != nullptr) ?
+                versionControl->getHead().getCheckoutProgress() : 1.f;
+        });
+
+        App::Layout().showModalComponentUnowned(tooltip.release());
+        versionControl->checkout(targetRevision, [](bool succeeded)
+        {
+            // a cancelled tooltip dismisses itself
+            if (succeeded)
+            {
+                App::Layout().hideModalComponentUnowned();
+            }
+        });
         //[/UserButtonCode_checkoutRevisionButton]
     }
 
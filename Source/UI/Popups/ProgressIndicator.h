@@ -26,7 +26,7 @@ class ProgressIndicator : public Component,
                           private Timer
 {
 public:
-    ProgressIndicator() : indicatorDegree(0)
+    ProgressIndicator() : indicatorDegree(0), progress(-1.f)
     {
         this->setInterceptsMouseClicks(false, false);
         this->indicatorShape = Icons::getDrawableByName(Icons::progressIndicator);
@@ -46,6 +46,12 @@ public:
     {
         this->stopTimer();
     }
+
+    // Optional, when set, the known progress [0..1] is shown as a ring
+    void setProgressSource(Function<float()> source)
+    {
+        this->progressSource = source;
+    }
     
     void paint (Graphics& g) override
     {
@@ -92,6 +98,18 @@ public:
                 }
             }
         }
+
+        if (this->progress >= 0.f)
+        {
+            const auto area = this->getLocalBounds().toFloat().reduced(2.f);
+            Path ring;
+            ring.addCentredArc(area.getCentreX(), area.getCentreY(),
+                area.getWidth() / 2.f, area.getHeight() / 2.f, 0.f,
+                0.f, MathConstants<float>::twoPi * jlimit(0.f, 1.f, this->progress), true);
+
+            g.setColour(Colours::white.withAlpha(0.5f));
+            g.strokePath(ring, PathStrokeType(2.f));
+        }
     }
 
 private:
@@ -99,11 +117,20 @@ private:
     void timerCallback() override
     {
         this->indicatorDegree = (this->indicatorDegree + 7) % 360;
+
+        if (this->progressSource != nullptr)
+        {
+            this->progress = this->progressSource();
+        }
+
         this->repaint();
     }
 
     int indicatorDegree;
 
+    float progress;
+    Function<float()> progressSource;
+
     ScopedPointer<Drawable> indicatorShape;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProgressIndicator)
@@ -126,6 +126,11 @@ void ProgressTooltip::inputAttemptWhenModal()
 
 
 //[MiscUserCode]
+void ProgressTooltip::setProgressSource(Function<float()> source)
+{
+    this->progressIndicator->setProgressSource(source);
+}
+
 void ProgressTooltip::cancel()
 {
     if (!this->isCancellable)
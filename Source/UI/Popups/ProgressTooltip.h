@@ -34,6 +34,7 @@ public:
 
     //[UserMethods]
     SimpleCloseCallback onCancel;
+    void setProgressSource(Function<float()> source);
     //[/UserMethods]
 
     void paint (Graphics& g) override;
@@ -241,7 +241,7 @@ void HybridRollHeader::mouseDown(const MouseEvent &e)
         else
         {
             this->transport.stopPlayback();
-            this->roll.cancelPendingUpdate(); // why is it here?
+            this->roll.cancelFrame(); // why is it here?
             this->transport.seekToPosition(transportPosition);
         }
     }
@@ -326,7 +326,7 @@ void HybridRollHeader::mouseDrag(const MouseEvent &e)
 #endif
                 
                 this->transport.stopPlayback();
-                this->roll.cancelPendingUpdate();
+                this->roll.cancelFrame();
                 this->transport.seekToPosition(transportPosition);
             }
         }
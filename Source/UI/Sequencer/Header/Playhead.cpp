@@ -24,9 +24,6 @@
 
 #define FREE_SPACE 2
 
-//#define PLAYHEAD_UPDATE_TIME_MS (1000 / 50)
-#define PLAYHEAD_UPDATE_TIME_MS 7
-
 Playhead::Playhead(HybridRoll &parentRoll,
     Transport &owner,
     Playhead::Listener *movementListener /*= nullptr*/,
@@ -38,6 +35,7 @@ Playhead::Playhead(HybridRoll &parentRoll,
     timerStartTime(0.0),
     msPerQuarterNote(1.0),
     timerStartPosition(0.0),
+    isPlaying(0),
     listener(movementListener)
 {
     this->mainColour = this->findColour(ColourIDs::Roll::playhead);
@@ -76,14 +74,13 @@ void Playhead::onSeek(double absolutePosition,
         this->lastCorrectPosition = absolutePosition;
     }
 
-    this->triggerAsyncUpdate();
+    this->requestFrame();
 
-    if (this->isTimerRunning())
+    if (this->isPlaying.get())
     {
         SpinLock::ScopedLockType lock(this->anchorsLock);
         this->timerStartTime = Time::getMillisecondCounterHiRes();
         this->timerStartPosition = this->lastCorrectPosition;
-        //this->startTimer(PLAYHEAD_UPDATE_TIME_MS);
     }
 }
 
@@ -93,7 +90,7 @@ void Playhead::onTempoChanged(double msPerQuarter)
     SpinLock::ScopedLockType lock(this->anchorsLock);
     this->msPerQuarterNote = jmax(msPerQuarter, 0.01);
         
-    if (this->isTimerRunning())
+    if (this->isPlaying.get())
     {
         this->timerStartTime = Time::getMillisecondCounterHiRes();
         this->timerStartPosition = this->lastCorrectPosition;
@@ -112,13 +109,13 @@ void Playhead::onPlay()
         this->timerStartPosition = this->lastCorrectPosition;
     }
 
-    //Logger::writeToLog("   !!!!! Playhead startTimer");
-    this->startTimer(PLAYHEAD_UPDATE_TIME_MS);
+    this->isPlaying = 1;
+    this->requestFrame();
 }
 
 void Playhead::onStop()
 {
-    this->stopTimer();
+    this->isPlaying = 0;
 
     {
         SpinLock::ScopedLockType lock(this->anchorsLock);
@@ -129,38 +126,27 @@ void Playhead::onStop()
 
 
 //===----------------------------------------------------------------------===//
-// Timer
+// FrameScheduler::Client
 //===----------------------------------------------------------------------===//
 
-void Playhead::timerCallback()
+bool Playhead::onFrame(double frameIntervalMs)
 {
-    this->triggerAsyncUpdate();
-}
-
-
-//===----------------------------------------------------------------------===//
-// AsyncUpdater
-//===----------------------------------------------------------------------===//
-
-void Playhead::handleAsyncUpdate()
-{
-    //Logger::writeToLog("Playhead::handleAsyncUpdate");
-
-    if (this->isTimerRunning())
+    // while playing, the position is estimated on each frame
+    if (this->isPlaying.get())
     {
         this->tick();
+        return true;
     }
-    else
+
+    double position;
+
     {
-        double position;
-        
-        {
-            SpinLock::ScopedLockType lock(this->lastCorrectPositionLock);
-            position = this->lastCorrectPosition;
-        }
-        
-        this->updatePosition(position);
+        SpinLock::ScopedLockType lock(this->lastCorrectPositionLock);
+        position = this->lastCorrectPosition;
     }
+
+    this->updatePosition(position);
+    return false;
 }
 
 
@@ -193,7 +179,7 @@ void Playhead::parentChanged()
     {
         this->setSize(this->playheadWidth, this->getParentHeight());
         
-        if (this->isTimerRunning())
+        if (this->isPlaying.get())
         {
             this->tick();
         }
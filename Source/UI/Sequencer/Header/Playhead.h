@@ -22,12 +22,12 @@ class HybridRoll;
 class MovementListener;
 
 #include "TransportListener.h"
+#include "FrameScheduler.h"
 
 class Playhead :
     public Component,
     public TransportListener,
-    private AsyncUpdater,
-    private Timer
+    private FrameScheduler::Client
 {
 public:
 
@@ -73,11 +73,6 @@ protected:
 
 private:
 
-    //===------------------------------------------------------------------===//
-    // Timer
-    //===------------------------------------------------------------------===//
-
-    void timerCallback() override;
     void tick();
 
     void parentChanged();
@@ -87,13 +82,16 @@ private:
     double timerStartPosition;
     double msPerQuarterNote;
 
+    // modified from a player thread
+    Atomic<int> isPlaying;
+
 private:
 
     //===------------------------------------------------------------------===//
-    // AsyncUpdater
+    // FrameScheduler::Client
     //===------------------------------------------------------------------===//
 
-    void handleAsyncUpdate() override;
+    bool onFrame(double frameIntervalMs) override;
 
     void updatePosition(double position);
 
@@ -31,10 +31,14 @@
 #include "AutomationSequence.h"
 #include "AnnotationsSequence.h"
 #include "KeySignaturesSequence.h"
+#include "KeySignatureEvent.h"
+#include "TimeSignatureEvent.h"
 #include "MidiTrack.h"
 #include "Pattern.h"
 #include "SerializationKeys.h"
 #include "Arpeggiator.h"
+#include "ScriptsManager.h"
+#include "SelectionTransformExecutor.h"
 #include "Transport.h"
 #include "CommandIDs.h"
 
@@ -276,35 +280,12 @@ static PianoSequence *getPianoSequence(SelectionProxyArray::Ptr selection)
 
 float SequencerOperations::findStartBeat(const Lasso &selection)
 {
-    if (selection.getNumSelected() == 0)
-    { return 0.f; }
-    
-    float startBeat = FLT_MAX;
-    
-    for (int i = 0; i < selection.getNumSelected(); ++i)
-    {
-        NoteComponent *note = static_cast<NoteComponent *>(selection.getSelectedItem(i));
-        startBeat = jmin(startBeat, note->getBeat());
-    }
-    
-    return startBeat;
+    return selection.getFirstBeat();
 }
 
 float SequencerOperations::findEndBeat(const Lasso &selection)
 {
-    if (selection.getNumSelected() == 0)
-    { return 0.f; }
-    
-    float endBeat = -FLT_MAX;
-    
-    for (int i = 0; i < selection.getNumSelected(); ++i)
-    {
-        const NoteComponent *nc = static_cast<const NoteComponent *>(selection.getSelectedItem(i));
-        const float beatPlusLength = nc->getBeat() + nc->getLength();
-        endBeat = jmax(endBeat, beatPlusLength);
-    }
-    
-    return endBeat;
+    return selection.getLastBeat();
 }
 
 float SequencerOperations::findStartBeat(const Array<Note> &selection)
@@ -1850,6 +1831,59 @@ bool SequencerOperations::findHarmonicContext(const Lasso &selection, const Clip
     return false;
 }
 
+// Signature events are sorted, so the last one starting before the beat
+// is the one in effect; the first one is taken no matter where it resides:
+template<typename T>
+static T findSignatureAt(WeakReference<MidiTrack> track, float beat)
+{
+    T result;
+
+    if (track == nullptr)
+    {
+        return result;
+    }
+
+    const auto *sequence = track->getSequence();
+    for (int i = 0; i < sequence->size(); ++i)
+    {
+        const auto *event = sequence->getUnchecked(i);
+        if (i > 0 && event->getBeat() > beat)
+        {
+            break;
+        }
+
+        result = *static_cast<const T *>(event);
+    }
+
+    return result;
+}
+
+Result SequencerOperations::applyTransformScript(const Lasso &selection, const Clip &clip,
+    WeakReference<MidiTrack> timeSignatures, WeakReference<MidiTrack> keySignatures,
+    const Script &script, bool shouldCheckpoint)
+{
+    if (selection.getNumSelected() == 0)
+    {
+        return Result::ok();
+    }
+
+    const auto startBeat = SequencerOperations::findStartBeat(selection) + clip.getBeat();
+    const auto time = findSignatureAt<TimeSignatureEvent>(timeSignatures, startBeat);
+    const auto key = findSignatureAt<KeySignatureEvent>(keySignatures, startBeat);
+
+    PianoChangeGroup groupBefore, groupAfter;
+    auto &executor = ScriptsManager::getInstance().getSelectionTransformExecutor();
+    const auto result = executor.execute(script, selection, time, key, groupBefore, groupAfter);
+    if (result.failed())
+    {
+        return result;
+    }
+
+    bool didCheckpoint = !shouldCheckpoint;
+    applyPianoChanges(groupBefore, groupAfter, didCheckpoint);
+    return Result::ok();
+}
+
 void SequencerOperations::duplicateSelection(const Lasso &selection, bool shouldCheckpoint)
 {
     if (selection.getNumSelected() == 0) { return; }
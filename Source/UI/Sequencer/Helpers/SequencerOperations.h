@@ -25,6 +25,7 @@ class MidiTrackTreeItem;
 class MidiTrack;
 class Pattern;
 class Clipboard;
+class Script;
 
 #include "Note.h"
 #include "AutomationEvent.h"
@@ -87,6 +88,10 @@ struct SequencerOperations final
     static bool findHarmonicContext(const Lasso &selection, const Clip &clip,
         WeakReference<MidiTrack> keySignatures, Scale::Ptr &outScale, Note::Key &outRootKey);
 
+    static Result applyTransformScript(const Lasso &selection, const Clip &clip,
+        WeakReference<MidiTrack> timeSignatures, WeakReference<MidiTrack> keySignatures,
+        const Script &script, bool shouldCheckpoint = true);
+
     static Array<Note> cutEvents(const Array<Note> &notes,
         const Array<float> &relativeCutBeats, bool shouldCheckpoint = true);
 
@@ -113,10 +113,16 @@ HybridRoll::HybridRoll(ProjectTreeItem &parentProject, Viewport &viewportRef,
     lastTransportPosition(0.0),
     playheadOffset(0.0),
     shouldFollowPlayhead(false),
+    isScrollingToSeekPosition(false),
     barLineColour(this->findColour(ColourIDs::Roll::barLine)),
     barLineBevelColour(this->findColour(ColourIDs::Roll::barLineBevel)),
     beatLineColour(this->findColour(ColourIDs::Roll::beatLine)),
-    snapLineColour(this->findColour(ColourIDs::Roll::snapLine))
+    snapLineColour(this->findColour(ColourIDs::Roll::snapLine)),
+    beatLinesCacheStartX(0),
+    beatLinesCacheEndX(0),
+    beatLinesCacheBarWidth(0.f),
+    beatLinesCacheFirstBar(0.f),
+    beatLinesCacheOutdated(true)
 {
     this->setOpaque(true);
     this->setPaintingIsUnclipped(true);
@@ -679,145 +685,92 @@ void HybridRoll::setBarWidth(const float newBarWidth)
 #define MIN_BAR_WIDTH 14
 #define MIN_BEAT_WIDTH 8
 
-void HybridRoll::computeVisibleBeatLines()
+void HybridRoll::computeBeatLines(float startX, float endX)
 {
-    this->visibleBars.clearQuick();
-    this->visibleBeats.clearQuick();
-    this->visibleSnaps.clearQuick();
+    const float beatWidth = this->barWidth / float(BEATS_PER_BAR);
+    const float firstBeat = this->getFirstBeat();
 
-    const auto tsSequence =
-        this->project.getTimeline()->getTimeSignatures()->getSequence();
-    
-    const float zeroCanvasOffset = this->firstBar * this->barWidth; // usually a negative value
-    const float viewPosX = float(this->viewport.getViewPositionX());
-    const float paintStartX = viewPosX + zeroCanvasOffset;
-    const float paintEndX = float(viewPosX + this->viewport.getViewWidth()) + zeroCanvasOffset;
-    
-    const float paintStartBar = roundf(paintStartX / this->barWidth) - 2.f;
-    const float paintEndBar = roundf(paintEndX / this->barWidth) + 1.f;
-    
-    // Get number of snaps depending on bar width, 
+    // Get number of snaps depending on bar width,
     // 2 for 64, 4 for 128, 8 for 256, etc:
     const float nearestPowTwo = ceilf(log(this->barWidth) / log(2.f));
-    const float numSnaps = powf(2, jlimit(1.f, 6.f, nearestPowTwo - 5.f)); // use -4.f for twice as dense grid
-    const float snapWidth = this->barWidth / numSnaps;
+    const int snapLevel = int(jlimit(1.f, 6.f, nearestPowTwo - 5.f)); // use -4.f for twice as dense grid
 
-    int numerator = TIME_SIGNATURE_DEFAULT_NUMERATOR;
-    int denominator = TIME_SIGNATURE_DEFAULT_DENOMINATOR;
-    float barIterator = float(this->firstBar);
-    int nextSignatureIdx = 0;
-    bool firstEvent = true;
+    const auto &grid = this->project.getTimeline()->getBeatGrid();
+    grid.findLines(firstBeat + startX / beatWidth, firstBeat + endX / beatWidth, snapLevel,
+        MIN_BAR_WIDTH / beatWidth, MIN_BEAT_WIDTH / beatWidth, this->beatLines);
 
-    // Find a time signature to start from (or use default values):
-    // find a first time signature after a paint start and take a previous one, if any
-    for (; nextSignatureIdx < tsSequence->size(); ++nextSignatureIdx)
-    {
-        const auto signature =
-            static_cast<TimeSignatureEvent *>(tsSequence->getUnchecked(nextSignatureIdx));
-
-        // The very first event defines what's before it (both time signature and offset)
-        if (firstEvent)
-        {
-            numerator = signature->getNumerator();
-            denominator = signature->getDenominator();
-            const float beatStep = 1.f / float(denominator);
-            const float barStep = beatStep * float(numerator);
-            barIterator += fmodf(signature->getBeat() / BEATS_PER_BAR - float(this->firstBar), barStep) - barStep;
-            firstEvent = false;
-        }
+    this->visibleBars.clearQuick();
+    this->visibleBeats.clearQuick();
+    this->visibleSnaps.clearQuick();
 
-        if (signature->getBeat() >= (paintStartBar * BEATS_PER_BAR))
-        {
-            break;
-        }
+    for (const auto &beat : this->beatLines.bars)
+    {
+        this->visibleBars.add((beat - firstBeat) * beatWidth);
+    }
 
-        numerator = signature->getNumerator();
-        denominator = signature->getDenominator();
-        barIterator = signature->getBeat() / BEATS_PER_BAR;
+    for (const auto &beat : this->beatLines.beats)
+    {
+        this->visibleBeats.add((beat - firstBeat) * beatWidth);
     }
 
-    // At this point we have barIterator pointing at the anchor,
-    // that is nearest to the left side of visible screen area
-    // (it could be either TimeSignatureEvent, or just the very first bar)
+    for (const auto &beat : this->beatLines.snaps)
+    {
+        this->visibleSnaps.add((beat - firstBeat) * beatWidth);
+    }
+}
 
-    float barWidthSum = 0.f;
-    bool canDrawBarLine = false;
+void HybridRoll::updateBeatLinesCacheIfNeeded()
+{
+    const int viewStartX = this->viewport.getViewPositionX();
+    const int viewEndX = viewStartX + this->viewport.getViewWidth();
 
-    while (barIterator <= paintEndBar)
+    if (!this->beatLinesCacheOutdated &&
+        this->beatLinesCacheBarWidth == this->barWidth &&
+        this->beatLinesCacheFirstBar == this->firstBar &&
+        this->beatLinesCacheStartX <= viewStartX &&
+        this->beatLinesCacheEndX >= viewEndX)
     {
-        // We don't do anything else unless we have reached the left side of visible area
-        // Since we have already found the nearest time signature,
-        // we assume that time signature does not change in between,
-        // and we only need to count barWidthSum:
+        return;
+    }
 
-        float beatStep = 1.f / float(denominator);
-        float barStep = beatStep * float(numerator);
-        const float barStartX = this->barWidth * barIterator - zeroCanvasOffset;
-        const float stepWidth = this->barWidth * barStep;
+    const int margin = this->viewport.getViewWidth();
+    const int startX = jmax(0, viewStartX - margin);
+    const int endX = viewEndX + margin;
 
-        barWidthSum += stepWidth;
-        canDrawBarLine = barWidthSum > MIN_BAR_WIDTH;
-        barWidthSum = canDrawBarLine ? 0.f : barWidthSum;
+    this->beatLinesCacheOutdated = false;
+    this->beatLinesCacheBarWidth = this->barWidth;
+    this->beatLinesCacheFirstBar = this->firstBar;
+    this->beatLinesCacheStartX = startX;
+    this->beatLinesCacheEndX = endX;
 
-        // When in the drawing area:
-        if (barIterator > paintStartBar)
-        {
-            if (canDrawBarLine)
-            {
-                visibleBars.add(barStartX);
-            }
+    this->computeBeatLines(float(startX), float(endX));
 
-            // Check if we have more time signatures to come
-            TimeSignatureEvent *nextSignature = nullptr;
-            if (nextSignatureIdx < tsSequence->size())
-            {
-                nextSignature = static_cast<TimeSignatureEvent *>(tsSequence->getUnchecked(nextSignatureIdx));
-            }
+    // +1 pixel for the bar line bevel
+    this->beatLinesCache = Image(Image::ARGB, endX - startX + 1, 1, true);
+    Graphics g(this->beatLinesCache);
 
-            // Now for the beat lines
-            bool lastFrame = false;
-            for (float j = 0.f; j < barStep && !lastFrame; j += beatStep)
-            {
-                const float beatStartX = barStartX + this->barWidth * j;
-                float nextBeatStartX = barStartX + this->barWidth * (j + beatStep);
-
-                // Check for time signature change at this point
-                if (nextSignature != nullptr)
-                {
-                    const float tsBar = nextSignature->getBeat() / BEATS_PER_BAR;
-                    if (tsBar <= (barIterator + j + beatStep))
-                    {
-                        numerator = nextSignature->getNumerator();
-                        denominator = nextSignature->getDenominator();
-                        barStep = (tsBar - barIterator); // i.e. incomplete bar
-                        nextBeatStartX = barStartX + this->barWidth * barStep;
-                        nextSignatureIdx++;
-                        barWidthSum = MIN_BAR_WIDTH; // forces to draw the next bar line
-                        lastFrame = true;
-                    }
-                }
-
-                // Get snap lines and beat lines
-                for (float k = beatStartX + snapWidth;
-                    k < (nextBeatStartX - 1);
-                    k += snapWidth)
-                {
-                    if (k >= viewPosX)
-                    {
-                        visibleSnaps.add(k);
-                    }
-                }
-
-                if (beatStartX >= viewPosX &&
-                    j >= beatStep && // don't draw the first one as it is a bar line
-                    (nextBeatStartX - beatStartX) > MIN_BEAT_WIDTH)
-                {
-                    visibleBeats.add(beatStartX);
-                }
-            }
-        }
+    g.setColour(this->barLineColour);
+    for (const auto &f : this->visibleBars)
+    {
+        g.fillRect(int(floorf(f)) - startX, 0, 1, 1);
+    }
+
+    g.setColour(this->barLineBevelColour);
+    for (const auto &f : this->visibleBars)
+    {
+        g.fillRect(int(floorf(f)) + 1 - startX, 0, 1, 1);
+    }
+
+    g.setColour(this->beatLineColour);
+    for (const auto &f : this->visibleBeats)
+    {
+        g.fillRect(int(floorf(f)) - startX, 0, 1, 1);
+    }
 
-        barIterator += barStep;
+    g.setColour(this->snapLineColour);
+    for (const auto &f : this->visibleSnaps)
+    {
+        g.fillRect(int(floorf(f)) - startX, 0, 1, 1);
     }
 }
 
@@ -927,6 +880,7 @@ void HybridRoll::onChangeMidiEvent(const MidiEvent &event, const MidiEvent &newE
     // Time signatures have changed, need to repaint
     if (event.isTypeOf(MidiEvent::TimeSignature))
     {
+        this->beatLinesCacheOutdated = true;
         this->updateChildrenBounds();
         this->repaint();
     }
@@ -936,6 +890,7 @@ void HybridRoll::onAddMidiEvent(const MidiEvent &event)
 {
     if (event.isTypeOf(MidiEvent::TimeSignature))
     {
+        this->beatLinesCacheOutdated = true;
         this->updateChildrenBounds();
         this->repaint();
     }
@@ -945,6 +900,7 @@ void HybridRoll::onRemoveMidiEvent(const MidiEvent &event)
 {
     if (event.isTypeOf(MidiEvent::TimeSignature))
     {
+        this->beatLinesCacheOutdated = true;
         this->updateChildrenBounds();
         this->repaint();
     }
@@ -1220,34 +1176,19 @@ void HybridRoll::resized()
 
 void HybridRoll::paint(Graphics &g)
 {
-    this->computeVisibleBeatLines();
+    this->updateBeatLinesCacheIfNeeded();
 
-    const float paintStartY = float(this->viewport.getViewPositionY());
-    const float paintEndY = paintStartY + this->viewport.getViewHeight();
+    const Rectangle<int> cacheArea(this->beatLinesCacheStartX, 0,
+        this->beatLinesCache.getWidth(), this->getHeight());
 
-    g.setColour(this->barLineColour);
-    for (const auto &f : this->visibleBars)
-    {
-        g.drawVerticalLine(int(floorf(f)), paintStartY, paintEndY);
-    }
+    const auto paintArea = g.getClipBounds()
+        .getIntersection(this->viewport.getViewArea())
+        .getIntersection(cacheArea);
 
-    g.setColour(this->barLineBevelColour);
-    for (const auto &f : this->visibleBars)
-    {
-        g.drawVerticalLine(int(floorf(f)) + 1, paintStartY, paintEndY);
-    }
+    g.setFillType(FillType(this->beatLinesCache,
+        AffineTransform::translation(float(this->beatLinesCacheStartX), 0.f)));
 
-    g.setColour(this->beatLineColour);
-    for (const auto &f : this->visibleBeats)
-    {
-        g.drawVerticalLine(int(floorf(f)), paintStartY, paintEndY);
-    }
-    
-    g.setColour(this->snapLineColour);
-    for (const auto &f : this->visibleSnaps)
-    {
-        g.drawVerticalLine(int(floorf(f)), paintStartY, paintEndY);
-    }
+    g.fillRect(paintArea);
 }
 
 //===----------------------------------------------------------------------===//
@@ -1382,7 +1323,7 @@ void HybridRoll::startFollowingPlayhead()
 #if ROLL_VIEW_FOLLOWS_PLAYHEAD
     this->playheadOffset = this->findPlayheadOffsetFromViewCentre();
     this->shouldFollowPlayhead = true;
-    this->triggerAsyncUpdate();
+    this->requestFrame();
 #endif
 }
 
@@ -1394,9 +1335,9 @@ void HybridRoll::stopFollowingPlayhead()
     }
 
 #if ROLL_VIEW_FOLLOWS_PLAYHEAD
-    this->stopTimer();
+    this->isScrollingToSeekPosition = false;
     // this introduces the case when I change a note during playback, and the note component position is not updated
-    //this->cancelPendingUpdate();
+    //this->cancelFrame();
     this->shouldFollowPlayhead = false;
 #endif
 }
@@ -1405,7 +1346,8 @@ void HybridRoll::scrollToSeekPosition()
 {
 #if ROLL_VIEW_FOLLOWS_PLAYHEAD
     this->startFollowingPlayhead();
-    this->startTimer(8);
+    this->isScrollingToSeekPosition = true;
+    this->requestFrame();
 #else
     const int playheadX = this->getXPositionByTransportPosition(this->lastTransportPosition.get(), float(this->getWidth()));
     this->viewport.setViewPosition(playheadX - (this->viewport.getViewWidth() / 3), this->viewport.getViewPositionY());
@@ -1414,10 +1356,10 @@ void HybridRoll::scrollToSeekPosition()
 }
 
 //===----------------------------------------------------------------------===//
-// AsyncUpdater
+// FrameScheduler::Client
 //===----------------------------------------------------------------------===//
 
-void HybridRoll::handleAsyncUpdate()
+bool HybridRoll::onFrame(double frameIntervalMs)
 {
     // batch repaint & resize stuff
     if (this->batchRepaintList.size() > 0)
@@ -1462,7 +1404,21 @@ void HybridRoll::handleAsyncUpdate()
 
         this->updateChildrenPositions();
     }
+
+    // keep scrolling until the view settles at the seek position
+    if (this->isScrollingToSeekPosition)
+    {
+        if (fabs(this->playheadOffset) < 0.01)
+        {
+            this->stopFollowingPlayhead();
+            return false;
+        }
+
+        return true;
+    }
 #endif
+
+    return false;
 }
 
 double HybridRoll::findPlayheadOffsetFromViewCentre() const
@@ -1475,26 +1431,7 @@ double HybridRoll::findPlayheadOffsetFromViewCentre() const
 void HybridRoll::triggerBatchRepaintFor(FloatBoundsComponent *target)
 {
     this->batchRepaintList.add(target);
-    this->triggerAsyncUpdate();
-}
-
-//===----------------------------------------------------------------------===//
-// Timer
-//===----------------------------------------------------------------------===//
-
-void HybridRoll::hiResTimerCallback()
-{
-    if (fabs(this->playheadOffset) < 0.01)
-    {
-        MessageManagerLock lock(Thread::getCurrentThread());
-
-        if (lock.lockWasGained())
-        {
-            this->stopFollowingPlayhead();
-        }
-    }
-
-    this->triggerAsyncUpdate();
+    this->requestFrame();
 }
 
 //===----------------------------------------------------------------------===//
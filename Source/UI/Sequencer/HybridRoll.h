@@ -49,6 +49,8 @@ class TimelineWarningMarker;
 #include "Lasso.h"
 #include "HybridRollEditMode.h"
 #include "AudioMonitor.h"
+#include "BeatGrid.h"
+#include "FrameScheduler.h"
 
 #define HYBRID_ROLL_MAX_BAR_WIDTH (192)
 #define HYBRID_ROLL_HEADER_HEIGHT (40)
@@ -72,8 +74,7 @@ class HybridRoll :
     public LassoSource<SelectableComponent *>,
     protected ChangeListener, // listens to HybridRollEditMode,
     protected TransportListener,
-    protected AsyncUpdater, // for async scrolling on transport listener events
-    protected HighResolutionTimer, // for smooth scrolling to seek position
+    protected FrameScheduler::Client, // for batch repaints and smooth scrolling to seek position
     protected Playhead::Listener, // for smooth scrolling to seek position
     protected AudioMonitor::ClippingListener // for displaying clipping indicator components
 {
@@ -293,22 +294,17 @@ protected:
 
     double playheadOffset;
     bool shouldFollowPlayhead;
+    bool isScrollingToSeekPosition;
     
     //===------------------------------------------------------------------===//
-    // AsyncUpdater
+    // FrameScheduler::Client
     //===------------------------------------------------------------------===//
     
-    void handleAsyncUpdate() override;
+    bool onFrame(double frameIntervalMs) override;
 
     double findPlayheadOffsetFromViewCentre() const;
     friend class HybridRollHeader;
     
-    //===------------------------------------------------------------------===//
-    // Timer
-    //===------------------------------------------------------------------===//
-
-    void hiResTimerCallback() override;
-    
 protected:
     
     // These two methods are supposed to layout non-midi-event children
@@ -384,12 +380,26 @@ protected:
     Array<float> visibleBeats;
     Array<float> visibleSnaps;
 
+    BeatGrid::Lines beatLines;
+
     const Colour barLineColour;
     const Colour barLineBevelColour;
     const Colour beatLineColour;
     const Colour snapLineColour;
 
-    void computeVisibleBeatLines();
+    // Beat lines are rendered into a one pixel high strip,
+    // covering the visible area plus one screen at each side,
+    // which is then tiled vertically over the dirty region only;
+    // so scrolling and partial repaints don't recompute the grid
+    Image beatLinesCache;
+    int beatLinesCacheStartX;
+    int beatLinesCacheEndX;
+    float beatLinesCacheBarWidth;
+    float beatLinesCacheFirstBar;
+    bool beatLinesCacheOutdated;
+
+    void computeBeatLines(float startX, float endX);
+    void updateBeatLinesCacheIfNeeded();
 
 protected:
 
@@ -17,6 +17,20 @@
 
 #include "Common.h"
 #include "Lasso.h"
+#include "MidiEventComponent.h"
+#include "NoteComponent.h"
+
+struct SelectableComponentsComparator final
+{
+    static int compareElements(SelectableComponent *first, SelectableComponent *second) noexcept
+    {
+        return MidiEventComponent::compareElements(
+            static_cast<MidiEventComponent *>(first),
+            static_cast<MidiEventComponent *>(second));
+    }
+};
+
+static SelectableComponentsComparator selectionComparator;
 
 Lasso::Lasso() :
     SelectedItemSet(),
@@ -41,14 +55,122 @@ Lasso::Lasso(const SelectedItemSet &other) :
 
 void Lasso::itemSelected(SelectableComponent *item)
 {
-    this->invalidateCacheAndResetId();
+    this->resetId();
     item->setSelected(true);
+
+    if (this->selectionsCacheIsValid)
+    {
+        const String &groupId(item->getSelectionGroupId());
+        auto &targetArray = this->selectionsCache[groupId];
+        if (targetArray == nullptr)
+        {
+            targetArray = new SelectionProxyArray();
+        }
+
+        if (targetArray->needsSorting)
+        {
+            targetArray->add(item);
+        }
+        else
+        {
+            targetArray->addSorted(selectionComparator, item);
+        }
+    }
+
+    if (this->notesRangeIsValid)
+    {
+        if (const auto *nc = dynamic_cast<NoteComponent *>(item))
+        {
+            this->notesRange.extend(nc->getNote());
+        }
+    }
 }
 
 void Lasso::itemDeselected(SelectableComponent *item)
 {
-    this->invalidateCacheAndResetId();
+    this->resetId();
     item->setSelected(false);
+
+    if (this->isDeselectingAll)
+    {
+        return; // the caches are already cleared
+    }
+
+    if (this->getNumSelected() == 0)
+    {
+        // The last item is gone, so there's nothing to look up:
+        this->selectionsCache.clear();
+        this->selectionsCacheIsValid = true;
+        this->notesRange = {};
+        this->notesRangeIsValid = true;
+        return;
+    }
+
+    if (this->selectionsCacheIsValid)
+    {
+        const String &groupId(item->getSelectionGroupId());
+        const auto found = this->selectionsCache.find(groupId);
+        if (found != this->selectionsCache.end())
+        {
+            auto &targetArray = *found->second;
+            const int index = targetArray.needsSorting ? -1 :
+                targetArray.indexOfSorted(selectionComparator, item);
+
+            if (index >= 0 && targetArray.getUnchecked(index) == item)
+            {
+                targetArray.remove(index);
+            }
+            else
+            {
+                targetArray.removeFirstMatchingValue(item);
+            }
+
+            if (targetArray.isEmpty())
+            {
+                this->selectionsCache.erase(found);
+            }
+        }
+    }
+
+    if (this->notesRangeIsValid)
+    {
+        // Only need to recalculate the aggregates when the deselected
+        // note has been the one to define any of the boundaries:
+        if (const auto *nc = dynamic_cast<NoteComponent *>(item))
+        {
+            this->notesRangeIsValid = !this->notesRange.isOnBoundary(nc->getNote());
+        }
+    }
+}
+
+void Lasso::deselectAll()
+{
+    if (this->getNumSelected() == 0)
+    {
+        return;
+    }
+
+    this->selectionsCache.clear();
+    this->selectionsCacheIsValid = true;
+    this->notesRange = {};
+    this->notesRangeIsValid = true;
+
+    const ScopedValueSetter<bool> scope(this->isDeselectingAll, true);
+    SelectedItemSet::deselectAll();
+}
+
+void Lasso::itemChanged(SelectableComponent *item)
+{
+    if (this->selectionsCacheIsValid)
+    {
+        const auto found = this->selectionsCache.find(item->getSelectionGroupId());
+        if (found != this->selectionsCache.end())
+        {
+            found->second->needsSorting = true;
+        }
+    }
+
+    this->notesRangeIsValid = false;
 }
 
 void Lasso::needsToCalculateSelectionBounds() noexcept
@@ -66,22 +188,69 @@ Rectangle<int> Lasso::getSelectionBounds() const noexcept
     return this->bounds;
 }
 
-void Lasso::invalidateCacheAndResetId()
+void Lasso::resetId()
 {
     this->id = this->random.nextInt64();
+}
+
+void Lasso::invalidateCacheAndResetId()
+{
+    this->resetId();
     this->selectionsCache.clear();
+    this->selectionsCacheIsValid = false;
+    this->notesRangeIsValid = false;
 }
 
-const Lasso::Lasso::GroupedSelections &Lasso::getGroupedSelections() const
+const Lasso::GroupedSelections &Lasso::getGroupedSelections() const
 {
-    if (this->selectionsCache.size() == 0)
+    if (!this->selectionsCacheIsValid)
     {
         this->rebuildCache();
     }
 
+    for (auto &s : this->selectionsCache)
+    {
+        auto &group = *s.second;
+        if (group.needsSorting)
+        {
+            // Most of the time, like when dragging a group of notes,
+            // their order doesn't change, and there's nothing to sort:
+            if (!std::is_sorted(group.begin(), group.end(),
+                [](SelectableComponent *a, SelectableComponent *b)
+                { return selectionComparator.compareElements(a, b) < 0; }))
+            {
+                group.sort(selectionComparator);
+            }
+
+            group.needsSorting = false;
+        }
+    }
+
     return this->selectionsCache;
 }
 
+const Lasso::NotesRange &Lasso::getNotesRange() const
+{
+    if (!this->notesRangeIsValid)
+    {
+        this->rebuildNotesRange();
+    }
+
+    return this->notesRange;
+}
+
+float Lasso::getFirstBeat() const
+{
+    const auto &range = this->getNotesRange();
+    return range.isEmpty() ? 0.f : range.startBeat;
+}
+
+float Lasso::getLastBeat() const
+{
+    const auto &range = this->getNotesRange();
+    return range.isEmpty() ? 0.f : range.endBeat;
+}
+
 bool Lasso::shouldDisplayGhostNotes() const noexcept
 {
     return (this->getNumSelected() <= 32); // just a sane limit
@@ -94,23 +263,73 @@ int64 Lasso::getId() const noexcept
 
 void Lasso::rebuildCache() const
 {
+    this->selectionsCache.clear();
+
     for (int i = 0; i < this->getNumSelected(); ++i)
     {
         SelectableComponent *item = this->getSelectedItem(i);
         const String &groupId(item->getSelectionGroupId());
 
-        SelectionProxyArray::Ptr targetArray;
-
-        if (this->selectionsCache.contains(groupId))
-        {
-            targetArray = this->selectionsCache[groupId];
-        }
-        else
+        auto &targetArray = this->selectionsCache[groupId];
+        if (targetArray == nullptr)
         {
             targetArray = new SelectionProxyArray();
         }
 
         targetArray->add(item);
-        this->selectionsCache[groupId] = targetArray;
     }
+
+    // One sort per group instead of sorted insertions:
+    for (auto &s : this->selectionsCache)
+    {
+        s.second->needsSorting = true;
+    }
+
+    this->selectionsCacheIsValid = true;
+}
+
+void Lasso::rebuildNotesRange() const
+{
+    this->notesRange = {};
+
+    for (int i = 0; i < this->getNumSelected(); ++i)
+    {
+        if (const auto *nc = dynamic_cast<NoteComponent *>(this->getSelectedItem(i)))
+        {
+            this->notesRange.extend(nc->getNote());
+        }
+    }
+
+    this->notesRangeIsValid = true;
+}
+
+//===----------------------------------------------------------------------===//
+// NotesRange
+//===----------------------------------------------------------------------===//
+
+bool Lasso::NotesRange::isEmpty() const noexcept
+{
+    return this->startBeat > this->endBeat;
+}
+
+void Lasso::NotesRange::extend(const Note &note) noexcept
+{
+    const float noteStart = note.getBeat();
+    const float noteEnd = noteStart + note.getLength();
+    this->startBeat = jmin(this->startBeat, noteStart);
+    this->endBeat = jmax(this->endBeat, noteEnd);
+    this->minKey = jmin(this->minKey, note.getKey());
+    this->maxKey = jmax(this->maxKey, note.getKey());
+    this->minVelocity = jmin(this->minVelocity, note.getVelocity());
+    this->maxVelocity = jmax(this->maxVelocity, note.getVelocity());
+}
+
+bool Lasso::NotesRange::isOnBoundary(const Note &note) const noexcept
+{
+    return note.getBeat() <= this->startBeat ||
+        (note.getBeat() + note.getLength()) >= this->endBeat ||
+        note.getKey() <= this->minKey ||
+        note.getKey() >= this->maxKey ||
+        note.getVelocity() <= this->minVelocity ||
+        note.getVelocity() >= this->maxVelocity;
 }
@@ -17,6 +17,8 @@
 
 #pragma once
 
+class Note;
+
 #include "SelectableComponent.h"
 #include "MidiSequence.h"
 
@@ -40,6 +42,14 @@ public:
         return static_cast<T *>(this->getUnchecked(index));
     }
 
+private:
+
+    // Items are kept sorted by beat, unless some of them
+    // have changed since, so that the order is restored lazily:
+    bool needsSorting = false;
+
+    friend class Lasso;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SelectionProxyArray)
 };
 
@@ -54,16 +64,49 @@ public:
     void itemSelected(SelectableComponent *item) override;
     void itemDeselected(SelectableComponent *item) override;
 
+    // Hides SelectedItemSet::deselectAll, which is not virtual, so that
+    // the groups and the aggregates are cleared at once, rather than
+    // removing every item from its sorted group one by one in O(N^2)
+    void deselectAll();
+
+    // Should be called by the roll when any of selected events has changed,
+    // so that the ordering and the aggregates are updated on the next request:
+    void itemChanged(SelectableComponent *item);
+
     int64 getId() const noexcept;
     bool shouldDisplayGhostNotes() const noexcept;
     void needsToCalculateSelectionBounds() noexcept;
     Rectangle<int> getSelectionBounds() const noexcept;
     
     // Grouped selections are selected events, split by track,
-    // so that is easier to perform undo/redo actions:
+    // so that is easier to perform undo/redo actions;
+    // each group is sorted by beat:
     using GroupedSelections = SparseHashMap<String, SelectionProxyArray::Ptr, StringHash>;
     const GroupedSelections &getGroupedSelections() const;
 
+    // Aggregated parameters of all selected notes;
+    // updated in O(1) as notes are added to selection,
+    // and recalculated lazily after deselection or changes:
+    struct NotesRange final
+    {
+        float startBeat = FLT_MAX;
+        float endBeat = -FLT_MAX;
+        int minKey = INT_MAX;
+        int maxKey = INT_MIN;
+        float minVelocity = FLT_MAX;
+        float maxVelocity = -FLT_MAX;
+
+        bool isEmpty() const noexcept;
+        void extend(const Note &note) noexcept;
+        bool isOnBoundary(const Note &note) const noexcept;
+    };
+
+    const NotesRange &getNotesRange() const;
+
+    // Return 0 for an empty selection, just like SequencerOperations did:
+    float getFirstBeat() const;
+    float getLastBeat() const;
+
     template<typename T>
     T *getFirstAs() const
     {
@@ -87,8 +130,17 @@ private:
     mutable Random random;
 
     mutable GroupedSelections selectionsCache;
+    mutable bool selectionsCacheIsValid;
+
+    mutable NotesRange notesRange;
+    mutable bool notesRangeIsValid;
+
+    bool isDeselectingAll = false;
+
+    void resetId();
     void invalidateCacheAndResetId();
     void rebuildCache() const;
+    void rebuildNotesRange() const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Lasso)
     JUCE_DECLARE_WEAK_REFERENCEABLE(Lasso)
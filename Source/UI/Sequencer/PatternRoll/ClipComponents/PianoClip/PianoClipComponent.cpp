@@ -17,13 +17,13 @@
 
 #include "Common.h"
 #include "PianoClipComponent.h"
+#include "PianoSequenceThumbnails.h"
 #include "ProjectTreeItem.h"
 #include "MidiSequence.h"
 #include "PianoSequence.h"
-#include "PlayerThread.h"
-#include "HybridRoll.h"
-#include "AnnotationEvent.h"
+#include "PatternRoll.h"
 #include "MidiTrack.h"
+#include "Note.h"
 
 PianoClipComponent::PianoClipComponent(ProjectTreeItem &project, MidiSequence *sequence,
     HybridRoll &roll, const Clip &clip) :
@@ -33,7 +33,6 @@ PianoClipComponent::PianoClipComponent(ProjectTreeItem &project, MidiSequence *s
     sequence(sequence)
 {
     this->setPaintingIsUnclipped(true);
-    this->reloadTrackMap();
     this->project.addListener(this);
 }
 
@@ -46,9 +45,14 @@ PianoClipComponent::~PianoClipComponent()
 // Component
 //===----------------------------------------------------------------------===//
 
-void PianoClipComponent::resized()
+void PianoClipComponent::paint(Graphics &g)
 {
-    this->repositionAllChildren();
+    ClipComponent::paint(g);
+
+    // all clips of the same sequence are drawn from one shared thumbnail,
+    // instead of keeping a child component for every note of every clip
+    this->getRoll().getSequenceThumbnails().paint(g, this->sequence, this->clip,
+        float(this->getWidth()), float(this->getHeight()));
 }
 
 //===----------------------------------------------------------------------===//
@@ -57,53 +61,27 @@ void PianoClipComponent::resized()
 
 void PianoClipComponent::onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent &newEvent)
 {
-    if (oldEvent.isTypeOf(MidiEvent::Note))
+    if (newEvent.isTypeOf(MidiEvent::Note) &&
+        newEvent.getSequence() == this->sequence)
     {
-        const Note &note = static_cast<const Note &>(oldEvent);
-        const Note &newNote = static_cast<const Note &>(newEvent);
-        if (newNote.getSequence() != this->sequence) { return; }
-
-        if (const auto component = this->componentsMap[note].release())
-        {
-            this->componentsMap.erase(note);
-            this->componentsMap[newNote] = UniquePointer<PianoSequenceMapNoteComponent>(component);
-            this->applyNoteBounds(component);
-        }
-
         this->roll.triggerBatchRepaintFor(this);
     }
 }
 
 void PianoClipComponent::onAddMidiEvent(const MidiEvent &event)
 {
-    if (event.isTypeOf(MidiEvent::Note))
+    if (event.isTypeOf(MidiEvent::Note) &&
+        event.getSequence() == this->sequence)
     {
-        const Note &note = static_cast<const Note &>(event);
-        if (note.getSequence() != this->sequence) { return; }
-
-        auto component = new PianoSequenceMapNoteComponent(note);
-        this->componentsMap[note] = UniquePointer<PianoSequenceMapNoteComponent>(component);
-
-        this->addAndMakeVisible(component);
-        this->applyNoteBounds(component);
-        component->toFront(false);
-
         this->roll.triggerBatchRepaintFor(this);
     }
 }
 
 void PianoClipComponent::onRemoveMidiEvent(const MidiEvent &event)
 {
-    if (event.isTypeOf(MidiEvent::Note))
+    if (event.isTypeOf(MidiEvent::Note) &&
+        event.getSequence() == this->sequence)
     {
-        const Note &note = static_cast<const Note &>(event);
-        if (note.getSequence() != this->sequence) { return; }
-
-        if (const auto deletedComponent = this->componentsMap[note].get())
-        {
-            this->componentsMap.erase(note);
-        }
-
         this->roll.triggerBatchRepaintFor(this);
     }
 }
@@ -113,105 +91,27 @@ void PianoClipComponent::onChangeClip(const Clip &oldClip, const Clip &newClip)
     if (this->clip == oldClip)
     {
         this->updateColours(); // transparency depends on clip velocity
-        this->repositionAllChildren(); // positions depend on key offset
+        this->repaint(); // positions depend on key offset
     }
 }
 
 void PianoClipComponent::onChangeTrackProperties(MidiTrack *const track)
 {
     if (track->getSequence() != this->sequence) { return; }
-
-    //this->setVisible(false);
-    //for (const auto &e : this->componentsMap)
-    //{
-    //    e.second->updateColour();
-    //}
-    //this->setVisible(true);
-
     this->repaint();
 }
 
 void PianoClipComponent::onReloadProjectContent(const Array<MidiTrack *> &tracks)
 {
-    this->reloadTrackMap();
+    this->repaint();
 }
 
 void PianoClipComponent::onAddTrack(MidiTrack *const track)
 {
-    if (track->getSequence() == this->sequence &&
-        track->getSequence()->size() > 0)
-    {
-        this->reloadTrackMap();
-    }
-}
-
-void PianoClipComponent::onRemoveTrack(MidiTrack *const track)
-{
-    if (track->getSequence() != this->sequence) { return; }
-
-    for (int i = 0; i < track->getSequence()->size(); ++i)
-    {
-        const Note &note = static_cast<const Note &>(*track->getSequence()->getUnchecked(i));
-        if (const auto deletedComponent = this->componentsMap[note].get())
-        {
-            this->componentsMap.erase(note);
-        }
-    }
-}
-
-//===----------------------------------------------------------------------===//
-// Private
-//===----------------------------------------------------------------------===//
-
-void PianoClipComponent::reloadTrackMap()
-{
-    this->componentsMap.clear();
-
-    this->setVisible(false);
-
-    for (auto *track : this->project.getTracks())
+    if (track->getSequence() == this->sequence)
     {
-        if (track->getSequence() != this->sequence) { continue; }
-
-        for (int j = 0; j < track->getSequence()->size(); ++j)
-        {
-            MidiEvent *event = track->getSequence()->getUnchecked(j);
-
-            if (auto *note = dynamic_cast<Note *>(event))
-            {
-                auto noteComponent = new PianoSequenceMapNoteComponent(*note);
-                this->componentsMap[*note] = UniquePointer<PianoSequenceMapNoteComponent>(noteComponent);
-                this->addAndMakeVisible(noteComponent);
-            }
-        }
+        this->repaint();
     }
-
-    this->repositionAllChildren();
-    this->roll.triggerBatchRepaintFor(this);
-    this->setVisible(true);
 }
 
-void PianoClipComponent::applyNoteBounds(PianoSequenceMapNoteComponent *nc)
-{
-    const auto *ns = nc->getNote().getSequence();
-    const float sequenceLength = ns->getLengthInBeats();
-    const float beat = nc->getBeat() - ns->getFirstBeat();
-    const auto key = jlimit(0, 128, nc->getKey() + this->clip.getKey());
-    const float x = float(this->getWidth()) * (beat / sequenceLength);
-    const float w = float(this->getWidth()) * (nc->getLength() / sequenceLength);
-    const float h = float(this->getHeight());
-    const int y = int(h - key * h / 128.f);
-    nc->setRealBounds(x, y, jmax(1.f, w), 1);
-}
-
-void PianoClipComponent::repositionAllChildren()
-{
-    this->setVisible(false);
-
-    for (const auto &e : this->componentsMap)
-    {
-        this->applyNoteBounds(e.second.get());
-    }
-
-    this->setVisible(true);
-}
+void PianoClipComponent::onRemoveTrack(MidiTrack *const track) {}
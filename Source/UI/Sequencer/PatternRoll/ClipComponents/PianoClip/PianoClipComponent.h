@@ -17,10 +17,8 @@
 
 #pragma once
 
-#include "Note.h"
 #include "ClipComponent.h"
 #include "ProjectListener.h"
-#include "PianoSequenceMapNoteComponent.h"
 
 class HybridRoll;
 class MidiSequence;
@@ -39,7 +37,7 @@ public:
     // Component
     //===------------------------------------------------------------------===//
 
-    void resized() override;
+    void paint(Graphics &g) override;
 
     //===------------------------------------------------------------------===//
     // ProjectListener
@@ -63,15 +61,9 @@ public:
 
 private:
 
-    void applyNoteBounds(PianoSequenceMapNoteComponent *nc);
-    void reloadTrackMap();
-    void repositionAllChildren();
-
     HybridRoll &roll;
     ProjectTreeItem &project;
     WeakReference<MidiSequence> sequence;
 
-    SparseHashMap<Note, UniquePointer<PianoSequenceMapNoteComponent>, MidiEventHash> componentsMap;
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PianoClipComponent)
 };
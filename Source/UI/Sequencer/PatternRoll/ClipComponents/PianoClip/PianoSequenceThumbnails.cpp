@@ -0,0 +1,153 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "Common.h"
+#include "PianoSequenceThumbnails.h"
+#include "ProjectTreeItem.h"
+#include "MidiSequence.h"
+#include "MidiTrack.h"
+#include "Clip.h"
+
+PianoSequenceThumbnails::PianoSequenceThumbnails(ProjectTreeItem &project) :
+    project(project)
+{
+    this->project.addListener(this);
+}
+
+PianoSequenceThumbnails::~PianoSequenceThumbnails()
+{
+    this->project.removeListener(this);
+}
+
+void PianoSequenceThumbnails::paint(Graphics &g, const MidiSequence *sequence,
+    const Clip &clip, float width, float height)
+{
+    if (sequence == nullptr)
+    {
+        return;
+    }
+
+    const float sequenceLength = sequence->getLengthInBeats();
+    const float firstBeat = sequence->getFirstBeat();
+    if (sequenceLength <= 0.f)
+    {
+        return;
+    }
+
+    // the colour is expected to be set by the clip component,
+    // its alpha already depends on the clip velocity (see ClipComponent::updateColours)
+    for (const auto &v : this->getUpdatedThumbnail(sequence).vertices)
+    {
+        const float x = width * ((v.beat - firstBeat) / sequenceLength);
+        const float w = jmax(1.f, width * (v.length / sequenceLength));
+        const int key = jlimit(0, 128, v.key + clip.getKey());
+        const int y = int(height - key * height / 128.f);
+        g.drawHorizontalLine(y, x, x + w);
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// ProjectListener
+//===----------------------------------------------------------------------===//
+
+void PianoSequenceThumbnails::onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent &newEvent)
+{
+    if (oldEvent.isTypeOf(MidiEvent::Note))
+    {
+        this->setOutdated(newEvent.getSequence());
+    }
+}
+
+void PianoSequenceThumbnails::onAddMidiEvent(const MidiEvent &event)
+{
+    if (event.isTypeOf(MidiEvent::Note))
+    {
+        this->setOutdated(event.getSequence());
+    }
+}
+
+void PianoSequenceThumbnails::onRemoveMidiEvent(const MidiEvent &event)
+{
+    if (event.isTypeOf(MidiEvent::Note))
+    {
+        this->setOutdated(event.getSequence());
+    }
+}
+
+void PianoSequenceThumbnails::onAddTrack(MidiTrack *const track)
+{
+    // will be rebuilt on the next paint
+    this->thumbnails.erase(track->getSequence());
+}
+
+void PianoSequenceThumbnails::onRemoveTrack(MidiTrack *const track)
+{
+    this->thumbnails.erase(track->getSequence());
+}
+
+void PianoSequenceThumbnails::onReloadProjectContent(const Array<MidiTrack *> &tracks)
+{
+    this->thumbnails.clear();
+}
+
+//===----------------------------------------------------------------------===//
+// Private
+//===----------------------------------------------------------------------===//
+
+const PianoSequenceThumbnails::Thumbnail &
+PianoSequenceThumbnails::getUpdatedThumbnail(const MidiSequence *sequence)
+{
+    auto &slot = this->thumbnails[sequence];
+    if (slot == nullptr)
+    {
+        slot.reset(new Thumbnail());
+    }
+
+    auto &thumbnail = *slot;
+    if (thumbnail.isOutdated)
+    {
+        thumbnail.vertices.clearQuick();
+        thumbnail.vertices.ensureStorageAllocated(sequence->size());
+
+        for (int i = 0; i < sequence->size(); ++i)
+        {
+            if (const auto *note = dynamic_cast<const Note *>(sequence->getUnchecked(i)))
+            {
+                thumbnail.vertices.add(createVertex(*note));
+            }
+        }
+
+        thumbnail.isOutdated = false;
+    }
+
+    return thumbnail;
+}
+
+void PianoSequenceThumbnails::setOutdated(const MidiSequence *sequence)
+{
+    const auto found = this->thumbnails.find(sequence);
+    if (found != this->thumbnails.end())
+    {
+        found->second->isOutdated = true;
+    }
+}
+
+PianoSequenceThumbnails::NoteVertex PianoSequenceThumbnails::createVertex(const Note &note) noexcept
+{
+    return { note.getBeat(), note.getLength(), note.getKey() };
+}
@@ -0,0 +1,88 @@
+/*
+    This file is part of Helio Workstation.
+
+    Helio is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Helio is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Helio. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+class Clip;
+class MidiSequence;
+class ProjectTreeItem;
+
+#include "Note.h"
+#include "ProjectListener.h"
+
+// A single cached outline of notes per sequence, shared by all the clips
+// that instance that sequence; note changes only mark it outdated,
+// and it is rebuilt as one contiguous array of vertices on the next paint,
+// then drawn by each clip with its own key offset and colour.
+
+class PianoSequenceThumbnails final : public ProjectListener
+{
+public:
+
+    explicit PianoSequenceThumbnails(ProjectTreeItem &project);
+    ~PianoSequenceThumbnails() override;
+
+    void paint(Graphics &g, const MidiSequence *sequence,
+        const Clip &clip, float width, float height);
+
+    //===------------------------------------------------------------------===//
+    // ProjectListener
+    //===------------------------------------------------------------------===//
+
+    void onChangeMidiEvent(const MidiEvent &e1, const MidiEvent &e2) override;
+    void onAddMidiEvent(const MidiEvent &event) override;
+    void onRemoveMidiEvent(const MidiEvent &event) override;
+
+    void onAddClip(const Clip &clip) override {}
+    void onChangeClip(const Clip &oldClip, const Clip &newClip) override {}
+    void onRemoveClip(const Clip &clip) override {}
+
+    void onAddTrack(MidiTrack *const track) override;
+    void onRemoveTrack(MidiTrack *const track) override;
+    void onChangeTrackProperties(MidiTrack *const track) override {}
+
+    void onChangeProjectBeatRange(float firstBeat, float lastBeat) override {}
+    void onChangeViewBeatRange(float firstBeat, float lastBeat) override {}
+    void onReloadProjectContent(const Array<MidiTrack *> &tracks) override;
+
+private:
+
+    struct NoteVertex final
+    {
+        float beat;
+        float length;
+        int key;
+    };
+
+    struct Thumbnail final
+    {
+        Array<NoteVertex> vertices;
+        bool isOutdated = true;
+    };
+
+    const Thumbnail &getUpdatedThumbnail(const MidiSequence *sequence);
+    void setOutdated(const MidiSequence *sequence);
+
+    static NoteVertex createVertex(const Note &note) noexcept;
+
+    ProjectTreeItem &project;
+
+    SparseHashMap<const MidiSequence *, UniquePointer<Thumbnail>> thumbnails;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PianoSequenceThumbnails)
+};
@@ -41,6 +41,7 @@
 #include "SerializationKeys.h"
 #include "PianoSequence.h"
 #include "PianoClipComponent.h"
+#include "PianoSequenceThumbnails.h"
 #include "AutomationSequence.h"
 #include "AutomationCurveClipComponent.h"
 #include "AutomationStepsClipComponent.h"
@@ -78,6 +79,7 @@ PatternRoll::PatternRoll(ProjectTreeItem &parentProject,
 {
     // TODO: pattern roll doesn't need neither annotations track map nor key signatures track map
     this->selectedClipsMenuManager = new PatternRollSelectionMenuManager(&this->selection);
+    this->sequenceThumbnails = new PianoSequenceThumbnails(parentProject);
 
     this->setComponentID(ComponentIDs::patternRollId);
 
@@ -146,6 +148,7 @@ void PatternRoll::reloadRollContent()
         }
     }
 
+    this->updateTrackMeters();
     this->repaint(this->viewport.getViewArea());
 }
 
@@ -168,6 +171,18 @@ void PatternRoll::setChildrenInteraction(bool interceptsMouse, MouseCursor curso
     }
 }
 
+void PatternRoll::updateChildrenBounds()
+{
+    this->updateTrackMetersPositions();
+    HybridRoll::updateChildrenBounds();
+}
+
+void PatternRoll::updateChildrenPositions()
+{
+    this->updateTrackMetersPositions();
+    HybridRoll::updateChildrenPositions();
+}
+
 void PatternRoll::updateRollSize()
 {
     const int addTrackHelper = PATTERN_ROLL_TRACK_HEADER_HEIGHT;
@@ -189,7 +204,7 @@ void PatternRoll::showGhostClipFor(ClipComponent *targetClipComponent)
     this->ghostClips.add(component);
 
     this->batchRepaintList.add(component);
-    this->triggerAsyncUpdate();
+    this->requestFrame();
 }
 
 void PatternRoll::hideAllGhostClips()
@@ -202,6 +217,12 @@ void PatternRoll::hideAllGhostClips()
     this->ghostClips.clear();
 }
 
+PianoSequenceThumbnails &PatternRoll::getSequenceThumbnails() const noexcept
+{
+    jassert(this->sequenceThumbnails);
+    return *this->sequenceThumbnails;
+}
+
 //===----------------------------------------------------------------------===//
 // Clip management
 //===----------------------------------------------------------------------===//
@@ -291,6 +312,8 @@ void PatternRoll::onAddTrack(MidiTrack *const track)
         }
     }
 
+    this->updateTrackMeters();
+
     // Roll size might need to be changed
     this->updateRollSize();
 
@@ -326,6 +349,7 @@ void PatternRoll::onChangeTrackProperties(MidiTrack *const track)
         }
     }
 
+    this->updateTrackMeters();
     this->updateRollSize();
     this->resized();
 }
@@ -349,6 +373,7 @@ void PatternRoll::onRemoveTrack(MidiTrack *const track)
         }
     }
 
+    this->updateTrackMeters();
     this->updateRollSize();
     this->resized();
 }
@@ -365,7 +390,7 @@ void PatternRoll::onAddClip(const Clip &clip)
         this->fader.fadeIn(clipComponent, 150);
 
         this->batchRepaintList.add(clipComponent);
-        this->triggerAsyncUpdate();
+        this->requestFrame();
 
         if (this->addNewClipMode)
         {
@@ -383,8 +408,13 @@ void PatternRoll::onChangeClip(const Clip &clip, const Clip &newClip)
         this->clipComponents.erase(clip);
         this->clipComponents[newClip] = UniquePointer<ClipComponent>(component);
 
+        if (component->isSelected())
+        {
+            this->selection.itemChanged(component);
+        }
+
         this->batchRepaintList.add(component);
-        this->triggerAsyncUpdate();
+        this->requestFrame();
     }
 }
 
@@ -404,6 +434,7 @@ void PatternRoll::onPostRemoveClip(Pattern *const pattern) {}
 
 void PatternRoll::onReloadProjectContent(const Array<MidiTrack *> &tracks)
 {
+    this->beatLinesCacheOutdated = true;
     this->reloadRollContent();
 }
 
@@ -651,6 +682,7 @@ void PatternRoll::resized()
         this->knifeToolHelper->updateBounds(true);
     }
 
+    this->updateTrackMetersPositions();
     HybridRoll::resized();
 
     HYBRID_ROLL_BULK_REPAINT_END
@@ -779,6 +811,43 @@ void PatternRoll::deserialize(const ValueTree &tree)
 
 void PatternRoll::reset() {}
 
+//===----------------------------------------------------------------------===//
+// Track meters
+//===----------------------------------------------------------------------===//
+
+void PatternRoll::updateTrackMeters()
+{
+    while (this->trackMeters.size() > this->tracks.size())
+    {
+        this->trackMeters.removeLast();
+    }
+
+    while (this->trackMeters.size() < this->tracks.size())
+    {
+        auto *meter = this->trackMeters.add(new LevelMeterComponent());
+        this->addAndMakeVisible(meter);
+    }
+
+    for (int i = 0; i < this->tracks.size(); ++i)
+    {
+        this->trackMeters.getUnchecked(i)->setInstrumentId(this->tracks.getUnchecked(i)->getTrackInstrumentId());
+    }
+
+    this->updateTrackMetersPositions();
+}
+
+// Meters stick to the left edge of the visible area
+void PatternRoll::updateTrackMetersPositions()
+{
+    const int viewX = this->viewport.getViewPositionX();
+    for (int i = 0; i < this->trackMeters.size(); ++i)
+    {
+        const int y = HYBRID_ROLL_HEADER_HEIGHT + i * rowHeight();
+        this->trackMeters.getUnchecked(i)->setBounds(viewX, y,
+            PATTERN_ROLL_TRACK_METER_WIDTH, PATTERN_ROLL_TRACK_HEADER_HEIGHT);
+    }
+}
+
 //===----------------------------------------------------------------------===//
 // Background image cache
 //===----------------------------------------------------------------------===//
@@ -19,9 +19,11 @@
 
 #define PATTERN_ROLL_CLIP_HEIGHT 60
 #define PATTERN_ROLL_TRACK_HEADER_HEIGHT 4
+#define PATTERN_ROLL_TRACK_METER_WIDTH 96
 
 class CutPointMark;
 class ClipComponent;
+class PianoSequenceThumbnails;
 class PatternRollSelectionMenuManager;
 
 #include "HelioTheme.h"
@@ -29,6 +31,7 @@ class PatternRollSelectionMenuManager;
 #include "MidiTrack.h"
 #include "Pattern.h"
 #include "Clip.h"
+#include "LevelMeterComponent.h"
 
 class PatternRoll final : public HybridRoll
 {
@@ -48,6 +51,8 @@ public:
     void showGhostClipFor(ClipComponent *targetClipComponent);
     void hideAllGhostClips();
 
+    PianoSequenceThumbnails &getSequenceThumbnails() const noexcept;
+
     //===------------------------------------------------------------------===//
     // Note management
     //===------------------------------------------------------------------===//
@@ -123,6 +128,8 @@ protected:
     //===------------------------------------------------------------------===//
 
     void setChildrenInteraction(bool interceptsMouse, MouseCursor c) override;
+    void updateChildrenBounds() override;
+    void updateChildrenPositions() override;
     void updateRollSize();
 
 public:
@@ -154,8 +161,16 @@ private:
 
     OwnedArray<ClipComponent> ghostClips;
 
+    // Instrument level meters in the track headers, in the same order as tracks
+    OwnedArray<LevelMeterComponent> trackMeters;
+    void updateTrackMeters();
+    void updateTrackMetersPositions();
+
     ScopedPointer<PatternRollSelectionMenuManager> selectedClipsMenuManager;
 
+    // Needs to outlive the clip components
+    ScopedPointer<PianoSequenceThumbnails> sequenceThumbnails;
+
     using ClipComponentsMap = SparseHashMap<const Clip, UniquePointer<ClipComponent>, ClipHash>;
     ClipComponentsMap clipComponents;
 
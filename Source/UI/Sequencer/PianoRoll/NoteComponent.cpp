@@ -19,6 +19,7 @@
 #include "NoteComponent.h"
 #include "PianoSequence.h"
 #include "PianoRoll.h"
+#include "Lasso.h"
 #include "ProjectTreeItem.h"
 #include "MidiSequence.h"
 #include "MidiTrack.h"
@@ -38,6 +39,14 @@ static PianoSequence *getPianoSequence(SelectionProxyArray::Ptr selection)
     return static_cast<PianoSequence *>(firstEvent.getSequence());;
 }
 
+static bool hasSameParameters(const Note &a, const Note &b) noexcept
+{
+    return a.getKey() == b.getKey() &&
+        a.getBeat() == b.getBeat() &&
+        a.getLength() == b.getLength() &&
+        a.getVelocity() == b.getVelocity();
+}
+
 NoteComponent::NoteComponent(PianoRoll &editor, const Note &event, const Clip &clip, bool ghostMode) :
     MidiEventComponent(editor, ghostMode),
     note(event),
@@ -45,6 +54,8 @@ NoteComponent::NoteComponent(PianoRoll &editor, const Note &event, const Clip &c
     state(None),
     anchor(event),
     groupScalingAnchor(event),
+    preview(event),
+    hasPreview(false),
     firstChangeDone(false)
 {
     this->updateColours();
@@ -102,12 +113,110 @@ void NoteComponent::setQuickSelectLayerMode(bool value)
     }
 }
 
+//===----------------------------------------------------------------------===//
+// Previews
+//===----------------------------------------------------------------------===//
+
+void NoteComponent::commitPreviews(const Lasso &selection)
+{
+    for (const auto &s : selection.getGroupedSelections())
+    {
+        const auto trackSelection(s.second);
+        Array<Note> groupBefore, groupAfter;
+
+        for (int i = 0; i < trackSelection->size(); ++i)
+        {
+            auto *nc = static_cast<NoteComponent *>(trackSelection->getUnchecked(i));
+            if (nc->hasPreview)
+            {
+                if (!hasSameParameters(nc->getNote(), nc->preview))
+                {
+                    groupBefore.add(nc->getNote());
+                    groupAfter.add(nc->preview);
+                }
+
+                // The sequence will send a change event, which updates the bounds:
+                nc->hasPreview = false;
+            }
+        }
+
+        if (groupBefore.isEmpty())
+        {
+            continue;
+        }
+
+        getPianoSequence(trackSelection)->changeGroup(groupBefore, groupAfter, true);
+    }
+}
+
+void NoteComponent::cancelPreviews(const Lasso &selection)
+{
+    for (int i = 0; i < selection.getNumSelected(); ++i)
+    {
+        if (auto *nc = dynamic_cast<NoteComponent *>(selection.getSelectedItem(i)))
+        {
+            if (nc->state != None)
+            {
+                nc->getRoll().hideAllGhostNotes();
+                nc->getRoll().hideHelpers();
+                nc->resetPreview();
+                nc->state = None;
+            }
+        }
+    }
+}
+
+void NoteComponent::setPreview(const Note &newParams)
+{
+    // The drag was cancelled by undo or deselection, ignore the rest of it
+    if (this->state == None)
+    {
+        return;
+    }
+
+    const bool wasVisible = this->isVisibleInRoll();
+
+    this->preview = newParams;
+    this->hasPreview = true;
+
+    // Components out of view are not moved, unless they are about to get into view;
+    // all of them get their final bounds from the change events on commit
+    if (wasVisible || this->isVisibleInRoll())
+    {
+        this->roll.triggerBatchRepaintFor(this);
+    }
+}
+
+void NoteComponent::resetPreview()
+{
+    if (this->hasPreview)
+    {
+        this->hasPreview = false;
+        this->roll.triggerBatchRepaintFor(this);
+    }
+}
+
+bool NoteComponent::isVisibleInRoll() const
+{
+    const auto viewArea = this->roll.getViewport().getViewArea().toFloat();
+    return viewArea.intersects(this->getRoll().getEventBounds(this->getKey() + this->clip.getKey(),
+        this->getBeat() + this->clip.getBeat(), this->getLength()));
+}
+
 //===----------------------------------------------------------------------===//
 // MidiEventComponent
 //===----------------------------------------------------------------------===//
 
 void NoteComponent::setSelected(bool selected)
 {
+    // A note that leaves the selection mid-drag drops its pending changes,
+    // since they are only committed for the selected ones:
+    if (!selected && this->state != None)
+    {
+        this->resetPreview();
+        this->state = None;
+    }
+
     MidiEventComponent::setSelected(selected);
 }
 
@@ -161,9 +270,19 @@ void NoteComponent::mouseMove(const MouseEvent &e)
     }
 }
 
-#define forEachSelectedNote(lasso, child) \
-    for (int _i = 0; _i < lasso.getNumSelected(); _i++) \
-        if (auto *child = dynamic_cast<NoteComponent *>(lasso.getSelectedItem(_i)))
+// The piano roll's selection only contains note components
+template<typename Callback>
+static void forEachSelectedNote(const Lasso &selection, Callback callback)
+{
+    for (const auto &s : selection.getGroupedSelections())
+    {
+        const auto trackSelection(s.second);
+        for (int i = 0; i < trackSelection->size(); ++i)
+        {
+            callback(trackSelection->getItemAs<NoteComponent>(i));
+        }
+    }
+}
 
 void NoteComponent::mouseDown(const MouseEvent &e)
 {
@@ -213,19 +332,19 @@ void NoteComponent::mouseDown(const MouseEvent &e)
             if (e.mods.isShiftDown())
             {
                 const float groupStartBeat = SequencerOperations::findStartBeat(selection);
-                forEachSelectedNote(selection, note)
+                forEachSelectedNote(selection, [&](NoteComponent *note)
                 {
                     if (selection.shouldDisplayGhostNotes()) { note->getRoll().showGhostNoteFor(note); }
                     note->startGroupScalingRight(groupStartBeat);
-                }
+                });
             }
             else
             {
-                forEachSelectedNote(selection, note)
+                forEachSelectedNote(selection, [&](NoteComponent *note)
                 {
                     if (selection.shouldDisplayGhostNotes()) { note->getRoll().showGhostNoteFor(note); }
                     note->startResizingRight(shouldSendMidi);
-                }
+                });
             }
         }
         else if (this->canResize() && e.x <= RESIZE_CORNER)
@@ -233,29 +352,29 @@ void NoteComponent::mouseDown(const MouseEvent &e)
             if (e.mods.isShiftDown())
             {
                 const float groupEndBeat = SequencerOperations::findEndBeat(selection);
-                forEachSelectedNote(selection, note)
+                forEachSelectedNote(selection, [&](NoteComponent *note)
                 {
                     if (selection.shouldDisplayGhostNotes()) { note->getRoll().showGhostNoteFor(note); }
                     note->startGroupScalingLeft(groupEndBeat);
-                }
+                });
             }
             else
             {
-                forEachSelectedNote(selection, note)
+                forEachSelectedNote(selection, [&](NoteComponent *note)
                 {
                     if (selection.shouldDisplayGhostNotes()) { note->getRoll().showGhostNoteFor(note); }
                     note->startResizingLeft(shouldSendMidi);
-                }
+                });
             }
         }
         else
         {
             this->dragger.startDraggingComponent(this, e);
-            forEachSelectedNote(selection, note)
+            forEachSelectedNote(selection, [&](NoteComponent *note)
             {
                 if (selection.shouldDisplayGhostNotes()) { note->getRoll().showGhostNoteFor(note); }
                 note->startDragging(shouldSendMidi);
-            }
+            });
         }
 
         //DBG("Note: " + String(note) + " " + String(beat) + " " + String(length));
@@ -263,10 +382,10 @@ void NoteComponent::mouseDown(const MouseEvent &e)
     else if (e.mods.isMiddleButtonDown())
     {
         this->setMouseCursor(MouseCursor::UpDownResizeCursor);
-        forEachSelectedNote(selection, note)
+        forEachSelectedNote(selection, [&](NoteComponent *note)
         {
             note->startTuning();
-        }
+        });
     }
 }
 
@@ -317,20 +436,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
                 this->stopSound();
             }
 
-            for (const auto &s : selection.getGroupedSelections())
+            forEachSelectedNote(selection, [&](NoteComponent *nc)
             {
-                const auto trackSelection(s.second);
-                Array<Note> groupBefore, groupAfter;
-
-                for (int i = 0; i < trackSelection->size(); ++i)
-                {
-                    const auto *nc = static_cast<NoteComponent *>(trackSelection->getUnchecked(i));
-                    groupBefore.add(nc->getNote());
-                    groupAfter.add(nc->continueInitializing(deltaLength, deltaKey, shouldSendMidi));
-                }
-
-                getPianoSequence(trackSelection)->changeGroup(groupBefore, groupAfter, true);
-            }
+                nc->setPreview(nc->continueInitializing(deltaLength, deltaKey, shouldSendMidi));
+            });
         }
         else
         {
@@ -345,20 +454,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
         if (lengthChanged)
         {
             this->checkpointIfNeeded();
-            for (const auto &s : selection.getGroupedSelections())
+            forEachSelectedNote(selection, [&](NoteComponent *nc)
             {
-                const auto trackSelection(s.second);
-                Array<Note> groupBefore, groupAfter;
-                
-                for (int i = 0; i < trackSelection->size(); ++i)
-                {
-                    const auto *nc = static_cast<NoteComponent *>(trackSelection->getUnchecked(i));
-                    groupBefore.add(nc->getNote());
-                    groupAfter.add(nc->continueResizingRight(deltaLength));
-                }
-                
-                getPianoSequence(trackSelection)->changeGroup(groupBefore, groupAfter, true);
-            }
+                nc->setPreview(nc->continueResizingRight(deltaLength));
+            });
         }
         else
         {
@@ -373,20 +472,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
         if (lengthChanged)
         {
             this->checkpointIfNeeded();
-            for (const auto &s : selection.getGroupedSelections())
+            forEachSelectedNote(selection, [&](NoteComponent *nc)
             {
-                const auto trackSelection(s.second);
-                Array<Note> groupBefore, groupAfter;
-                
-                for (int i = 0; i < trackSelection->size(); ++i)
-                {
-                    const auto *nc = static_cast<NoteComponent *>(trackSelection->getUnchecked(i));
-                    groupBefore.add(nc->getNote());
-                    groupAfter.add(nc->continueResizingLeft(deltaLength));
-                }
-                
-                getPianoSequence(trackSelection)->changeGroup(groupBefore, groupAfter, true);
-            }
+                nc->setPreview(nc->continueResizingLeft(deltaLength));
+            });
         }
         else
         {
@@ -401,20 +490,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
         if (scaleFactorChanged)
         {
             this->checkpointIfNeeded();
-            for (const auto &s : selection.getGroupedSelections())
+            forEachSelectedNote(selection, [&](NoteComponent *nc)
             {
-                const auto trackSelection(s.second);
-                Array<Note> groupBefore, groupAfter;
-                
-                for (int i = 0; i < trackSelection->size(); ++i)
-                {
-                    const auto *nc = static_cast<NoteComponent *>(trackSelection->getUnchecked(i));
-                    groupBefore.add(nc->getNote());
-                    groupAfter.add(nc->continueGroupScalingRight(groupScaleFactor));
-                }
-                
-                getPianoSequence(trackSelection)->changeGroup(groupBefore, groupAfter, true);
-            }
+                nc->setPreview(nc->continueGroupScalingRight(groupScaleFactor));
+            });
         }
         else
         {
@@ -429,20 +508,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
         if (scaleFactorChanged)
         {
             this->checkpointIfNeeded();
-            for (const auto &s : selection.getGroupedSelections())
+            forEachSelectedNote(selection, [&](NoteComponent *nc)
             {
-                const auto trackSelection(s.second);
-                Array<Note> groupBefore, groupAfter;
-                
-                for (int i = 0; i < trackSelection->size(); ++i)
-                {
-                    const auto *nc = static_cast<NoteComponent *>(trackSelection->getUnchecked(i));
-                    groupBefore.add(nc->getNote());
-                    groupAfter.add(nc->continueGroupScalingLeft(groupScaleFactor));
-                }
-                
-                getPianoSequence(trackSelection)->changeGroup(groupBefore, groupAfter, true);
-            }
+                nc->setPreview(nc->continueGroupScalingLeft(groupScaleFactor));
+            });
         }
         else
         {
@@ -488,10 +557,10 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
                 this->getRoll().hideAllGhostNotes();
 
                 // Finally, bring selection back to front
-                forEachSelectedNote(selection, noteComponent)
+                forEachSelectedNote(selection, [&](NoteComponent *noteComponent)
                 {
                     noteComponent->toFront(false);
-                }
+                });
             }
 
             this->getRoll().moveHelpers(deltaBeat, deltaKey);
@@ -501,41 +570,21 @@ void NoteComponent::mouseDrag(const MouseEvent &e)
                 this->stopSound();
             }
             
-            for (const auto &s : selection.getGroupedSelections())
+            forEachSelectedNote(selection, [&](NoteComponent *nc)
             {
-                const auto trackSelection(s.second);
-                Array<Note> groupBefore, groupAfter;
-                
-                for (int i = 0; i < trackSelection->size(); ++i)
-                {
-                    const auto *nc = static_cast<NoteComponent *>(trackSelection->getUnchecked(i));
-                    groupBefore.add(nc->getNote());
-                    groupAfter.add(nc->continueDragging(deltaBeat, deltaKey, shouldSendMidi));
-                }
-                
-                getPianoSequence(trackSelection)->changeGroup(groupBefore, groupAfter, true);
-            }
+                nc->setPreview(nc->continueDragging(deltaBeat, deltaKey, shouldSendMidi));
+            });
         }
     }
     else if (this->state == Tuning)
     {
         this->checkpointIfNeeded();
         
-        for (const auto &s : selection.getGroupedSelections())
+        forEachSelectedNote(selection, [&](NoteComponent *nc)
         {
-            const auto trackSelection(s.second);
-            Array<Note> groupBefore, groupAfter;
-            
-            for (int i = 0; i < trackSelection->size(); ++i)
-            {
-                const auto *nc = static_cast<NoteComponent *>(trackSelection->getUnchecked(i));
-                groupBefore.add(nc->getNote());
-                groupAfter.add(nc->continueTuning(e));
-                this->getRoll().setDefaultNoteVolume(groupAfter.getLast().getVelocity());
-            }
-            
-            getPianoSequence(trackSelection)->changeGroup(groupBefore, groupAfter, true);
-        }
+            nc->setPreview(nc->continueTuning(e));
+            this->getRoll().setDefaultNoteVolume(nc->getVelocity());
+        });
     }
 }
 
@@ -568,6 +617,7 @@ void NoteComponent::mouseUp(const MouseEvent &e)
 #endif
     
     const Lasso &selection = this->roll.getLassoSelection();
+    commitPreviews(selection);
 
     if (this->state == Initializing)
     {
@@ -669,8 +719,8 @@ void NoteComponent::paint(Graphics &g)
 //#else
     const float sx = x1 + 2.f;
     const float sy = float(this->getHeight() - 4);
-    const float sw1 = jmax(0.f, (w - 4.f)) * this->note.getVelocity();
-    const float sw2 = jmax(0.f, (w - 4.f)) * this->note.getVelocity() * this->clip.getVelocity();
+    const float sw1 = jmax(0.f, (w - 4.f)) * this->getVelocity();
+    const float sw2 = jmax(0.f, (w - 4.f)) * this->getVelocity() * this->clip.getVelocity();
     g.setColour(this->colourVolume);
     g.fillRect(sx, sy, sw1, 3.f);
     g.fillRect(sx, sy, sw2, 3.f);
@@ -19,6 +19,7 @@
 
 class PianoRoll;
 class MidiTrack;
+class Lasso;
 
 #include "MidiEventComponent.h"
 #include "Note.h"
@@ -47,9 +48,9 @@ public:
     // Helpers
     //===------------------------------------------------------------------===//
 
-    inline int getKey() const noexcept { return this->note.getKey(); }
-    inline float getLength() const noexcept { return this->note.getLength(); }
-    inline float getVelocity() const noexcept { return this->note.getVelocity(); }
+    inline int getKey() const noexcept { return this->getDisplayedNote().getKey(); }
+    inline float getLength() const noexcept { return this->getDisplayedNote().getLength(); }
+    inline float getVelocity() const noexcept { return this->getDisplayedNote().getVelocity(); }
     inline const Note &getNote() const noexcept { return this->note; }
     inline const Clip &getClip() const noexcept { return this->clip; }
 
@@ -57,6 +58,15 @@ public:
 
     void updateColours() override;
 
+    //===------------------------------------------------------------------===//
+    // Previews
+    //===------------------------------------------------------------------===//
+
+    // While notes are dragged, resized or tuned, the changes are only displayed
+    // by their components, and each sequence gets a single change group on mouse up
+    static void commitPreviews(const Lasso &selection);
+    static void cancelPreviews(const Lasso &selection);
+
     //===------------------------------------------------------------------===//
     // MidiEventComponent
     //===------------------------------------------------------------------===//
@@ -64,7 +74,7 @@ public:
     void setSelected(bool selected) override;
     const String &getSelectionGroupId() const noexcept override;
     const String &getId() const noexcept override { return this->note.getId(); }
-    float getBeat() const noexcept override { return this->note.getBeat(); }
+    float getBeat() const noexcept override { return this->getDisplayedNote().getBeat(); }
 
     //===------------------------------------------------------------------===//
     // Component
@@ -87,6 +97,18 @@ protected:
     Note anchor;
     Note groupScalingAnchor;
 
+    Note preview;
+    bool hasPreview;
+
+    inline const Note &getDisplayedNote() const noexcept
+    {
+        return this->hasPreview ? this->preview : this->note;
+    }
+
+    void setPreview(const Note &newParams);
+    void resetPreview();
+    bool isVisibleInRoll() const;
+
     bool belongsTo(const WeakReference<MidiTrack> &track, const Clip &clip) const noexcept;
     void switchActiveSegmentToSelected(bool zoomToScope) const;
 
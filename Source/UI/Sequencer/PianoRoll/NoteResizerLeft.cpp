@@ -149,21 +149,10 @@ void NoteResizerLeft::mouseDrag (const MouseEvent& e)
     if (scaleFactorChanged)
     {
         this->noteComponent->checkpointIfNeeded();
-        for (const auto &s : selection.getGroupedSelections())
+        for (int i = 0; i < selection.getNumSelected(); ++i)
         {
-            const auto sequenceSelection(s.second);
-            Array<Note> groupDragBefore, groupDragAfter;
-
-            for (int i = 0; i < selection.getNumSelected(); ++i)
-            {
-                NoteComponent *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
-                groupDragBefore.add(nc->getNote());
-                groupDragAfter.add(nc->continueGroupScalingLeft(groupScaleFactor));
-            }
-
-            const auto &event = sequenceSelection->getFirstAs<NoteComponent>()->getNote();
-            PianoSequence *pianoLayer = static_cast<PianoSequence *>(event.getSequence());
-            pianoLayer->changeGroup(groupDragBefore, groupDragAfter, true);
+            auto *nc = static_cast<NoteComponent *>(selection.getSelectedItem(i));
+            nc->setPreview(nc->continueGroupScalingLeft(groupScaleFactor));
         }
     }
 
@@ -175,6 +164,7 @@ void NoteResizerLeft::mouseUp (const MouseEvent& e)
 {
     //[UserCode_mouseUp] -- Add your code here...
     const Lasso &selection = this->roll.getLassoSelection();
+    NoteComponent::commitPreviews(selection);
 
     for (int i = 0; i < selection.getNumSelected(); i++)
     {
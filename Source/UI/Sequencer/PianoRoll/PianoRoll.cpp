@@ -26,6 +26,7 @@
 #include "Pattern.h"
 #include "MidiSequence.h"
 #include "PianoSequence.h"
+#include "Profiler.h"
 #include "AutomationSequence.h"
 #include "AnnotationsSequence.h"
 #include "PianoTrackTreeItem.h"
@@ -63,6 +64,10 @@
 #define ROWS_OF_TWO_OCTAVES 24
 #define DEFAULT_NOTE_LENGTH 0.25f
 
+// Inactive clips are drawn from cached paths, these are in rows
+#define GHOST_NOTE_MARGIN 0.2f
+#define GHOST_NOTE_HEIGHT 0.6f
+
 #define forEachEventOfGivenTrack(map, child, track) \
     for (const auto &_c : map) \
         if (_c.first.getPattern()->getTrack() == track) \
@@ -110,6 +115,8 @@ void PianoRoll::reloadRollContent()
     this->selection.deselectAll();
     this->backgroundsCache.clear();
     this->patternMap.clear();
+    this->ghostLayers.clear();
+    this->beatLinesCacheOutdated = true;
 
     HYBRID_ROLL_BULK_REPAINT_START
 
@@ -145,27 +152,84 @@ void PianoRoll::loadTrack(const MidiTrack *const track)
     for (int i = 0; i < track->getPattern()->size(); ++i)
     {
         const Clip *clip = track->getPattern()->getUnchecked(i);
+        if (*clip == this->activeClip)
+        {
+            this->loadClip(*clip);
+        }
+    }
+}
 
-        auto sequenceMap = new SequenceMap();
-        this->patternMap[*clip] = UniquePointer<SequenceMap>(sequenceMap);
+void PianoRoll::loadClip(const Clip &clip)
+{
+    if (this->patternMap.contains(clip))
+    {
+        return;
+    }
 
-        for (int j = 0; j < track->getSequence()->size(); ++j)
+    const auto *track = clip.getPattern()->getTrack();
+
+    auto sequenceMap = new SequenceMap();
+    this->patternMap[clip] = UniquePointer<SequenceMap>(sequenceMap);
+
+    for (int j = 0; j < track->getSequence()->size(); ++j)
+    {
+        const MidiEvent *event = track->getSequence()->getUnchecked(j);
+        if (event->isTypeOf(MidiEvent::Note))
         {
-            const MidiEvent *event = track->getSequence()->getUnchecked(j);
-            if (event->isTypeOf(MidiEvent::Note))
-            {
-                const Note *note = static_cast<const Note *>(event);
-                auto nc = new NoteComponent(*this, *note, *clip);
-                (*sequenceMap)[*note] = UniquePointer<NoteComponent>(nc);
-                const bool isActive = nc->belongsTo(this->activeTrack, this->activeClip);
-                nc->setActive(isActive, true);
-                this->addAndMakeVisible(nc);
-                nc->setFloatBounds(this->getEventBounds(nc));
-            }
+            const Note *note = static_cast<const Note *>(event);
+            auto nc = new NoteComponent(*this, *note, clip);
+            (*sequenceMap)[*note] = UniquePointer<NoteComponent>(nc);
+            const bool isActive = nc->belongsTo(this->activeTrack, this->activeClip);
+            nc->setActive(isActive, true);
+            this->addAndMakeVisible(nc);
+            nc->setFloatBounds(this->getEventBounds(nc));
+        }
+    }
+}
+
+void PianoRoll::updateActiveClipComponents()
+{
+    Array<Clip> clipsToUnload;
+    for (const auto &c : this->patternMap)
+    {
+        if (!(c.first == this->activeClip))
+        {
+            clipsToUnload.add(c.first);
+        }
+    }
+
+    for (const auto &clip : clipsToUnload)
+    {
+        this->patternMap.erase(clip);
+    }
+
+    if (this->activeTrack == nullptr || this->patternMap.contains(this->activeClip))
+    {
+        return;
+    }
+
+    if (const auto *pattern = this->activeTrack->getPattern())
+    {
+        const int i = pattern->indexOfSorted(&this->activeClip);
+        if (i >= 0)
+        {
+            // note components keep the reference to the pattern's own clip
+            this->loadClip(*pattern->getUnchecked(i));
+            this->applyEditModeUpdates(); // update behaviour of newly created note components
         }
     }
 }
 
+Range<float> PianoRoll::getVisibleBeatRange(float marginInScreens) const
+{
+    const float viewWidth = float(this->viewport.getViewWidth());
+    const float viewX = float(this->viewport.getViewPositionX());
+    const float margin = viewWidth * marginInScreens;
+    const float beatWidth = this->getBarWidth() / float(BEATS_PER_BAR);
+    return { this->getFirstBeat() + (viewX - margin) / beatWidth,
+        this->getFirstBeat() + (viewX + viewWidth + margin) / beatWidth };
+}
+
 void PianoRoll::setEditableScope(WeakReference<MidiTrack> activeTrack, 
     const Clip &activeClip, bool shouldZoomToArea)
 {
@@ -173,6 +237,10 @@ void PianoRoll::setEditableScope(WeakReference<MidiTrack> activeTrack,
 
     this->activeTrack = activeTrack;
     this->activeClip = activeClip;
+    this->setQuickSelectClip({});
+
+    // only the active clip has note components, the others are drawn as layers
+    this->updateActiveClipComponents();
 
     int focusMinKey = INT_MAX;
     int focusMaxKey = 0;
@@ -279,7 +347,7 @@ void PianoRoll::showGhostNoteFor(NoteComponent *target)
     this->ghostNotes.add(component);
 
     this->batchRepaintList.add(component);
-    this->triggerAsyncUpdate();
+    this->requestFrame();
 }
 
 void PianoRoll::hideAllGhostNotes()
@@ -484,11 +552,19 @@ void PianoRoll::onChangeMidiEvent(const MidiEvent &oldEvent, const MidiEvent &ne
                 jassert(!sequenceMap.contains(newNote));
                 // Always erase before updating, as it may happen both events have the same hash code:
                 sequenceMap[newNote] = UniquePointer<NoteComponent>(component);
+                // Keep selection's ordering and aggregates up to date:
+                if (component->isSelected())
+                {
+                    this->selection.itemChanged(component);
+                }
                 // Schedule to be repainted later:
                 this->batchRepaintList.add(component);
-                this->triggerAsyncUpdate();
+                this->requestFrame();
             }
         }
+
+        this->invalidateGhostLayer(note);
+        this->invalidateGhostLayer(newNote);
     }
     else if (oldEvent.isTypeOf(MidiEvent::KeySignature))
     {
@@ -531,7 +607,7 @@ void PianoRoll::onAddMidiEvent(const MidiEvent &event)
             component->setActive(isActive);
 
             this->batchRepaintList.add(component);
-            this->triggerAsyncUpdate(); // instead of updateBounds
+            this->requestFrame(); // instead of updateBounds
 
             if (this->addNewNoteMode && isActive)
             {
@@ -540,6 +616,8 @@ void PianoRoll::onAddMidiEvent(const MidiEvent &event)
                 this->selectEvent(this->newNoteDragging, true); // clear prev selection
             }
         }
+
+        this->invalidateGhostLayer(note);
     }
     else if (event.isTypeOf(MidiEvent::KeySignature))
     {
@@ -573,6 +651,8 @@ void PianoRoll::onRemoveMidiEvent(const MidiEvent &event)
                 sequenceMap.erase(note);
             }
         }
+
+        this->invalidateGhostLayer(note);
     }
     else if (event.isTypeOf(MidiEvent::KeySignature))
     {
@@ -586,40 +666,8 @@ void PianoRoll::onRemoveMidiEvent(const MidiEvent &event)
 
 void PianoRoll::onAddClip(const Clip &clip)
 {
-    const SequenceMap *referenceMap = nullptr;
-    const auto *track = clip.getPattern()->getTrack();
-
-    forEachSequenceMapOfGivenTrack(this->patternMap, c, track)
-    {
-        // Found a sequence map for the same track
-        referenceMap = c.second.get();
-        break;
-    }
-
-    if (referenceMap == nullptr)
-    {
-        jassertfalse;
-        return;
-    }
-
-    auto sequenceMap = new SequenceMap();
-    this->patternMap[clip] = UniquePointer<SequenceMap>(sequenceMap);
-
-    for (const auto &e : *referenceMap)
-    {
-        // reference the same note as neighbor components:
-        const auto &note = e.second.get()->getNote();
-        auto component = new NoteComponent(*this, note, clip);
-        (*sequenceMap)[note] = UniquePointer<NoteComponent>(component);
-        this->addAndMakeVisible(component);
-
-        const bool isActive = component->belongsTo(this->activeTrack, this->activeClip);
-        component->setActive(isActive);
-
-        this->batchRepaintList.add(component);
-    }
-
-    this->triggerAsyncUpdate();
+    // new clips are never active, so they are just drawn as layers
+    this->repaintClipArea(clip);
 }
 
 void PianoRoll::onChangeClip(const Clip &clip, const Clip &newClip)
@@ -629,7 +677,12 @@ void PianoRoll::onChangeClip(const Clip &clip, const Clip &newClip)
         this->activeClip = newClip;
     }
 
-    if (auto *sequenceMap = this->patternMap[clip].release())
+    if (!this->patternMap.contains(clip))
+    {
+        this->repaintClipArea(clip);
+        this->repaintClipArea(newClip);
+    }
+    else if (auto *sequenceMap = this->patternMap[clip].release())
     {
         // Set new key for existing sequence map
         this->patternMap.erase(clip);
@@ -647,7 +700,7 @@ void PianoRoll::onChangeClip(const Clip &clip, const Clip &newClip)
         }
 
         // Schedule batch repaint
-        this->triggerAsyncUpdate();
+        this->requestFrame();
     }
 }
 
@@ -655,10 +708,20 @@ void PianoRoll::onRemoveClip(const Clip &clip)
 {
     HYBRID_ROLL_BULK_REPAINT_START
 
+    if (this->quickSelectClip == clip)
+    {
+        this->setQuickSelectClip({});
+    }
+
     if (this->patternMap.contains(clip))
     {
         this->patternMap.erase(clip);
     }
+    else
+    {
+        // inactive clips have no components, just their ghost layer drawn
+        this->repaintClipArea(clip);
+    }
 
     HYBRID_ROLL_BULK_REPAINT_END
 }
@@ -683,6 +746,7 @@ void PianoRoll::onAddTrack(MidiTrack *const track)
     HYBRID_ROLL_BULK_REPAINT_START
 
     this->loadTrack(track);
+    this->ghostLayers.erase(track->getSequence());
 
     for (int j = 0; j < track->getSequence()->size(); ++j)
     {
@@ -726,6 +790,8 @@ void PianoRoll::onRemoveTrack(MidiTrack *const track)
         }
     }
 
+    this->ghostLayers.erase(track->getSequence());
+
     this->repaint();
 }
 
@@ -798,6 +864,21 @@ void PianoRoll::mouseDown(const MouseEvent &e)
         return;
     }
     
+    // the inactive notes are not components, so they're hit-tested here
+    if (e.mods.isAltDown() || e.mods.isRightButtonDown())
+    {
+        MidiTrack *track = nullptr;
+        if (const auto *clip = this->findGhostClipAt(e.position, track))
+        {
+            const bool zoomToScope = e.mods.isAnyModifierKeyDown();
+            this->project.setEditableScope(track, *clip, zoomToScope);
+            if (zoomToScope)
+            {
+                this->zoomOutImpulse(0.5f);
+            }
+        }
+    }
+
     if (! this->isUsingSpaceDraggingMode())
     {
         this->setInterceptsMouseClicks(true, false);
@@ -855,6 +936,24 @@ void PianoRoll::mouseDrag(const MouseEvent &e)
     HybridRoll::mouseDrag(e);
 }
 
+void PianoRoll::mouseMove(const MouseEvent &e)
+{
+    this->updateQuickSelectClip(e.position, e.mods);
+    HybridRoll::mouseMove(e);
+}
+
+void PianoRoll::mouseExit(const MouseEvent &e)
+{
+    this->setQuickSelectClip({});
+    HybridRoll::mouseExit(e);
+}
+
+void PianoRoll::modifierKeysChanged(const ModifierKeys &modifiers)
+{
+    this->updateQuickSelectClip(this->getMouseXYRelative().toFloat(), modifiers);
+    HybridRoll::modifierKeysChanged(modifiers);
+}
+
 void PianoRoll::mouseUp(const MouseEvent &e)
 {
     if (const bool hasMultitouch = (e.source.getIndex() > 0))
@@ -865,7 +964,7 @@ void PianoRoll::mouseUp(const MouseEvent &e)
     // Dismiss newNoteDragging, if needed
     if (this->newNoteDragging != nullptr)
     {
-
+        NoteComponent::commitPreviews(this->getLassoSelection());
         this->newNoteDragging->endInitializing();
         this->setMouseCursor(this->project.getEditMode().getCursor());
         this->newNoteDragging = nullptr;
@@ -891,6 +990,17 @@ void PianoRoll::handleCommandMessage(int commandId)
 {
     switch (commandId)
     {
+    case CommandIDs::Undo:
+    case CommandIDs::Redo:
+        // drop whatever is being dragged right now, the undo itself is done in HybridRoll
+        NoteComponent::cancelPreviews(this->getLassoSelection());
+        if (this->newNoteDragging != nullptr)
+        {
+            this->newNoteDragging->endInitializing();
+            this->setMouseCursor(this->project.getEditMode().getCursor());
+            this->newNoteDragging = nullptr;
+        }
+        break;
     case CommandIDs::SelectAllEvents:
         this->selectAll();
         break;
@@ -1051,9 +1161,14 @@ void PianoRoll::resized()
 
 void PianoRoll::paint(Graphics &g)
 {
+    PROFILE_SCOPE("PianoRoll::paint");
+
     const auto sequences = this->project.getTimeline()->getKeySignatures()->getSequence();
-    const int paintStartX = this->viewport.getViewPositionX();
-    const int paintEndX = paintStartX + this->viewport.getViewWidth();
+
+    // only fill what is actually dirty, e.g. a thin strip after the playhead moves
+    const auto paintArea = g.getClipBounds().getIntersection(this->viewport.getViewArea());
+    const int paintStartX = paintArea.getX();
+    const int paintEndX = paintArea.getRight();
 
     // Seems that OpenGL renders non-power-of-2 textures incorrectly?
     // This is just a quick hack, please FIXME:
@@ -1062,8 +1177,8 @@ void PianoRoll::paint(Graphics &g)
 
     int prevBarX = paintStartX;
     const HighlightingScheme *prevScheme = nullptr;
-    const int y = this->viewport.getViewPositionY();
-    const int h = this->viewport.getViewHeight();
+    const int y = paintArea.getY();
+    const int h = paintArea.getHeight();
 
     for (int nextKeyIdx = 0; nextKeyIdx < sequences->size(); ++nextKeyIdx)
     {
@@ -1087,6 +1202,7 @@ void PianoRoll::paint(Graphics &g)
         {
             g.fillRect(prevBarX, y, barX - prevBarX, h);
             HybridRoll::paint(g);
+            this->paintGhostLayers(g);
             return;
         }
         else if (barX >= paintStartX)
@@ -1106,6 +1222,233 @@ void PianoRoll::paint(Graphics &g)
         g.fillRect(prevBarX, y, paintEndX - prevBarX, h);
         HybridRoll::paint(g);
     }
+
+    this->paintGhostLayers(g);
+}
+
+//===----------------------------------------------------------------------===//
+// Ghost layers
+//===----------------------------------------------------------------------===//
+
+void PianoRoll::invalidateGhostLayer(const Note &note)
+{
+    this->ghostLayers.erase(note.getSequence());
+
+    // the layer is shared by all clips of the track, so the note
+    // is repainted in each of them, but nowhere else
+    const auto *pattern = note.getSequence()->getTrack()->getPattern();
+    if (pattern == nullptr)
+    {
+        return;
+    }
+
+    for (int i = 0; i < pattern->size(); ++i)
+    {
+        const Clip *clip = pattern->getUnchecked(i);
+        this->repaint(this->getEventBounds(note.getKey() + clip->getKey(),
+            note.getBeat() + clip->getBeat(), note.getLength()).getSmallestIntegerContainer());
+    }
+}
+
+void PianoRoll::repaintClipArea(const Clip &clip)
+{
+    const auto *sequence = clip.getPattern()->getTrack()->getSequence();
+    if (sequence->size() == 0)
+    {
+        return;
+    }
+
+    // the layer's bounds are in beats, and cover the notes' real ends,
+    // unlike the sequence's last beat, which only checks a few last events
+    const auto layerBounds = this->getGhostLayer(sequence).path.getBounds();
+    const int startX = this->getXPositionByBeat(layerBounds.getX() + clip.getBeat());
+    const int endX = this->getXPositionByBeat(layerBounds.getRight() + clip.getBeat());
+    const Rectangle<int> clipArea(startX, 0, endX - startX + 1, this->getHeight());
+    this->repaint(clipArea.getIntersection(this->viewport.getViewArea()));
+}
+
+const PianoRoll::GhostLayer &PianoRoll::getGhostLayer(const MidiSequence *sequence)
+{
+    const auto found = this->ghostLayers.find(sequence);
+    if (found != this->ghostLayers.end())
+    {
+        return *found->second;
+    }
+
+    // the path is in beats and rows, so that it can be transformed
+    // to any clip position and any zoom level without rebuilding
+    auto *layer = new GhostLayer();
+    for (int i = 0; i < sequence->size(); ++i)
+    {
+        const MidiEvent *event = sequence->getUnchecked(i);
+        if (event->isTypeOf(MidiEvent::Note))
+        {
+            const Note *note = static_cast<const Note *>(event);
+            layer->path.addRectangle(note->getBeat(), float(-note->getKey()) + GHOST_NOTE_MARGIN,
+                note->getLength(), GHOST_NOTE_HEIGHT);
+            layer->maxNoteLength = jmax(layer->maxNoteLength, note->getLength());
+        }
+    }
+
+    this->ghostLayers[sequence] = UniquePointer<GhostLayer>(layer);
+    return *layer;
+}
+
+AffineTransform PianoRoll::getGhostLayerTransform(const Clip &clip) const
+{
+    const float beatWidth = this->barWidth / float(BEATS_PER_BAR);
+    const float rowHeight = float(this->rowHeight);
+    return AffineTransform::scale(beatWidth, rowHeight)
+        .translated(beatWidth * (clip.getBeat() - this->getFirstBeat()),
+            float(this->getYPositionByKey(clip.getKey())));
+}
+
+bool PianoRoll::clipIntersectsRange(const Clip &clip, const Range<float> &range)
+{
+    const auto *sequence = clip.getPattern()->getTrack()->getSequence();
+    if (sequence->size() == 0)
+    {
+        return range.contains(clip.getBeat());
+    }
+
+    const auto layerBounds = this->getGhostLayer(sequence).path.getBounds();
+    const float startBeat = clip.getBeat() + layerBounds.getX();
+    const float endBeat = clip.getBeat() + layerBounds.getRight();
+    return startBeat <= range.getEnd() && endBeat >= range.getStart();
+}
+
+void PianoRoll::paintGhostLayers(Graphics &g)
+{
+    // skip the clips outside of the dirty region
+    const auto paintArea = g.getClipBounds();
+    const float beatWidth = this->barWidth / float(BEATS_PER_BAR);
+    const Range<float> visibleRange(this->getFirstBeat() + paintArea.getX() / beatWidth,
+        this->getFirstBeat() + paintArea.getRight() / beatWidth);
+
+    for (const auto *track : this->project.getTracks())
+    {
+        const auto *sequence = dynamic_cast<const PianoSequence *>(track->getSequence());
+        const auto *pattern = track->getPattern();
+        if (sequence == nullptr || pattern == nullptr || sequence->size() == 0)
+        {
+            continue;
+        }
+
+        const Colour ghostColour(track->getTrackColour()
+            .interpolatedWith(Colours::white, 0.35f)
+            .brighter(0.55f).withAlpha(0.25f));
+
+        for (int i = 0; i < pattern->size(); ++i)
+        {
+            const Clip *clip = pattern->getUnchecked(i);
+            if (!(*clip == this->activeClip) && this->clipIntersectsRange(*clip, visibleRange))
+            {
+                g.setColour((*clip == this->quickSelectClip) ?
+                    ghostColour.withAlpha(0.6f) : ghostColour);
+                g.fillPath(this->getGhostLayer(sequence).path, this->getGhostLayerTransform(*clip));
+            }
+        }
+    }
+}
+
+const Clip *PianoRoll::findGhostClipAt(const Point<float> &position, MidiTrack *&outTrack)
+{
+    const float beatWidth = this->barWidth / float(BEATS_PER_BAR);
+    const float beat = this->getFirstBeat() + position.getX() / beatWidth;
+    const int key = int((this->getHeight() - position.getY()) / this->rowHeight);
+
+    for (auto *track : this->project.getTracks())
+    {
+        const auto *sequence = track->getSequence();
+        const auto *pattern = track->getPattern();
+        if (pattern == nullptr || sequence->size() == 0)
+        {
+            continue;
+        }
+
+        // the layers of non-piano sequences are empty, and never contain the point
+        const auto &layer = this->getGhostLayer(sequence);
+        const auto layerBounds = layer.path.getBounds();
+
+        for (int i = 0; i < pattern->size(); ++i)
+        {
+            const Clip *clip = pattern->getUnchecked(i);
+            const float localBeat = beat - clip->getBeat();
+            const int localKey = key - clip->getKey();
+
+            // the layer's rows are negated keys, and the row's middle is what hits a note
+            if (*clip == this->activeClip ||
+                !layerBounds.contains(localBeat, float(-localKey) + 0.5f))
+            {
+                continue;
+            }
+
+            // the notes are sorted by beat, so only the ones starting before
+            // the point, and no longer ago than the longest note, may cover it
+            const auto *firstAfter = std::upper_bound(sequence->begin(), sequence->end(), localBeat,
+                [](float b, const MidiEvent *e) { return b < e->getBeat(); });
+
+            for (auto *it = firstAfter; it != sequence->begin();)
+            {
+                const MidiEvent *event = *(--it);
+                if (event->getBeat() + layer.maxNoteLength <= localBeat)
+                {
+                    break;
+                }
+
+                if (event->isTypeOf(MidiEvent::Note))
+                {
+                    const Note *note = static_cast<const Note *>(event);
+                    if (note->getKey() == localKey &&
+                        localBeat < note->getBeat() + note->getLength())
+                    {
+                        outTrack = track;
+                        return clip;
+                    }
+                }
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void PianoRoll::updateQuickSelectClip(const Point<float> &position, const ModifierKeys &modifiers)
+{
+    if (!modifiers.isAltDown() && !modifiers.isRightButtonDown())
+    {
+        this->setQuickSelectClip({});
+        return;
+    }
+
+    MidiTrack *track = nullptr;
+    const auto *clip = this->findGhostClipAt(position, track);
+    this->setQuickSelectClip((clip != nullptr) ? *clip : Clip());
+}
+
+void PianoRoll::setQuickSelectClip(const Clip &clip)
+{
+    if (this->quickSelectClip == clip)
+    {
+        return;
+    }
+
+    if (this->quickSelectClip.isValid())
+    {
+        this->repaintClipArea(this->quickSelectClip);
+    }
+
+    this->quickSelectClip = clip;
+
+    if (clip.isValid())
+    {
+        this->repaintClipArea(clip);
+        this->setMouseCursor(MouseCursor::CrosshairCursor);
+    }
+    else
+    {
+        this->setMouseCursor(this->project.getEditMode().getCursor());
+    }
 }
 
 void PianoRoll::insertNewNoteAt(const MouseEvent &e)
@@ -1202,7 +1545,7 @@ void PianoRoll::endCuttingEventsIfNeeded()
 // HybridRoll's legacy
 //===----------------------------------------------------------------------===//
 
-void PianoRoll::handleAsyncUpdate()
+bool PianoRoll::onFrame(double frameIntervalMs)
 {
 #if PIANOROLL_HAS_NOTE_RESIZERS
     // resizers for the mobile version
@@ -1244,7 +1587,7 @@ void PianoRoll::handleAsyncUpdate()
     }
 #endif
 
-    HybridRoll::handleAsyncUpdate();
+    return HybridRoll::onFrame(frameIntervalMs);
 }
 
 void PianoRoll::changeListenerCallback(ChangeBroadcaster *source)
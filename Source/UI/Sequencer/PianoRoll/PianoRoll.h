@@ -147,6 +147,9 @@ public:
     void mouseDoubleClick(const MouseEvent &e) override;
     void mouseUp(const MouseEvent &e) override;
     void mouseDrag(const MouseEvent &e) override;
+    void mouseMove(const MouseEvent &e) override;
+    void mouseExit(const MouseEvent &e) override;
+    void modifierKeysChanged(const ModifierKeys &modifiers) override;
     void handleCommandMessage(int commandId) override;
     void resized() override;
     void paint(Graphics &g) override;
@@ -155,7 +158,7 @@ public:
     // HybridRoll's legacy
     //===------------------------------------------------------------------===//
     
-    void handleAsyncUpdate() override;
+    bool onFrame(double frameIntervalMs) override;
     void changeListenerCallback(ChangeBroadcaster *source) override;
 
     //===------------------------------------------------------------------===//
@@ -185,6 +188,35 @@ private:
     void reloadRollContent();
     void loadTrack(const MidiTrack *const track);
 
+    // Note components are only created for the active clip,
+    // all other clips are drawn from the cached ghost layers
+    void loadClip(const Clip &clip);
+    void updateActiveClipComponents();
+    Range<float> getVisibleBeatRange(float marginInScreens) const;
+
+    void invalidateGhostLayer(const Note &note);
+    void repaintClipArea(const Clip &clip);
+
+    // The notes of a sequence, in beats and rows; the longest note
+    // bounds the search for the notes under the mouse cursor
+    struct GhostLayer final
+    {
+        Path path;
+        float maxNoteLength = 0.f;
+    };
+
+    const GhostLayer &getGhostLayer(const MidiSequence *sequence);
+    AffineTransform getGhostLayerTransform(const Clip &clip) const;
+    bool clipIntersectsRange(const Clip &clip, const Range<float> &range);
+    void paintGhostLayers(Graphics &g);
+    const Clip *findGhostClipAt(const Point<float> &position, MidiTrack *&outTrack);
+
+    // The inactive clip under the mouse while alt is pressed,
+    // highlighted as the one to be activated on click
+    Clip quickSelectClip;
+    void updateQuickSelectClip(const Point<float> &position, const ModifierKeys &modifiers);
+    void setQuickSelectClip(const Clip &clip);
+
     void updateChildrenBounds() override;
     void updateChildrenPositions() override;
     void setChildrenInteraction(bool interceptsMouse, MouseCursor c) override;
@@ -265,5 +297,7 @@ private:
     using PatternMap = SparseHashMap<const Clip, UniquePointer<SequenceMap>, ClipHash>;
     PatternMap patternMap;
 
+    SparseHashMap<const MidiSequence *, UniquePointer<GhostLayer>> ghostLayers;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PianoRoll)
 };